@@ -11,15 +11,34 @@
  *
  * Features:
  *   - OQPSK and BPSK demodulation
- *   - 16-bit and 32-bit IQ input support
+ *   - 16-bit/32-bit IQ, cf32 (zero-copy) and cs8 input support
+ *   - SigMF metadata (format, sample rate, symbol rate)
  *   - Configurable RRC matched filtering
- *   - Optional low-pass pre-filtering
- *   - Costas loop carrier recovery
+ *   - Optional low-pass pre-filtering (polyphase when decimating)
+ *   - Costas loop carrier recovery (table-driven fixed-point NCO)
  *   - Mueller & Müller timing recovery
+ *   - Symbol-rate carrier recovery after Gardner timing (optional)
+ *   - Gardner timing with Farrow cubic interpolation (down to 2 sps)
+ *   - FFT carrier acquisition from the squared / 4th-power signal
  *   - Auto-tuning of loop parameters (optional)
  *   - Blind processing: Viterbi decoding, NRZ-M, PSR descrambling
- *   - CCSDS frame sync and Reed-Solomon decoding
+ *   - CCSDS frame sync (also on a complemented stream) and RS decoding
  *   - UDP bit streaming (optional)
+ *   - Bounded-memory block streaming mode
+ *   - Read-ahead I/O thread (pread ring buffers)
+ *   - Sample / time range selection with direct seek
+ *   - Live input from stdin, named pipes or UDP (lock-free SPSC ring)
+ *   - Multi-file capture sequences as one continuous stream (prefetched)
+ *   - SSE2/AVX2 IQ conversion with runtime CPU dispatch
+ *   - SSE2/AVX2/AVX-512 FIR filtering (bit-identical to scalar)
+ *   - Folded kernels for symmetric (linear-phase) filters
+ *   - Fused, cache-blocked, multi-threaded whole-file front-end
+ *   - Farrow resampler to a chosen samples-per-symbol (e.g. 2 or 4)
+ *   - CIC + compensation FIR chain for large decimation factors
+ *   - Q15 fixed-point IQ16 front-end (16-bit multiply-accumulate SIMD)
+ *   - FFT overlap-save convolution for long filters (auto-selected)
+ *   - One-pass DC removal (IIR blocker / windowed running mean)
+ *   - Block AGC from smoothed mean power (attack / decay)
  *
  * Compatibility:
  *   - MSVC compatible (no C99 complex.h dependency)
@@ -27,13 +46,36 @@
  *
  * Usage:
  *   demod [options]
- *   -i FILE         Input IQ file
+ *   -i FILE         Input IQ file ("-" = stdin, udp:[host:]port = UDP)
+ *                   or sequence (glob / a,b,c; an existing file wins)
  *   -d NUM          Decimation factor
  *   --sps NUM       Samples per symbol
+ *   --resample-sps NUM  Resample to NUM samples per symbol
  *   --bpsk          BPSK demodulation mode
  *   --oqpsk         OQPSK demodulation mode (default)
  *   --iq16          16-bit IQ input format (default)
  *   --iq32          32-bit IQ input format
+ *   --cf32          Complex float32 input format
+ *   --cs8           Complex int8 input format
+ *   --dc MODE       DC removal: global, iir, window, none
+ *   --carrier MODE  Costas loop rate: sample, symbol
+ *   --acq NUM       Carrier acquisition FFT length (0 = off)
+ *   --reacq NUM     Re-acquisition check interval in samples (0 = off)
+ *   --timing MODE   Timing recovery: mm, gardner
+ *   --timing-bw NUM Gardner loop bandwidth (BnT)
+ *   --agc-level NUM     AGC target mean power
+ *   --agc-attack NUM    AGC smoothing when power rises
+ *   --agc-decay NUM     AGC smoothing when power falls
+ *   --io MODE       Input I/O: readahead, mmap
+ *   --start-sample NUM  First sample to process
+ *   --num-samples NUM   Number of samples to process
+ *   --start-time SEC    Start offset in seconds
+ *   --duration SEC      Length to process in seconds
+ *   --stream        Bounded-memory block streaming
+ *   --conv MODE     FIR convolution: auto, direct, fft
+ *   --q15           Fixed-point (Q15) front-end for IQ16 input
+ *   --q15-check     --q15, reporting its error against float
+ *   --threads NUM   Front-end filtering threads (0 = all cores)
  *   --help          Show help message
  *
  * =============================================================================
@@ -75,6 +117,11 @@
  */
 #include "_rs_decode.c"
 #include "init_rs.c"
+#include "dsp_fft.h"
+#include "dsp_pool.h"
+#include "dsp_simd.h"
+#include "iq_source.h"
+#include "sigmf.h"
 
 /* =============================================================================
  * MATHEMATICAL CONSTANTS
@@ -108,12 +155,64 @@
  * Select the input file format for IQ samples.
  *   FMT_IQ16  - 16-bit signed integers (int16_t I, int16_t Q pairs)
  *   FMT_IQ32  - 32-bit signed integers (int32_t I, int32_t Q pairs)
+ *   FMT_CF32  - 32-bit floats (float I, float Q pairs, 1.0 = full scale)
+ *   FMT_CS8   - 8-bit signed integers (int8_t I, int8_t Q pairs)
+ * A SigMF recording (.sigmf-meta / .sigmf-data) selects the format from
+ * its core:datatype field.
  * =============================================================================
  */
 #define FMT_IQ16 0
 #define FMT_IQ32 1
+#define FMT_CF32 2
+#define FMT_CS8 3
 #define INPUT_FORMAT FMT_IQ16 /* Active input format */
 
+/* =============================================================================
+ * DC REMOVAL MODE SELECTION
+ * -----------------------------------------------------------------------------
+ * Select how the ADC DC offset is estimated.
+ *   DC_GLOBAL  - Mean of the whole capture (extra read pass; running mean
+ *                of everything seen so far in streaming mode)
+ *   DC_IIR     - Single-pole IIR DC blocker (one pass)
+ *   DC_WINDOW  - Running mean over the last N samples (one pass)
+ *   DC_NONE    - No DC removal (capture is already DC-free)
+ * =============================================================================
+ */
+#define DC_GLOBAL 0
+#define DC_IIR 1
+#define DC_WINDOW 2
+#define DC_NONE 3
+
+/* =============================================================================
+ * CARRIER RECOVERY RATE SELECTION
+ * -----------------------------------------------------------------------------
+ * Select where the Costas loop runs relative to timing recovery.
+ *   CARRIER_SAMPLE  - Costas loop on every sample, then M&M timing on the
+ *                     carrier-corrected signal
+ *   CARRIER_SYMBOL  - Gardner timing (carrier-insensitive) on the matched
+ *                     filter output, then the Costas loop on the symbols
+ * =============================================================================
+ */
+#define CARRIER_SAMPLE 0
+#define CARRIER_SYMBOL 1
+
+/* =============================================================================
+ * TIMING RECOVERY SELECTION
+ * -----------------------------------------------------------------------------
+ * Select the timing recovery engine.
+ *   TIMING_MM       - Mueller & Müller detector, linear interpolation,
+ *                     gains from --timing-alpha / --timing-beta (with
+ *                     CARRIER_SYMBOL: Gardner detector, same interpolation
+ *                     and gains)
+ *   TIMING_GARDNER  - Gardner detector (I and Q transitions for OQPSK),
+ *                     Farrow cubic interpolation and a PI loop filter
+ *                     designed from a loop bandwidth; accurate down to
+ *                     2 samples per symbol
+ * =============================================================================
+ */
+#define TIMING_MM 0
+#define TIMING_GARDNER 1
+
 /* =============================================================================
  * PROCESSING CHAIN TOGGLES
  * -----------------------------------------------------------------------------
@@ -137,6 +236,119 @@
 #define LOWPASS_CUTOFF_NORM 7.5f /* Normalized cutoff frequency        */
 #define LOWPASS_NTAPS 101        /* Number of FIR filter taps          */
 
+/* =============================================================================
+ * MULTISTAGE DECIMATION
+ * -----------------------------------------------------------------------------
+ * Large decimation factors run as CIC stages plus a short compensation FIR
+ * =============================================================================
+ */
+#define DECIM_CHAIN_MIN 16   /* Smallest decimation using the CIC chain */
+#define DECIM_MAX_STAGES 8   /* Maximum filter stages in the chain      */
+#define DECIM_PASS_FRAC 0.4  /* Passband edge (fraction of output Fs)   */
+#define CIC_ORDER 4          /* CIC order (sinc^N response)             */
+#define CIC_COMP_NTAPS 63    /* Compensation FIR taps                   */
+#define CIC_COMP_GRID 2048   /* Frequency grid of the compensation FIR  */
+
+/* =============================================================================
+ * INPUT INGEST CONFIGURATION
+ * -----------------------------------------------------------------------------
+ * Samples are converted block by block straight from the mapped capture
+ * =============================================================================
+ */
+#define INGEST_BLOCK_SAMPLES 65536 /* Samples converted per block   */
+
+/* =============================================================================
+ * FRONT-END TILING
+ * -----------------------------------------------------------------------------
+ * The whole-file front-end runs in fixed tiles of output samples, small
+ * enough that a tile and its intermediate stage buffers stay in L2. Each
+ * tile reads its inputs plus the filter halos, so tiles are independent and
+ * the result does not depend on the thread count
+ * =============================================================================
+ */
+#define FILTER_TILE_SAMPLES 16384 /* Output samples per work tile  */
+
+/* =============================================================================
+ * AUTOMATIC GAIN CONTROL
+ * -----------------------------------------------------------------------------
+ * The front-end output is leveled block by block from its mean power; the
+ * blocks are aligned to the output index, so whole-file and streaming runs
+ * apply the same gains (tiles hold a whole number of blocks)
+ * =============================================================================
+ */
+#define AGC_BLOCK_SAMPLES 1024 /* Samples per gain update          */
+#define AGC_CLIP_RMS 3.0f      /* I/Q limit, in target RMS units   */
+#define AGC_LOOP_LEVEL 0.3f    /* Loop input power the gains assume */
+
+/* =============================================================================
+ * LOOP ENGINE
+ * -----------------------------------------------------------------------------
+ * Carrier and timing loops run in one pass: each chunk is carrier-corrected
+ * into a sliding window that only holds what the timing interpolator still
+ * needs, and symbols come out as they are produced. Whole-file runs feed the
+ * signal through the same engine as streaming runs. The window keeps I and Q
+ * in separate aligned planes, so the samplers read one contiguous channel
+ * (BPSK reads only I) and nothing is deinterleaved per symbol; the
+ * front-end stages and the loop engine's input stay interleaved
+ * =============================================================================
+ */
+#define LOOP_CHUNK_SAMPLES 4096 /* Samples per loop engine call      */
+#define LOOP_PLANE_ALIGN 64     /* Window plane alignment (bytes)    */
+
+/* =============================================================================
+ * CARRIER NCO
+ * -----------------------------------------------------------------------------
+ * The Costas loop phase is a 32-bit fixed-point accumulator (2^32 = one
+ * turn) that wraps on overflow; cos/sin come from a table indexed by its top
+ * bits, linearly interpolated (worst-case error 4.7e-6 for 2^10 entries)
+ * =============================================================================
+ */
+#define NCO_LUT_BITS 10                        /* log2(table entries)  */
+#define NCO_LUT_SIZE (1 << NCO_LUT_BITS)       /* Entries per turn     */
+#define NCO_FRAC_BITS (32 - NCO_LUT_BITS)      /* Interpolation bits   */
+
+/* =============================================================================
+ * SYMBOL-RATE CARRIER RECOVERY
+ * -----------------------------------------------------------------------------
+ * With CARRIER_SYMBOL the loop gains are scaled by the samples per symbol
+ * (proportional) and its square (integral) so the loop keeps the bandwidth
+ * it has at the sample rate. The OQPSK Gardner detector is referenced to a
+ * smoothed squared signal, which carries twice the carrier phase
+ * =============================================================================
+ */
+#define GARDNER_REF_GAIN 0.02 /* Smoothing of the squared-signal reference */
+
+/* =============================================================================
+ * GARDNER LOOP FILTER
+ * -----------------------------------------------------------------------------
+ * With TIMING_GARDNER the detector output is divided by the smoothed symbol
+ * power and by its slope at zero timing error, computed from the raised
+ * cosine S-curve for the RRC roll-off, so it reads as a timing error in
+ * symbols. The proportional and integral gains then follow from the loop
+ * bandwidth (BnT, per symbol) and the damping factor
+ * =============================================================================
+ */
+#define TIMING_DAMPING 0.7071 /* Loop damping factor                    */
+#define GARDNER_PWR_GAIN 0.01 /* Smoothing of the symbol power          */
+
+/* =============================================================================
+ * CARRIER ACQUISITION
+ * -----------------------------------------------------------------------------
+ * The loops are held back until the carrier offset has been read off the
+ * spectrum of the signal raised to the modulation order (squared for BPSK,
+ * 4th power for OQPSK): that strips the data and leaves a line at M times
+ * the offset. The strongest bin is refined by parabolic interpolation and
+ * only trusted when it stands out of the mean bin power. The estimate
+ * seeds the Costas frequency, or with CARRIER_SYMBOL a fixed derotation
+ * ahead of the Gardner loop. Re-acquisition repeats the estimate over the
+ * latest samples and reseeds when the loop's mean frequency has drifted
+ * away from the line (lost or false lock)
+ * =============================================================================
+ */
+#define ACQ_MIN_LEN 256       /* Shortest acquisition FFT              */
+#define ACQ_MIN_LINE_DB 10.0  /* Line over mean bin power to accept    */
+#define ACQ_REACQ_BINS 3.0    /* Loop/line mismatch (bins) that reseeds */
+
 /* =============================================================================
  * UDP STREAMING CONFIGURATION
  * -----------------------------------------------------------------------------
@@ -179,15 +391,21 @@
 /* Decimation and sample rate */
 #define DEFAULT_DECIM 5    /* Decimation factor                  */
 #define DEFAULT_SPS 18.75f /* Samples per symbol (after decim)   */
+#define DEFAULT_TARGET_SPS 0.0f /* Resample to this SPS (0 = off)  */
 #define DEFAULT_RB 160e6f  /* Symbol rate (baud)                 */
 
 /* Costas loop parameters (carrier recovery) */
 #define DEFAULT_COSTAS_ALPHA 0.01f  /* Proportional gain                  */
 #define DEFAULT_COSTAS_BETA 0.0005f /* Integral gain                      */
+#define DEFAULT_CARRIER_MODE CARRIER_SAMPLE /* Loop rate (sample/symbol) */
+#define DEFAULT_ACQ_LEN 16384       /* Acquisition FFT length (0 = off)   */
+#define DEFAULT_REACQ_PERIOD 0      /* Re-acquisition interval (0 = off)  */
 
 /* Mueller & Müller timing loop parameters */
 #define DEFAULT_TIMING_ALPHA 0.1f  /* Proportional gain                  */
 #define DEFAULT_TIMING_BETA 0.005f /* Integral gain                      */
+#define DEFAULT_TIMING_MODE TIMING_MM /* Timing engine (M&M / Gardner)  */
+#define DEFAULT_TIMING_BW 0.005f   /* Gardner loop bandwidth (BnT)       */
 
 /* RRC matched filter settings */
 #define DEFAULT_RRC_ENABLE 1     /* Enable RRC filter (0/1)            */
@@ -204,6 +422,29 @@
 #define DEFAULT_EVM_SKIP_SYMS 5000   /* Symbols to skip at start           */
 #define DEFAULT_EVM_LAST_SYMS 600000 /* Max symbols for EVM calculation    */
 
+/* Processing mode */
+#define DEFAULT_STREAM_MODE 0        /* Block streaming (0/1)              */
+#define DEFAULT_BLOCK_SAMPLES 262144 /* Input samples per streaming block  */
+#define DEFAULT_SIMD_LEVEL 3         /* Max SIMD: 0=scalar .. 3=AVX-512    */
+#define DEFAULT_CONV_MODE DSP_CONV_AUTO /* FIR: direct or FFT by cost      */
+#define DEFAULT_THREADS 0           /* Front-end threads (0 = all cores)  */
+#define DEFAULT_Q15 0               /* Fixed-point IQ16 front-end (0/1)   */
+
+/* Input I/O */
+#define IO_MMAP 0                     /* Memory-mapped sliding windows     */
+#define IO_READAHEAD 1                /* pread() ring filled by a thread   */
+#define DEFAULT_IO_MODE IO_READAHEAD  /* Input I/O mode                    */
+
+/* Automatic gain control */
+#define DEFAULT_AGC_LEVEL AGC_LOOP_LEVEL /* Target mean power |v|^2    */
+#define DEFAULT_AGC_ATTACK 0.5f  /* Smoothing per block, power rising  */
+#define DEFAULT_AGC_DECAY 0.05f  /* Smoothing per block, power falling */
+
+/* DC removal */
+#define DEFAULT_DC_MODE DC_GLOBAL /* DC estimation mode                 */
+#define DEFAULT_DC_ALPHA 1e-4f    /* IIR DC tracking gain (per sample)  */
+#define DEFAULT_DC_WINDOW 65536   /* Running mean window (samples)      */
+
 /* *****************************************************************************
  *
  *                         TYPE DEFINITIONS
@@ -229,22 +470,36 @@ typedef struct {
  */
 typedef struct {
   /* Input settings */
-  char input_file[256]; /* Path to input IQ file                      */
-  int input_format;     /* FMT_IQ16 or FMT_IQ32                       */
-  int modulation;       /* MOD_OQPSK or MOD_BPSK                      */
+  char input_file[1024]; /* Input IQ file, pattern or list of files  */
+  int input_format;      /* FMT_IQ16, FMT_IQ32, FMT_CF32 or FMT_CS8  */
+  int modulation;        /* MOD_OQPSK or MOD_BPSK                    */
+
+  /* Sample range */
+  uint64_t start_sample; /* First sample to process                  */
+  uint64_t num_samples;  /* Samples to process (0 = to end of file)  */
+  double start_time;     /* Start offset in seconds (< 0 = unused)   */
+  double duration;       /* Length in seconds (< 0 = unused)         */
 
   /* Sample rate control */
   int decim; /* Decimation factor                          */
   float sps; /* Samples per symbol                         */
+  float target_sps; /* Loop SPS after resampling (0 = off)  */
   float rb;  /* Symbol rate (baud)                         */
+  float fs;  /* Input sample rate (Hz, 0 = unknown)        */
+  int sps_set; /* SPS given on the command line            */
 
   /* Costas loop (carrier recovery) */
   float costas_alpha; /* Proportional gain                          */
   float costas_beta;  /* Integral gain                              */
+  int carrier_mode;   /* CARRIER_SAMPLE or CARRIER_SYMBOL           */
+  int acq_len;        /* Acquisition FFT length (0 = off)           */
+  int reacq_period;   /* Re-acquisition interval (samples, 0 = off) */
 
   /* Timing recovery (Mueller & Müller) */
   float timing_alpha; /* Proportional gain                          */
   float timing_beta;  /* Integral gain                              */
+  int timing_mode;    /* TIMING_MM or TIMING_GARDNER                */
+  float timing_bw;    /* Gardner loop bandwidth (BnT)               */
 
   /* RRC matched filter */
   int rrc_enable;     /* Enable RRC filter                          */
@@ -257,9 +512,29 @@ typedef struct {
   float rload;  /* Load resistance                            */
   float alpha;  /* Scaling factor                             */
 
+  /* DC removal */
+  int dc_mode;    /* DC_GLOBAL, DC_IIR, DC_WINDOW or DC_NONE    */
+  float dc_alpha; /* IIR tracking gain                          */
+  int dc_window;  /* Running mean window (samples)              */
+
+  /* Automatic gain control */
+  float agc_level;  /* Target mean power                          */
+  float agc_attack; /* Smoothing when the power rises (0..1]      */
+  float agc_decay;  /* Smoothing when the power falls (0..1]      */
+
   /* EVM calculation */
   int evm_skip_syms; /* Symbols to skip at start                   */
   int evm_last_syms; /* Max symbols for calculation                */
+
+  /* Processing mode */
+  int stream_mode;   /* Bounded-memory block streaming            */
+  int block_samples; /* Input samples per streaming block         */
+  int simd_level;    /* Widest SIMD kernels allowed (0..3)        */
+  int conv_mode;     /* DSP_CONV_AUTO, _DIRECT or _FFT            */
+  int threads;       /* Front-end filtering threads (0 = all)     */
+  int q15;           /* Fixed-point (Q15) front-end for IQ16      */
+  int q15_check;     /* Measure the Q15 error against float       */
+  int io_mode;       /* IO_MMAP or IO_READAHEAD                   */
 } Config;
 
 /* =============================================================================
@@ -280,6 +555,226 @@ typedef struct {
   size_t capacity; /* Allocated capacity   */
 } FloatBuffer;
 
+/* =============================================================================
+ * LOOP STATE TYPES
+ * -----------------------------------------------------------------------------
+ * Carrier and timing loop state, carried across blocks so the loops can be
+ * run over a whole signal or over consecutive chunks of it
+ * =============================================================================
+ */
+typedef struct {
+  uint32_t phase;  /* NCO phase (2^32 = one turn)     */
+  double freq;     /* NCO frequency (rad/sample)      */
+  double freq_acc; /* Sum of freq (re-acquisition)    */
+  size_t freq_n;   /* Updates in freq_acc             */
+} CostasState;
+
+typedef struct {
+  size_t len;       /* FFT length (0 = acquisition off)          */
+  int order;        /* Power that strips the modulation (2 or 4) */
+  cplxf* hist;      /* Latest loop inputs (ring of len samples)  */
+  size_t head;      /* Next ring slot                            */
+  size_t fill;      /* Samples in the ring                       */
+  float* re;        /* FFT work arrays                           */
+  float* im;
+  int done;         /* Initial estimate made                     */
+  size_t period;    /* Re-acquisition interval (0 = off)         */
+  size_t since;     /* Samples since the last check              */
+  int found;        /* Initial estimate seeded the loop          */
+  double freq;      /* Initial estimate (rad/sample)             */
+  double line_db;   /* Initial line over mean bin power (dB)     */
+  unsigned reacqs;  /* Re-acquisitions made                      */
+} AcqState;
+
+typedef struct {
+  double idx;       /* Next sampling instant (absolute index)    */
+  double sps_est;   /* Current samples-per-symbol estimate       */
+  float sps_nom;    /* Nominal samples per symbol                */
+  cplxf prev_sym;   /* Previous symbol (BPSK uses .re)           */
+  cplxf prev_dec;   /* Previous decision (BPSK uses .re)         */
+  cplxf ref;        /* Squared-signal reference (OQPSK Gardner)  */
+  cplxf prev_q;     /* Previous Q-instant sample (OQPSK Gardner) */
+  double pwr;       /* Smoothed symbol power (TIMING_GARDNER)    */
+  double ted_gain;  /* Detector slope per symbol of timing error */
+  double kp;        /* Proportional gain (TIMING_GARDNER)        */
+  double ki;        /* Integral gain (TIMING_GARDNER)            */
+  int first;        /* No symbol produced yet                    */
+  int stopped;      /* Loop bailed out (diverged / iter limit)   */
+  size_t iters;     /* Iterations so far                         */
+  size_t max_iters; /* Iteration limit (0 = unlimited)           */
+} TimingState;
+
+/* =============================================================================
+ * DC REMOVAL STATE
+ * -----------------------------------------------------------------------------
+ * Carried across blocks so DC removal runs on a chunked stream
+ * =============================================================================
+ */
+typedef struct {
+  int mode;          /* DC_GLOBAL, DC_IIR, DC_WINDOW or DC_NONE   */
+  int format;        /* Input sample format                       */
+  float scale;       /* Volts per count                           */
+
+  double sum_i;      /* DC_GLOBAL: compensated running sums       */
+  double sum_q;
+  double comp_i;     /* Kahan compensation terms                  */
+  double comp_q;
+  uint64_t count;    /* Samples in the sums                       */
+
+  double mu;         /* DC_IIR: tracking gain                     */
+  double est_i;      /* DC_IIR: current DC estimate (counts)      */
+  double est_q;
+  int primed;        /* DC_IIR: estimate seeded                   */
+
+  double* ring;      /* DC_WINDOW: last samples (interleaved I/Q) */
+  size_t win;        /* DC_WINDOW: window length                  */
+  size_t head;       /* DC_WINDOW: oldest sample slot             */
+  size_t fill;       /* DC_WINDOW: samples in the window          */
+  double wsum_i;     /* DC_WINDOW: compensated window sums        */
+  double wsum_q;
+  double wcomp_i;
+  double wcomp_q;
+} DcBlock;
+
+/* =============================================================================
+ * STREAMING PIPELINE TYPES
+ * -----------------------------------------------------------------------------
+ * Per-stage state for the bounded-memory block streaming mode
+ * =============================================================================
+ */
+typedef struct {
+  const float* taps; /* Filter coefficients                       */
+  int ntaps;         /* Number of taps                            */
+  cplxf* buf;        /* Carried history (+ staging for the FFT)   */
+  size_t hist;       /* Samples carried from the previous block   */
+  size_t capacity;   /* Allocated buffer length                   */
+  int decim;         /* Output decimation factor (1 = every one)  */
+  size_t skip;       /* Inputs to pass before the next kept output */
+  cplxf* poly;       /* Polyphase / FFT output scratch            */
+  size_t poly_cap;   /* Allocated scratch length                  */
+  struct DspFastFir* fast; /* Overlap-save engine (NULL = direct)  */
+} FirStream;
+
+typedef struct {
+  int nstages;                   /* Filter stages                  */
+  float* taps[DECIM_MAX_STAGES]; /* Coefficients of each stage     */
+  int ntaps[DECIM_MAX_STAGES];   /* Taps of each stage             */
+  int decim[DECIM_MAX_STAGES];   /* Decimation of each stage       */
+  int cic_order;                 /* CIC order (0 = single low-pass) */
+  float cutoff;                  /* Passband edge (input Fs)       */
+} DecimDesign;
+
+typedef struct {
+  const DecimDesign* design;         /* Stage coefficients          */
+  FirStream stage[DECIM_MAX_STAGES]; /* Per-stage filter state      */
+  cplxf* tmp[2];                     /* Ping-pong stage outputs     */
+  size_t tmp_cap;                    /* Allocated scratch length    */
+} DecimChain;
+
+typedef struct {
+  double ratio;      /* Input samples per output (0 = off)        */
+  cplxf* buf;        /* Carried inputs + current block            */
+  size_t len;        /* Samples in buf                            */
+  size_t capacity;   /* Allocated buffer length                   */
+  long long base;    /* Input index of buf[0]                     */
+  uint64_t next;     /* Index of the next output                  */
+  uint64_t n_in;     /* Inputs received so far                    */
+} ResampleStream;
+
+typedef struct {
+  float level;       /* Target mean power                         */
+  float attack;      /* Smoothing when the power rises            */
+  float decay;       /* Smoothing when the power falls            */
+  float clip;        /* Limit on |I| and |Q| after the gain       */
+  double power;      /* Smoothed block power (< 0 = no block yet) */
+  cplxf* pend;       /* Samples of the unfinished block (stream)  */
+  size_t npend;      /* Samples in pend                           */
+  size_t pend_cap;   /* Allocated pend length                     */
+} AgcState;
+
+typedef struct {
+  DcBlock dc;        /* DC removal stage                          */
+
+  DecimDesign lpd;   /* Low-pass / decimation filter design       */
+  DecimChain lp;     /* Low-pass stages (decimating)              */
+  int decim;         /* Decimation factor                         */
+  size_t decim_phase;/* Decimation period position (no low-pass)  */
+  float* rrc_taps;   /* RRC coefficients (NULL if disabled)       */
+  FirStream rrc;     /* RRC matched filter stage                  */
+  size_t trim_left;  /* RRC group delay samples still to drop     */
+  ResampleStream rs; /* Resampler to the loop SPS                 */
+  AgcState agc;      /* Output gain control                       */
+
+  long double pwr_raw_acc;  /* Sum of |v|^2 before filtering       */
+  long double pwr_post_acc; /* Sum of |v|^2 after filtering        */
+  uint64_t n_raw;           /* Samples in pwr_raw_acc              */
+  uint64_t n_post;          /* Samples in pwr_post_acc             */
+
+  cplxf* v;          /* Voltage samples of the current block      */
+  size_t v_cap;
+  cplxf* tmp_a;      /* Stage scratch buffer                      */
+  size_t tmp_cap;
+} FrontEndStream;
+
+typedef struct {
+  CostasState costas;      /* Carrier loop state                  */
+  TimingState timing;      /* Timing loop state                   */
+  AcqState acq;            /* Carrier acquisition                 */
+  uint32_t pre_phase;      /* Feedforward derotation ahead of the */
+  uint32_t pre_step;       /* Gardner loop (CARRIER_SYMBOL)       */
+  float* win_i;            /* Window I plane: carrier-corrected   */
+  float* win_q;            /* Window Q plane: samples (matched-   */
+                           /* filter samples with CARRIER_SYMBOL) */
+  SignalBuffer* raw;       /* Gardner samples (symbol instants)   */
+  int per_symbol;          /* CARRIER_SYMBOL: Costas after timing */
+  size_t win_len;          /* Samples in the window               */
+  size_t win_cap;          /* Allocated window length             */
+  size_t win_start;        /* Absolute index of win[0]            */
+  SignalBuffer* syms_qpsk; /* Symbols produced (OQPSK)            */
+  FloatBuffer* syms_bpsk;  /* Symbols produced (BPSK)             */
+  FloatBuffer* sps_log;    /* SPS per symbol (NULL to skip)       */
+} DemodStream;
+
+typedef struct {
+  int nrzm_prev;          /* Last NRZ-M input bit                 */
+  uint64_t bit_pos;       /* Output bits produced so far          */
+  unsigned char pend[8];  /* Bits waiting for a full byte         */
+  int npend;              /* Number of pending bits               */
+  unsigned char psr_seq[FRAME_SIZE_BYTES - 4]; /* First-slot PSR  */
+} BlindStream;
+
+typedef struct {
+  unsigned char* bits;       /* Bits not yet searched past         */
+  size_t len;                /* Buffered bits                      */
+  size_t capacity;           /* Allocated buffer length            */
+  size_t base;               /* Stream index of bits[0]            */
+  int last_error_counter_rs; /* RS error counter of the last frame */
+  int frame_count;           /* Sync words found                   */
+  int tm_ok_count;           /* Frames decoded                     */
+  int tm_bad_count;          /* Frames failed                      */
+} FrameSync;
+
+typedef struct {
+  FrontEndStream fe;     /* DC / filters / decimation / gain       */
+  DemodStream demod;     /* Costas + timing                        */
+  BlindStream blind;     /* NRZ-M / PSR                            */
+  FrameSync sync;        /* Frame sync & RS                        */
+
+  unsigned char* bits;   /* Demodulated bits of the current block  */
+  unsigned char* proc;   /* Blind-processed bits of the block      */
+  size_t bits_cap;
+  FILE* bits_file;       /* output_bits.txt                        */
+
+  cplxf* evm_ring;       /* Most recent symbols for EVM            */
+  size_t evm_cap;
+  size_t evm_head;
+  size_t evm_fill;
+
+  uint64_t total_syms;   /* Symbols demodulated                    */
+  uint64_t total_bits;   /* Bits demodulated                       */
+  uint64_t total_proc;   /* Bits out of the blind chain            */
+} StreamPipeline;
+
 /* *****************************************************************************
  *
  *                         EXTERNAL FUNCTION DECLARATIONS
@@ -330,9 +825,18 @@ void nrzm_decode(const unsigned char* input, unsigned char* output, int len,
 /* Configuration */
 static void config_init_defaults(Config* cfg);
 static void config_parse_args(Config* cfg, int argc, char** argv);
+static int config_apply_sigmf(Config* cfg);
 static void config_print(const Config* cfg);
 static void print_usage(const char* prog_name);
 
+/* Input formats */
+static size_t format_sample_bytes(int format);
+static const char* format_name(int format);
+static const char* format_describe(int format);
+static void iq_convert_block(const void* raw, size_t n, int format, float i_dc,
+                             float q_dc, float scale, cplxf* dst,
+                             double* pwr_acc);
+
 /* Buffer management */
 SignalBuffer* signal_buffer_create(size_t capacity);
 void signal_buffer_free(SignalBuffer* buf);
@@ -340,6 +844,8 @@ void signal_buffer_append(SignalBuffer* buf, cplxf val);
 FloatBuffer* float_buffer_create(size_t capacity);
 void float_buffer_free(FloatBuffer* buf);
 void float_buffer_append(FloatBuffer* buf, float val);
+static float* plane_alloc(size_t n);
+static void plane_free(float* p);
 
 /* Complex number operations */
 static inline cplxf cplxf_make(float re, float im);
@@ -360,7 +866,8 @@ static inline float cplxf_imag(cplxf a);
 float* rrc_taps(float fs_hz, float rs_hz, float alpha, int span_symbols,
                 int* ntaps_out);
 float* hamming_window_fir(float cutoff_norm, int ntaps);
-cplxf* convolve_fir(cplxf* sig, size_t sig_len, float* taps, int ntaps);
+cplxf* convolve_fir(const cplxf* sig, size_t sig_len, const float* taps,
+                    int ntaps);
 
 /* QPSK symbol processing */
 cplxf slicer_qpsk(cplxf z);
@@ -378,12 +885,21 @@ cplxf* load_and_process(Config* cfg, size_t* out_len, float* final_sps,
 
 /* Demodulation loops */
 void run_loops(cplxf* sig, size_t N, float current_sps, Config* cfg,
-               cplxf** costas_out, cplxf** syms_out, size_t* nsyms,
-               float** freq_log, float** sps_log, size_t* nlog, int quiet);
+               cplxf** syms_out, size_t* nsyms, float** sps_log, size_t* nlog,
+               int quiet);
 
 void run_loops_bpsk(cplxf* sig, size_t N, float current_sps, Config* cfg,
-                    cplxf** costas_out, float** syms_out, size_t* nsyms,
-                    float** freq_log, float** sps_log, size_t* nlog, int quiet);
+                    float** syms_out, size_t* nsyms, float** sps_log,
+                    size_t* nlog, int quiet);
+
+/* Loop engine (shared by whole-file and streaming runs) */
+static void demod_stream_init(DemodStream* ds, const Config* cfg,
+                              float current_sps, size_t max_iters);
+static void demod_stream_free(DemodStream* ds);
+static void demod_stream_process(DemodStream* ds, const cplxf* in, size_t n,
+                                 const Config* cfg);
+static void demod_stream_flush(DemodStream* ds, const Config* cfg);
+static void demod_stream_report_acq(const DemodStream* ds);
 
 /* Blind processing chain */
 int process_blind(const unsigned char* in, unsigned char* out, int in_len);
@@ -393,8 +909,10 @@ void bitsToBytes(const unsigned char* input, unsigned char* output,
                  size_t bitCount);
 
 /* Interpolation helpers */
-static inline cplxf interpolate_sample(cplxf* buffer, size_t N, double pos);
-static inline float interpolate_sample_f(float* buffer, size_t N, double pos);
+static inline float interpolate_sample_f(const float* buffer, size_t N,
+                                         double pos);
+static inline float interpolate_cubic_f(const float* buffer, size_t N,
+                                        double pos);
 
 /* *****************************************************************************
  *
@@ -413,18 +931,32 @@ static void config_init_defaults(Config* cfg) {
   cfg->input_format = INPUT_FORMAT;
   cfg->modulation = MODULATION;
 
+  /* Sample range */
+  cfg->start_sample = 0;
+  cfg->num_samples = 0;
+  cfg->start_time = -1.0;
+  cfg->duration = -1.0;
+
   /* Sample rate control */
   cfg->decim = DEFAULT_DECIM;
   cfg->sps = DEFAULT_SPS;
+  cfg->target_sps = DEFAULT_TARGET_SPS;
   cfg->rb = DEFAULT_RB;
+  cfg->fs = 0.0f;
+  cfg->sps_set = 0;
 
   /* Costas loop */
   cfg->costas_alpha = DEFAULT_COSTAS_ALPHA;
   cfg->costas_beta = DEFAULT_COSTAS_BETA;
+  cfg->carrier_mode = DEFAULT_CARRIER_MODE;
+  cfg->acq_len = DEFAULT_ACQ_LEN;
+  cfg->reacq_period = DEFAULT_REACQ_PERIOD;
 
   /* Timing recovery */
   cfg->timing_alpha = DEFAULT_TIMING_ALPHA;
   cfg->timing_beta = DEFAULT_TIMING_BETA;
+  cfg->timing_mode = DEFAULT_TIMING_MODE;
+  cfg->timing_bw = DEFAULT_TIMING_BW;
 
   /* RRC filter */
   cfg->rrc_enable = DEFAULT_RRC_ENABLE;
@@ -437,9 +969,27 @@ static void config_init_defaults(Config* cfg) {
   cfg->rload = DEFAULT_RLOAD;
   cfg->alpha = DEFAULT_ALPHA;
 
+  /* DC removal */
+  cfg->dc_mode = DEFAULT_DC_MODE;
+  cfg->dc_alpha = DEFAULT_DC_ALPHA;
+  cfg->dc_window = DEFAULT_DC_WINDOW;
+  cfg->agc_level = DEFAULT_AGC_LEVEL;
+  cfg->agc_attack = DEFAULT_AGC_ATTACK;
+  cfg->agc_decay = DEFAULT_AGC_DECAY;
+
   /* EVM settings */
   cfg->evm_skip_syms = DEFAULT_EVM_SKIP_SYMS;
   cfg->evm_last_syms = DEFAULT_EVM_LAST_SYMS;
+
+  /* Processing mode */
+  cfg->stream_mode = DEFAULT_STREAM_MODE;
+  cfg->block_samples = DEFAULT_BLOCK_SAMPLES;
+  cfg->simd_level = DEFAULT_SIMD_LEVEL;
+  cfg->conv_mode = DEFAULT_CONV_MODE;
+  cfg->threads = DEFAULT_THREADS;
+  cfg->q15 = DEFAULT_Q15;
+  cfg->q15_check = 0;
+  cfg->io_mode = DEFAULT_IO_MODE;
 }
 
 /**
@@ -457,14 +1007,44 @@ static void config_parse_args(Config* cfg, int argc, char** argv) {
       cfg->decim = atoi(argv[++i]);
     } else if (strcmp(argv[i], "--sps") == 0 && i + 1 < argc) {
       cfg->sps = (float)atof(argv[++i]);
+      cfg->sps_set = 1;
+    } else if (strcmp(argv[i], "--resample-sps") == 0 && i + 1 < argc) {
+      cfg->target_sps = (float)atof(argv[++i]);
+      if (cfg->target_sps < 0.0f) cfg->target_sps = 0.0f;
     } else if (strcmp(argv[i], "--costas-alpha") == 0 && i + 1 < argc) {
       cfg->costas_alpha = (float)atof(argv[++i]);
     } else if (strcmp(argv[i], "--costas-beta") == 0 && i + 1 < argc) {
       cfg->costas_beta = (float)atof(argv[++i]);
+    } else if (strcmp(argv[i], "--carrier") == 0 && i + 1 < argc) {
+      const char* mode = argv[++i];
+      cfg->carrier_mode =
+          strcmp(mode, "symbol") == 0 ? CARRIER_SYMBOL : CARRIER_SAMPLE;
+    } else if (strcmp(argv[i], "--acq") == 0 && i + 1 < argc) {
+      /* Rounded up to a power of two */
+      int len = atoi(argv[++i]);
+      cfg->acq_len = 0;
+      if (len > 0) {
+        cfg->acq_len = ACQ_MIN_LEN;
+        while (cfg->acq_len < len && cfg->acq_len < (1 << 24)) {
+          cfg->acq_len *= 2;
+        }
+      }
+    } else if (strcmp(argv[i], "--reacq") == 0 && i + 1 < argc) {
+      cfg->reacq_period = atoi(argv[++i]);
+      if (cfg->reacq_period < 0) cfg->reacq_period = 0;
     } else if (strcmp(argv[i], "--timing-alpha") == 0 && i + 1 < argc) {
       cfg->timing_alpha = (float)atof(argv[++i]);
     } else if (strcmp(argv[i], "--timing-beta") == 0 && i + 1 < argc) {
       cfg->timing_beta = (float)atof(argv[++i]);
+    } else if (strcmp(argv[i], "--timing") == 0 && i + 1 < argc) {
+      const char* mode = argv[++i];
+      cfg->timing_mode =
+          strcmp(mode, "gardner") == 0 ? TIMING_GARDNER : TIMING_MM;
+    } else if (strcmp(argv[i], "--timing-bw") == 0 && i + 1 < argc) {
+      cfg->timing_bw = (float)atof(argv[++i]);
+      if (cfg->timing_bw <= 0.0f || cfg->timing_bw > 0.25f) {
+        cfg->timing_bw = DEFAULT_TIMING_BW;
+      }
     } else if (strcmp(argv[i], "--rrc-alpha") == 0 && i + 1 < argc) {
       cfg->rrc_alpha = (float)atof(argv[++i]);
     } else if (strcmp(argv[i], "--rrc-span") == 0 && i + 1 < argc) {
@@ -481,6 +1061,86 @@ static void config_parse_args(Config* cfg, int argc, char** argv) {
       cfg->input_format = FMT_IQ16;
     } else if (strcmp(argv[i], "--iq32") == 0) {
       cfg->input_format = FMT_IQ32;
+    } else if (strcmp(argv[i], "--cf32") == 0) {
+      cfg->input_format = FMT_CF32;
+    } else if (strcmp(argv[i], "--cs8") == 0) {
+      cfg->input_format = FMT_CS8;
+    } else if (strcmp(argv[i], "--start-sample") == 0 && i + 1 < argc) {
+      cfg->start_sample = strtoull(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--num-samples") == 0 && i + 1 < argc) {
+      cfg->num_samples = strtoull(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--start-time") == 0 && i + 1 < argc) {
+      cfg->start_time = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+      cfg->duration = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--dc") == 0 && i + 1 < argc) {
+      const char* mode = argv[++i];
+      if (strcmp(mode, "iir") == 0) {
+        cfg->dc_mode = DC_IIR;
+      } else if (strcmp(mode, "window") == 0) {
+        cfg->dc_mode = DC_WINDOW;
+      } else if (strcmp(mode, "none") == 0) {
+        cfg->dc_mode = DC_NONE;
+      } else {
+        cfg->dc_mode = DC_GLOBAL;
+      }
+    } else if (strcmp(argv[i], "--dc-alpha") == 0 && i + 1 < argc) {
+      cfg->dc_alpha = (float)atof(argv[++i]);
+      if (cfg->dc_alpha <= 0.0f || cfg->dc_alpha > 1.0f) {
+        cfg->dc_alpha = DEFAULT_DC_ALPHA;
+      }
+    } else if (strcmp(argv[i], "--dc-window") == 0 && i + 1 < argc) {
+      cfg->dc_window = atoi(argv[++i]);
+      if (cfg->dc_window < 1) cfg->dc_window = 1;
+    } else if (strcmp(argv[i], "--agc-level") == 0 && i + 1 < argc) {
+      cfg->agc_level = (float)atof(argv[++i]);
+      if (cfg->agc_level <= 0.0f) cfg->agc_level = DEFAULT_AGC_LEVEL;
+    } else if (strcmp(argv[i], "--agc-attack") == 0 && i + 1 < argc) {
+      cfg->agc_attack = (float)atof(argv[++i]);
+      if (cfg->agc_attack <= 0.0f || cfg->agc_attack > 1.0f) {
+        cfg->agc_attack = DEFAULT_AGC_ATTACK;
+      }
+    } else if (strcmp(argv[i], "--agc-decay") == 0 && i + 1 < argc) {
+      cfg->agc_decay = (float)atof(argv[++i]);
+      if (cfg->agc_decay <= 0.0f || cfg->agc_decay > 1.0f) {
+        cfg->agc_decay = DEFAULT_AGC_DECAY;
+      }
+    } else if (strcmp(argv[i], "--stream") == 0) {
+      cfg->stream_mode = 1;
+    } else if (strcmp(argv[i], "--block") == 0 && i + 1 < argc) {
+      cfg->block_samples = atoi(argv[++i]);
+      if (cfg->block_samples < 1024) cfg->block_samples = 1024;
+    } else if (strcmp(argv[i], "--io") == 0 && i + 1 < argc) {
+      const char* io = argv[++i];
+      cfg->io_mode = strcmp(io, "mmap") == 0 ? IO_MMAP : IO_READAHEAD;
+    } else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+      const char* lvl = argv[++i];
+      if (strcmp(lvl, "scalar") == 0) {
+        cfg->simd_level = 0;
+      } else if (strcmp(lvl, "sse2") == 0) {
+        cfg->simd_level = 1;
+      } else if (strcmp(lvl, "avx2") == 0) {
+        cfg->simd_level = 2;
+      } else {
+        cfg->simd_level = 3;
+      }
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      cfg->threads = atoi(argv[++i]);
+      if (cfg->threads < 0) cfg->threads = 0;
+    } else if (strcmp(argv[i], "--q15") == 0) {
+      cfg->q15 = 1;
+    } else if (strcmp(argv[i], "--q15-check") == 0) {
+      cfg->q15 = 1;
+      cfg->q15_check = 1;
+    } else if (strcmp(argv[i], "--conv") == 0 && i + 1 < argc) {
+      const char* mode = argv[++i];
+      if (strcmp(mode, "direct") == 0) {
+        cfg->conv_mode = DSP_CONV_DIRECT;
+      } else if (strcmp(mode, "fft") == 0) {
+        cfg->conv_mode = DSP_CONV_FFT;
+      } else {
+        cfg->conv_mode = DSP_CONV_AUTO;
+      }
     } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
       print_usage(argv[0]);
       exit(0);
@@ -488,6 +1148,119 @@ static void config_parse_args(Config* cfg, int argc, char** argv) {
   }
 }
 
+/**
+ * Take input format and rates from SigMF metadata
+ *
+ * When the input names a SigMF recording, the data file becomes the input,
+ * core:datatype selects the sample format and core:sample_rate plus an
+ * optional "<ns>:symbol_rate" set the rates. An SPS given on the command
+ * line takes precedence over the metadata.
+ *
+ * @param cfg  Configuration to update
+ * @return 0 on success (or not SigMF), -1 on error
+ */
+static int config_apply_sigmf(Config* cfg) {
+  char meta_path[sizeof(cfg->input_file)];
+  char data_path[sizeof(cfg->input_file)];
+  if (!sigmf_resolve(cfg->input_file, meta_path, data_path,
+                     sizeof(meta_path))) {
+    return 0;
+  }
+
+  SigmfMeta meta;
+  if (sigmf_read_meta(meta_path, &meta) != 0) {
+    fprintf(stderr, "Error: Cannot read SigMF metadata: %s\n", meta_path);
+    return -1;
+  }
+
+  if (strcmp(meta.datatype, "ci16_le") == 0 ||
+      strcmp(meta.datatype, "ci16") == 0) {
+    cfg->input_format = FMT_IQ16;
+  } else if (strcmp(meta.datatype, "ci32_le") == 0 ||
+             strcmp(meta.datatype, "ci32") == 0) {
+    cfg->input_format = FMT_IQ32;
+  } else if (strcmp(meta.datatype, "cf32_le") == 0 ||
+             strcmp(meta.datatype, "cf32") == 0) {
+    cfg->input_format = FMT_CF32;
+  } else if (strcmp(meta.datatype, "ci8") == 0) {
+    cfg->input_format = FMT_CS8;
+  } else {
+    fprintf(stderr, "Error: Unsupported SigMF datatype: '%s'\n",
+            meta.datatype);
+    return -1;
+  }
+
+  strncpy(cfg->input_file, data_path, sizeof(cfg->input_file) - 1);
+  cfg->input_file[sizeof(cfg->input_file) - 1] = '\0';
+
+  if (meta.sample_rate > 0.0) cfg->fs = (float)meta.sample_rate;
+  if (meta.symbol_rate > 0.0) {
+    /* rb follows the RRC convention Rs = rb / 2 */
+    cfg->rb = (float)(2.0 * meta.symbol_rate);
+    if (meta.sample_rate > 0.0 && !cfg->sps_set) {
+      cfg->sps = (float)(meta.sample_rate / meta.symbol_rate);
+    }
+  }
+
+  printf("[SigMF] %s: %s, Fs=%.3e Hz, Rs=%.3e baud\n", meta_path,
+         meta.datatype, meta.sample_rate, meta.symbol_rate);
+  return 0;
+}
+
+/**
+ * Bytes per complex sample of an input format
+ * @param format  FMT_* input format
+ * @return Bytes per I/Q pair
+ */
+static size_t format_sample_bytes(int format) {
+  switch (format) {
+    case FMT_IQ32:
+      return 2 * sizeof(int32_t);
+    case FMT_CF32:
+      return 2 * sizeof(float);
+    case FMT_CS8:
+      return 2 * sizeof(int8_t);
+    default:
+      return 2 * sizeof(int16_t);
+  }
+}
+
+/**
+ * Short name of an input format
+ * @param format  FMT_* input format
+ * @return Format name
+ */
+static const char* format_name(int format) {
+  switch (format) {
+    case FMT_IQ32:
+      return "IQ32";
+    case FMT_CF32:
+      return "CF32";
+    case FMT_CS8:
+      return "CS8";
+    default:
+      return "IQ16";
+  }
+}
+
+/**
+ * Human-readable description of an input format
+ * @param format  FMT_* input format
+ * @return Format description
+ */
+static const char* format_describe(int format) {
+  switch (format) {
+    case FMT_IQ32:
+      return "IQ32 (32-bit)";
+    case FMT_CF32:
+      return "CF32 (32-bit float)";
+    case FMT_CS8:
+      return "CS8 (8-bit)";
+    default:
+      return "IQ16 (16-bit)";
+  }
+}
+
 /**
  * Print configuration summary
  * @param cfg  Configuration to print
@@ -498,23 +1271,60 @@ static void config_print(const Config* cfg) {
   printf("===========================================\n");
   printf("\n[Input Settings]\n");
   printf("  File:         %s\n", cfg->input_file);
-  printf("  Format:       %s\n",
-         cfg->input_format == FMT_IQ32 ? "IQ32 (32-bit)" : "IQ16 (16-bit)");
+  printf("  Format:       %s\n", format_describe(cfg->input_format));
   printf("  Modulation:   %s\n",
          cfg->modulation == MOD_BPSK ? "BPSK" : "OQPSK");
+  if (cfg->start_time >= 0.0 || cfg->duration >= 0.0) {
+    printf("  Start time:   %.6f s\n",
+           cfg->start_time > 0.0 ? cfg->start_time : 0.0);
+    if (cfg->duration >= 0.0) {
+      printf("  Duration:     %.6f s\n", cfg->duration);
+    }
+  } else if (cfg->start_sample > 0 || cfg->num_samples > 0) {
+    printf("  Start sample: %llu\n", (unsigned long long)cfg->start_sample);
+    if (cfg->num_samples > 0) {
+      printf("  Num samples:  %llu\n", (unsigned long long)cfg->num_samples);
+    }
+  }
 
   printf("\n[Sample Rate]\n");
   printf("  Decimation:   %d\n", cfg->decim);
   printf("  SPS:          %.4f\n", cfg->sps);
+  if (cfg->target_sps > 0.0f) {
+    printf("  Resample SPS: %.4f\n", cfg->target_sps);
+  }
   printf("  Symbol Rate:  %.3e baud\n", cfg->rb);
+  if (cfg->fs > 0.0f) {
+    printf("  Sample Rate:  %.3e Hz\n", cfg->fs);
+  }
 
   printf("\n[Costas Loop]\n");
   printf("  Alpha:        %.6f\n", cfg->costas_alpha);
   printf("  Beta:         %.6f\n", cfg->costas_beta);
+  printf("  Rate:         %s\n", cfg->carrier_mode == CARRIER_SYMBOL
+                                      ? "Symbol (after Gardner timing)"
+                                      : "Sample (before M&M timing)");
+  if (cfg->acq_len > 0) {
+    printf("  Acquisition:  %d-point FFT of the %s signal\n", cfg->acq_len,
+           cfg->modulation == MOD_BPSK ? "squared" : "4th-power");
+    if (cfg->reacq_period > 0) {
+      printf("  Re-acquire:   Every %d samples\n", cfg->reacq_period);
+    }
+  } else {
+    printf("  Acquisition:  Off\n");
+  }
 
   printf("\n[Timing Recovery]\n");
-  printf("  Alpha:        %.6f\n", cfg->timing_alpha);
-  printf("  Beta:         %.6f\n", cfg->timing_beta);
+  if (cfg->timing_mode == TIMING_GARDNER) {
+    printf("  Engine:       Gardner, Farrow cubic interpolation\n");
+    printf("  Bandwidth:    %.4f (BnT, damping %.3f)\n", cfg->timing_bw,
+           TIMING_DAMPING);
+  } else {
+    printf("  Engine:       %s, linear interpolation\n",
+           cfg->carrier_mode == CARRIER_SYMBOL ? "Gardner" : "M&M");
+    printf("  Alpha:        %.6f\n", cfg->timing_alpha);
+    printf("  Beta:         %.6f\n", cfg->timing_beta);
+  }
 
   printf("\n[RRC Filter]\n");
   printf("  Enabled:      %s\n", cfg->rrc_enable ? "Yes" : "No");
@@ -523,6 +1333,42 @@ static void config_print(const Config* cfg) {
     printf("  Span:         %d symbols\n", cfg->rrc_span);
   }
 
+  printf("\n[DC Removal]\n");
+  if (cfg->dc_mode == DC_IIR) {
+    printf("  Mode:         IIR blocker (alpha=%.2e)\n", cfg->dc_alpha);
+  } else if (cfg->dc_mode == DC_WINDOW) {
+    printf("  Mode:         Running mean (%d samples)\n", cfg->dc_window);
+  } else if (cfg->dc_mode == DC_NONE) {
+    printf("  Mode:         None\n");
+  } else {
+    printf("  Mode:         Global mean\n");
+  }
+
+  printf("\n[AGC]\n");
+  printf("  Level:        %.3f (mean power)\n", cfg->agc_level);
+  printf("  Attack:       %.3f / %d samples\n", cfg->agc_attack,
+         AGC_BLOCK_SAMPLES);
+  printf("  Decay:        %.3f / %d samples\n", cfg->agc_decay,
+         AGC_BLOCK_SAMPLES);
+
+  printf("\n[Processing Mode]\n");
+  if (cfg->stream_mode) {
+    printf("  Mode:         Streaming (%d samples/block)\n", cfg->block_samples);
+  } else {
+    printf("  Mode:         Whole file\n");
+  }
+  printf("  SIMD:         %s\n", dsp_simd_level());
+  printf("  Threads:      %d\n", cfg->threads);
+  printf("  Front-end:    %s\n",
+         cfg->q15_check ? "Q15 fixed point (IQ16), checked against float"
+         : cfg->q15     ? "Q15 fixed point (IQ16)"
+                        : "Float");
+  printf("  Convolution:  %s\n", cfg->conv_mode == DSP_CONV_DIRECT ? "Direct"
+                                 : cfg->conv_mode == DSP_CONV_FFT  ? "FFT"
+                                                                   : "Auto");
+  printf("  Input I/O:    %s\n",
+         cfg->io_mode == IO_MMAP ? "Memory-mapped" : "Read-ahead thread");
+
   printf("\n[Processing Toggles]\n");
   printf("  Low-pass:     %s\n", ENABLE_LOWPASS ? "ON" : "OFF");
   printf("  Convolution:  %s\n", ENABLE_CONVOLUTION ? "ON" : "OFF");
@@ -545,22 +1391,56 @@ static void print_usage(const char* prog_name) {
   printf("  -i FILE              Input IQ file path\n");
   printf("  --iq16               16-bit IQ format (default)\n");
   printf("  --iq32               32-bit IQ format\n");
+  printf("  --cf32               Complex float32 format\n");
+  printf("  --cs8                Complex int8 format\n");
+  printf("  -i REC.sigmf-meta    SigMF recording (format/rates from metadata)\n");
+  printf("  -i \"cap_*.c16\"      File sequence (glob or a,b,c) as one stream\n");
+  printf("                       (an existing file of that exact name wins)\n");
+  printf("  -i -                 Live input from stdin (streaming mode)\n");
+  printf("  -i udp:[HOST:]PORT   Live input from UDP datagrams (streaming mode)\n");
+  printf("  --start-sample NUM   First sample to process\n");
+  printf("  --num-samples NUM    Number of samples to process\n");
+  printf("  --start-time SEC     Start offset in seconds\n");
+  printf("  --duration SEC       Length to process in seconds\n");
   printf("\nModulation:\n");
   printf("  --oqpsk              OQPSK mode (default)\n");
   printf("  --bpsk               BPSK mode\n");
   printf("\nSample Rate:\n");
   printf("  -d NUM               Decimation factor\n");
   printf("  --sps NUM            Samples per symbol\n");
+  printf("  --resample-sps NUM   Resample to NUM samples/symbol (e.g. 2, 4)\n");
   printf("\nLoop Parameters:\n");
   printf("  --costas-alpha NUM   Costas loop proportional gain\n");
   printf("  --costas-beta NUM    Costas loop integral gain\n");
+  printf("  --carrier MODE       Costas loop rate: sample (default) or symbol\n");
+  printf("  --acq NUM            Carrier acquisition FFT length (0 = off)\n");
+  printf("  --reacq NUM          Re-acquisition check every NUM samples\n");
   printf("  --timing-alpha NUM   Timing loop proportional gain\n");
   printf("  --timing-beta NUM    Timing loop integral gain\n");
+  printf("  --timing MODE        Timing recovery: mm (default) or gardner\n");
+  printf("  --timing-bw NUM      Gardner loop bandwidth BnT (default 0.005)\n");
   printf("\nRRC Filter:\n");
   printf("  --rrc_enable         Enable RRC filter\n");
   printf("  --no-rrc             Disable RRC filter\n");
   printf("  --rrc-alpha NUM      RRC roll-off factor\n");
   printf("  --rrc-span NUM       RRC span in symbols\n");
+  printf("\nDC Removal:\n");
+  printf("  --dc MODE            global (default), iir, window or none\n");
+  printf("  --dc-alpha NUM       IIR DC tracking gain\n");
+  printf("  --dc-window NUM      Running mean window in samples\n");
+  printf("\nAGC:\n");
+  printf("  --agc-level NUM      Target mean power of the loop input\n");
+  printf("  --agc-attack NUM     Gain smoothing when power rises (0..1]\n");
+  printf("  --agc-decay NUM      Gain smoothing when power falls (0..1]\n");
+  printf("\nProcessing Mode:\n");
+  printf("  --stream             Bounded-memory block streaming\n");
+  printf("  --block NUM          Input samples per streaming block\n");
+  printf("  --simd LEVEL         Widest SIMD kernels: scalar, sse2, avx2, avx512\n");
+  printf("  --conv MODE          FIR convolution: auto (default), direct, fft\n");
+  printf("  --threads NUM        Front-end filtering threads (0 = all cores)\n");
+  printf("  --q15                Fixed-point (Q15) front-end for IQ16 input\n");
+  printf("  --q15-check          --q15, reporting its error against float\n");
+  printf("  --io MODE            Input I/O: readahead (default) or mmap\n");
   printf("\nOther:\n");
   printf("  -h, --help           Show this help message\n");
 }
@@ -625,19 +1505,6 @@ static inline cplxf cplxf_exp_i_d(double theta) {
 static inline float cplxf_real(cplxf a) { return a.re; }
 
 static inline float cplxf_imag(cplxf a) { return a.im; }
-static double mean_power_w_cplxf(const cplxf* x, size_t N, double rload_ohm) {
-  if (!x || N == 0 || rload_ohm <= 0.0) return 0.0;
-  long double acc = 0.0L;
-  for (size_t i = 0; i < N; i++) {
-    long double re = x[i].re;
-    long double im = x[i].im;
-    acc += (re * re + im * im);
-  }
-  long double mean_v2 = acc / (long double)N;  // mean(|V|^2)
-  long double p_w = mean_v2 / (long double)rload_ohm;
-  return (double)p_w;
-}
-
 static double watt_to_dbm(double w) {
   if (!(w > 0.0)) return -INFINITY;
   return 10.0 * log10(w / 1e-3);
@@ -728,6 +1595,34 @@ void float_buffer_append(FloatBuffer* buf, float val) {
   buf->data[buf->len++] = val;
 }
 
+/**
+ * Allocate a float plane aligned to LOOP_PLANE_ALIGN
+ * @param n  Number of floats
+ * @return Plane (free with plane_free()), NULL on error
+ */
+static float* plane_alloc(size_t n) {
+  size_t bytes = (n ? n : 1) * sizeof(float);
+#ifdef _WIN32
+  return (float*)_aligned_malloc(bytes, LOOP_PLANE_ALIGN);
+#else
+  void* p = NULL;
+  if (posix_memalign(&p, LOOP_PLANE_ALIGN, bytes) != 0) return NULL;
+  return (float*)p;
+#endif
+}
+
+/**
+ * Free a plane from plane_alloc()
+ * @param p  Plane (may be NULL)
+ */
+static void plane_free(float* p) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
 /* *****************************************************************************
  *
  *                         FILTER DESIGN
@@ -777,6 +1672,9 @@ float* rrc_taps(float fs_hz, float rs_hz, float alpha, int span_symbols,
     }
   }
 
+  /* Exact symmetry (rounding can break it) selects the folded FIR kernels */
+  for (int n = 0; n < ntaps / 2; n++) h[ntaps - 1 - n] = h[n];
+
   /* Normalize for unit energy */
   float energy = 0.0f;
   for (int n = 0; n < ntaps; n++) {
@@ -816,6 +1714,9 @@ float* hamming_window_fir(float cutoff_norm, int ntaps) {
     h[n] = 2.0f * cutoff_norm * sinc * w;
   }
 
+  /* Exact symmetry (rounding can break it) selects the folded FIR kernels */
+  for (int n = 0; n < ntaps / 2; n++) h[ntaps - 1 - n] = h[n];
+
   /* Normalize for unity DC gain */
   float sum = 0.0f;
   for (int n = 0; n < ntaps; n++) {
@@ -831,21 +1732,43 @@ float* hamming_window_fir(float cutoff_norm, int ntaps) {
 /**
  * Apply FIR filter to complex signal
  *
+ * Outputs whose kernel lies fully inside the signal go through the SIMD
+ * kernel; only the ntaps-1 edge outputs need the zero-padding checks.
+ *
  * @param sig      Input signal array
  * @param sig_len  Signal length
  * @param taps     Filter coefficients
  * @param ntaps    Number of taps
  * @return Filtered signal array (caller must free)
  */
-cplxf* convolve_fir(cplxf* sig, size_t sig_len, float* taps, int ntaps) {
+cplxf* convolve_fir(const cplxf* sig, size_t sig_len, const float* taps,
+                    int ntaps) {
   cplxf* out = (cplxf*)malloc(sig_len * sizeof(cplxf));
-  int delay = ntaps / 2;
+  size_t delay = (size_t)(ntaps / 2);
+
+  /* Interior: out[n] = sum taps[k] * sig[n - delay + k], no bounds checks */
+  size_t first = delay < sig_len ? delay : sig_len;
+  size_t interior = sig_len >= (size_t)ntaps ? sig_len - (size_t)ntaps + 1 : 0;
+  struct DspFastFir* fast =
+      interior && dsp_conv_use_fft(taps, ntaps, interior, 1)
+          ? dsp_fastfir_create(taps, ntaps)
+          : NULL;
+  if (fast) {
+    dsp_fastfir_cf32(fast, (const float*)sig, interior, (float*)(out + first));
+    dsp_fastfir_free(fast);
+  } else if (interior) {
+    dsp_fir_cf32((const float*)sig, interior, taps, ntaps,
+                 (float*)(out + first));
+  }
 
+  /* Edges: zero-padded */
   for (size_t n = 0; n < sig_len; n++) {
+    if (interior && n == first) n += interior;
+    if (n >= sig_len) break;
     cplxf acc = cplxf_make(0.0f, 0.0f);
     for (int k = 0; k < ntaps; k++) {
-      int idx = (int)n - delay + k;
-      if (idx >= 0 && idx < (int)sig_len) {
+      long long idx = (long long)n - (long long)delay + k;
+      if (idx >= 0 && idx < (long long)sig_len) {
         acc = cplxf_add(acc, cplxf_mul_scalar(sig[idx], taps[k]));
       }
     }
@@ -855,919 +1778,4426 @@ cplxf* convolve_fir(cplxf* sig, size_t sig_len, float* taps, int ntaps) {
   return out;
 }
 
+/**
+ * Describe how a filter will be applied, for the processing log
+ *
+ * @param taps   Filter coefficients
+ * @param ntaps  Number of taps
+ * @param decim  Decimation factor of the stage
+ * @return "FFT", "direct, symmetric" or "direct"
+ */
+static const char* fir_method_name(const float* taps, int ntaps, int decim) {
+  if (dsp_conv_use_fft(taps, ntaps, 0, decim)) return "FFT";
+  return dsp_fir_symmetric(taps, ntaps) ? "direct, symmetric" : "direct";
+}
+
+/**
+ * Sum of the taps that overlap the signal for one convolve_fir() output
+ *
+ * Equals the full tap sum away from the edges; convolve_fir() zero-pads,
+ * so near the ends only part of the kernel touches the signal. Used to
+ * remove a constant offset after filtering: filt(x - c) = filt(x) - c*gain.
+ *
+ * @param taps     Filter coefficients
+ * @param ntaps    Number of taps
+ * @param n        Output sample index
+ * @param sig_len  Signal length
+ * @return Overlapping tap sum
+ */
+static float fir_overlap_gain(const float* taps, int ntaps, size_t n,
+                              size_t sig_len) {
+  int delay = ntaps / 2;
+  float g = 0.0f;
+  for (int k = 0; k < ntaps; k++) {
+    long long idx = (long long)n - delay + k;
+    if (idx >= 0 && idx < (long long)sig_len) g += taps[k];
+  }
+  return g;
+}
+
 /* *****************************************************************************
  *
- *                         SYMBOL PROCESSING - QPSK
+ *                         STREAMING FIR STAGE
  *
  * *****************************************************************************/
 
 /**
- * QPSK hard decision slicer
- * Maps complex symbol to nearest constellation point (±1, ±1)
+ * Initialize a streaming FIR stage
  *
- * @param z  Input symbol
- * @return Sliced symbol
+ * The history starts with ntaps/2 zeros so that, once flushed, the output
+ * sequence is sample-for-sample the same as convolve_fir() on the whole
+ * signal (zero-phase, zero-padded edges). Long filters run through the FFT
+ * overlap-save engine when dsp_conv_use_fft() finds it cheaper.
+ *
+ * @param fs     Stage to initialize
+ * @param taps   Filter coefficients (owned by the caller)
+ * @param ntaps  Number of taps
  */
-cplxf slicer_qpsk(cplxf z) {
-  float re = z.re >= 0 ? 1.0f : -1.0f;
-  float im = z.im >= 0 ? 1.0f : -1.0f;
-  return cplxf_make(re, im);
+static void fir_stream_init(FirStream* fs, const float* taps, int ntaps) {
+  fs->taps = taps;
+  fs->ntaps = ntaps;
+  fs->hist = (size_t)(ntaps / 2);
+  fs->capacity = (size_t)ntaps;
+  fs->buf = (cplxf*)calloc(fs->capacity, sizeof(cplxf));
+  fs->decim = 1;
+  fs->skip = 0;
+  fs->poly = NULL;
+  fs->poly_cap = 0;
+  fs->fast = dsp_conv_use_fft(taps, ntaps, 0, 1)
+                 ? dsp_fastfir_create(taps, ntaps)
+                 : NULL;
 }
 
 /**
- * Convert QPSK symbol to bit string
+ * Initialize a streaming FIR stage that keeps every decim-th output
  *
- * @param sym  Input symbol
- * @param out  Output buffer (at least 3 chars)
+ * Produces the same samples as fir_stream_init() followed by keeping
+ * outputs 0, decim, 2*decim, ... but only the kept outputs are computed:
+ * each block is split into its decim polyphase branches so the vector
+ * kernel runs at the output rate.
+ *
+ * @param fs     Stage to initialize
+ * @param taps   Filter coefficients (owned by the caller)
+ * @param ntaps  Number of taps
+ * @param decim  Decimation factor (1 = no decimation)
  */
-void qpsk_bits(cplxf sym, char* out) {
-  out[0] = sym.re >= 0 ? '1' : '0';
-  out[1] = sym.im >= 0 ? '1' : '0';
-  out[2] = '\0';
+static void fir_stream_init_decim(FirStream* fs, const float* taps, int ntaps,
+                                  int decim) {
+  fir_stream_init(fs, taps, ntaps);
+  fs->decim = decim > 1 ? decim : 1;
+  if (fs->fast && !dsp_conv_use_fft(taps, ntaps, 0, fs->decim)) {
+    dsp_fastfir_free(fs->fast);
+    fs->fast = NULL;
+  }
 }
 
 /**
- * Calculate decision-directed EVM for QPSK symbols
- *
- * @param syms  Symbol array
- * @param n     Number of symbols
- * @return EVM as fraction (0.0 - 1.0)
+ * Release a streaming FIR stage
+ * @param fs  Stage to free
  */
-float evm_decision_directed_qpsk(cplxf* syms, size_t n) {
-  /* Estimate complex gain */
-  cplxf num = cplxf_make(0.0f, 0.0f);
-  float den = 0.0f;
+static void fir_stream_free(FirStream* fs) {
+  free(fs->buf);
+  free(fs->poly);
+  dsp_fastfir_free(fs->fast);
+  fs->buf = NULL;
+  fs->poly = NULL;
+  fs->fast = NULL;
+  fs->capacity = 0;
+  fs->poly_cap = 0;
+}
 
-  for (size_t i = 0; i < n; i++) {
-    cplxf ref = slicer_qpsk(syms[i]);
-    num = cplxf_add(num, cplxf_mul(cplxf_conj(ref), syms[i]));
-    den += cplxf_abs2(ref);
-  }
+/**
+ * Make sure the history buffer holds n samples (contents are kept)
+ */
+static void fir_stream_reserve(FirStream* fs, size_t n) {
+  if (n <= fs->capacity) return;
+  fs->capacity = n * 2;
+  fs->buf = (cplxf*)realloc(fs->buf, fs->capacity * sizeof(cplxf));
+}
 
-  cplxf a = cplxf_div_scalar(num, den + 1e-30f);
+/**
+ * Copy every decim-th input of the carried history followed by a block
+ *
+ * Reads inputs first, first + decim, ... of the stream buf[0, hist) + in
+ * where they lie, so the block itself is never staged.
+ *
+ * @param fs     Stage state
+ * @param in     New input block
+ * @param first  Stream index of the first input
+ * @param cnt    Number of inputs to copy
+ * @param dst    Output: cnt samples
+ */
+static void fir_stream_gather(const FirStream* fs, const cplxf* in,
+                              size_t first, size_t cnt, cplxf* dst) {
+  size_t D = (size_t)fs->decim;
+  size_t nb = first < fs->hist ? (fs->hist - first + D - 1) / D : 0;
+  if (nb > cnt) nb = cnt;
+  for (size_t q = 0; q < nb; q++) dst[q] = fs->buf[first + q * D];
+  if (nb == cnt) return;
+  const cplxf* src = in + (first + nb * D - fs->hist);
+  for (size_t q = nb; q < cnt; q++) dst[q] = src[(q - nb) * D];
+}
 
-  /* Calculate EVM */
-  float err_sum = 0.0f, ref_sum = 0.0f;
-
-  for (size_t i = 0; i < n; i++) {
-    cplxf ref = slicer_qpsk(syms[i]);
-    cplxf e = cplxf_sub(syms[i], cplxf_mul(a, ref));
-    cplxf a_ref = cplxf_mul(a, ref);
-    err_sum += cplxf_abs2(e);
-    ref_sum += cplxf_abs2(a_ref);
+/**
+ * Filter a block, carrying the inputs still needed to the next block
+ *
+ * The direct kernels read the block where it is: only the outputs whose
+ * taps reach back into the carried history run over a short stitched
+ * copy, and only the inputs later outputs still need are carried. The
+ * overlap-save engine takes one contiguous block, so it stages the block
+ * after the history.
+ *
+ * @param fs   Stage state
+ * @param in   Input samples
+ * @param n    Number of input samples
+ * @param out  Output samples (capacity n)
+ * @return Number of output samples produced
+ */
+static size_t fir_stream_process(FirStream* fs, const cplxf* in, size_t n,
+                                 cplxf* out) {
+  size_t total = fs->hist + n;
+  size_t D = (size_t)fs->decim;
+  size_t span = (size_t)(fs->ntaps - 1);
+  size_t nout =
+      total > fs->skip + span ? (total - fs->skip - span - 1) / D + 1 : 0;
+
+  if (nout && fs->fast) {
+    fir_stream_reserve(fs, total);
+    memcpy(fs->buf + fs->hist, in, n * sizeof(cplxf));
+    if (D == 1) {
+      dsp_fastfir_cf32(fs->fast, (const float*)(fs->buf + fs->skip), nout,
+                       (float*)out);
+    } else {
+      /* Overlap-save at the full rate, then keep every D-th output */
+      size_t nfull = (nout - 1) * D + 1;
+      if (nfull > fs->poly_cap) {
+        fs->poly_cap = nfull * 2;
+        fs->poly = (cplxf*)realloc(fs->poly, fs->poly_cap * sizeof(cplxf));
+      }
+      dsp_fastfir_cf32(fs->fast, (const float*)(fs->buf + fs->skip), nfull,
+                       (float*)fs->poly);
+      for (size_t j = 0; j < nout; j++) out[j] = fs->poly[j * D];
+    }
+  } else if (nout && D == 1) {
+    /* Outputs starting in the history: history plus the first span inputs */
+    size_t nh = fs->hist > fs->skip ? fs->hist - fs->skip : 0;
+    if (nh > nout) nh = nout;
+    if (nh) {
+      size_t m = n < span ? n : span;
+      fir_stream_reserve(fs, fs->hist + m);
+      memcpy(fs->buf + fs->hist, in, m * sizeof(cplxf));
+      dsp_fir_cf32((const float*)(fs->buf + fs->skip), nh, fs->taps,
+                   fs->ntaps, (float*)out);
+    }
+    if (nout > nh) {
+      dsp_fir_cf32((const float*)(in + (fs->skip + nh - fs->hist)),
+                   nout - nh, fs->taps, fs->ntaps, (float*)(out + nh));
+    }
+  } else if (nout) {
+    /* Polyphase split: branch p holds inputs skip + q*D + p */
+    size_t Q = nout + span / D + 1;
+    if (Q * D > fs->poly_cap) {
+      fs->poly_cap = Q * D * 2;
+      fs->poly = (cplxf*)realloc(fs->poly, fs->poly_cap * sizeof(cplxf));
+    }
+    size_t need = (nout - 1) * D + span + 1;
+    for (size_t p = 0; p < D && p < need; p++) {
+      fir_stream_gather(fs, in, fs->skip + p, (need - p + D - 1) / D,
+                        fs->poly + p * Q);
+    }
+    dsp_fir_poly_cf32((const float*)fs->poly, Q, fs->decim, nout, fs->taps,
+                      fs->ntaps, (float*)out);
   }
 
-  return sqrtf(err_sum / (ref_sum + 1e-30f));
+  /* Carry the inputs a later output still needs */
+  size_t used = fs->skip + nout * D;
+  if (used > total) {
+    fs->skip = used - total;
+    used = total;
+  } else {
+    fs->skip = 0;
+  }
+  size_t keep = total - used;
+  fir_stream_reserve(fs, keep);
+  if (used < fs->hist) {
+    memmove(fs->buf, fs->buf + used, (fs->hist - used) * sizeof(cplxf));
+    if (n) memcpy(fs->buf + (fs->hist - used), in, n * sizeof(cplxf));
+  } else if (keep) {
+    memcpy(fs->buf, in + (used - fs->hist), keep * sizeof(cplxf));
+  }
+  fs->hist = keep;
+  return nout;
 }
 
-/* *****************************************************************************
- *
- *                         SYMBOL PROCESSING - BPSK
- *
- * *****************************************************************************/
-
 /**
- * BPSK hard decision slicer
+ * Drain the filter tail at end of stream (zero-padded like convolve_fir)
  *
- * @param val  Input sample
- * @return +1.0 or -1.0
+ * @param fs   Stage state
+ * @param out  Output samples (capacity ntaps)
+ * @return Number of output samples produced
  */
-float slicer_bpsk(float val) { return val >= 0 ? 1.0f : -1.0f; }
+static size_t fir_stream_flush(FirStream* fs, cplxf* out) {
+  if (!fs->buf) return 0;
+  size_t pad = (size_t)(fs->ntaps - 1 - fs->ntaps / 2);
+  cplxf* zeros = (cplxf*)calloc(pad + 1, sizeof(cplxf));
+  size_t nout = fir_stream_process(fs, zeros, pad, out);
+  free(zeros);
+  return nout;
+}
 
 /**
- * Convert BPSK symbol to bit character
+ * Filter a range of a signal from an empty history
  *
- * @param sym  Input symbol
- * @return '1' or '0'
- */
-char bpsk_bit(float sym) { return sym >= 0 ? '1' : '0'; }
-
-/**
- * Calculate decision-directed EVM for BPSK symbols
+ * Feeds inputs [lo, hi) to the stage, with zeros standing in outside
+ * [0, len), and yields the outputs whose kernels lie in that range.
  *
- * @param syms  Symbol array
- * @param n     Number of symbols
- * @return EVM as fraction (0.0 - 1.0)
+ * @param fs     Stage state (history is reset)
+ * @param sig    Input signal
+ * @param len    Signal length
+ * @param lo     First input index (may be negative)
+ * @param hi     End input index (may be past len)
+ * @param zeros  Zero samples (at least ntaps of them)
+ * @param out    Output samples
+ * @return Number of output samples produced
  */
-float evm_decision_directed_bpsk(float* syms, size_t n) {
-  /* Estimate gain */
-  float num = 0.0f, den = 0.0f;
-
-  for (size_t i = 0; i < n; i++) {
-    float ref = slicer_bpsk(syms[i]);
-    num += ref * syms[i];
-    den += ref * ref;
+static size_t fir_stream_range(FirStream* fs, const cplxf* sig, long long len,
+                               long long lo, long long hi, const cplxf* zeros,
+                               cplxf* out) {
+  long long head = (hi < 0 ? hi : 0) - lo;
+  long long from = lo > 0 ? lo : 0;
+  long long to = hi < len ? hi : len;
+  long long tail = hi - (lo > len ? lo : len);
+  long long z = 0;
+
+  fs->hist = 0;
+  fs->skip = 0;
+  size_t m = 0;
+  for (; z < head; z += fs->ntaps) {
+    long long cnt = head - z < fs->ntaps ? head - z : fs->ntaps;
+    m += fir_stream_process(fs, zeros, (size_t)cnt, out + m);
   }
-
-  float a = num / (den + 1e-30f);
-
-  /* Calculate EVM */
-  float err_sum = 0.0f, ref_sum = 0.0f;
-
-  for (size_t i = 0; i < n; i++) {
-    float ref = slicer_bpsk(syms[i]);
-    float e = syms[i] - a * ref;
-    float a_ref = a * ref;
-    err_sum += e * e;
-    ref_sum += a_ref * a_ref;
+  if (to > from) {
+    m += fir_stream_process(fs, sig + from, (size_t)(to - from), out + m);
   }
-
-  return sqrtf(err_sum / (ref_sum + 1e-30f));
+  for (z = 0; z < tail; z += fs->ntaps) {
+    long long cnt = tail - z < fs->ntaps ? tail - z : fs->ntaps;
+    m += fir_stream_process(fs, zeros, (size_t)cnt, out + m);
+  }
+  return m;
 }
 
 /* *****************************************************************************
  *
- *                         INTERPOLATION HELPERS
+ *                         MULTISTAGE DECIMATION
  *
  * *****************************************************************************/
 
 /**
- * Linear interpolation for complex samples
+ * Magnitude response of an order-N CIC decimator by R
  *
- * @param buffer  Sample buffer
- * @param N       Buffer length
- * @param pos     Fractional position
- * @return Interpolated sample
+ * @param f      Frequency at the CIC output rate (cycles/sample)
+ * @param R      Total CIC decimation
+ * @param order  CIC order
+ * @return |H(f)|, unity at DC
  */
-static inline cplxf interpolate_sample(cplxf* buffer, size_t N, double pos) {
-  cplxf val = cplxf_make(0.0f, 0.0f);
+static double cic_response(double f, int R, int order) {
+  double x = M_PI * f / R;
+  if (fabs(x) < 1e-12) return 1.0;
+  return pow(fabs(sin(x * R) / (R * sin(x))), order);
+}
 
-  if (pos >= 0.0 && pos < (double)N - 1.0) {
-    size_t pi = (size_t)pos;
-    double pf = pos - (double)pi;
-    float pff = (float)pf;
-    val = cplxf_add(cplxf_mul_scalar(buffer[pi], 1.0f - pff),
-                    cplxf_mul_scalar(buffer[pi + 1], pff));
+/**
+ * One CIC stage in non-recursive form: a length-r moving sum applied
+ * order times (binomial-like taps), normalized to unity DC gain
+ */
+static float* cic_stage_taps(int r, int order, int* ntaps_out) {
+  int ntaps = order * (r - 1) + 1;
+  double* acc = (double*)calloc((size_t)ntaps, sizeof(double));
+  acc[0] = 1.0;
+  int len = 1;
+  for (int s = 0; s < order; s++) {
+    for (int n = len + r - 2; n >= 0; n--) {
+      double sum = 0.0;
+      for (int k = 0; k < r; k++) {
+        if (n - k >= 0 && n - k < len) sum += acc[n - k];
+      }
+      acc[n] = sum;
+    }
+    len += r - 1;
   }
-
-  return val;
+  float* h = (float*)malloc((size_t)ntaps * sizeof(float));
+  double gain = pow((double)r, order);
+  for (int n = 0; n < ntaps; n++) h[n] = (float)(acc[n] / gain);
+  free(acc);
+  *ntaps_out = ntaps;
+  return h;
 }
 
 /**
- * Linear interpolation for float samples
+ * CIC droop compensating low-pass FIR (frequency sampling, Hamming window)
  *
- * @param buffer  Sample buffer
- * @param N       Buffer length
- * @param pos     Fractional position
- * @return Interpolated sample
+ * @param cutoff  Passband edge at this filter's input rate (0.0 - 0.5)
+ * @param ntaps   Number of taps (odd)
+ * @param R       CIC decimation ahead of this filter
+ * @param order   CIC order
+ * @return Pointer to tap array (caller must free)
  */
-static inline float interpolate_sample_f(float* buffer, size_t N, double pos) {
-  float val = 0.0f;
+static float* cic_comp_fir(double cutoff, int ntaps, int R, int order) {
+  float* h = (float*)malloc((size_t)ntaps * sizeof(float));
+  int M = ntaps - 1;
 
-  if (pos >= 0.0 && pos < (double)N - 1.0) {
-    size_t pi = (size_t)pos;
-    double pf = pos - (double)pi;
-    float pff = (float)pf;
-    val = buffer[pi] * (1.0f - pff) + buffer[pi + 1] * pff;
+  /* Desired response: inverse CIC droop in the passband, zero above */
+  int nk = 0;
+  while (nk <= CIC_COMP_GRID && 0.5 * nk / CIC_COMP_GRID <= cutoff) nk++;
+  double* amp = (double*)malloc((size_t)(nk + 1) * sizeof(double));
+  for (int k = 0; k < nk; k++) {
+    amp[k] = (k == 0 ? 1.0 : 2.0) /
+             cic_response(0.5 * k / CIC_COMP_GRID, R, order);
   }
 
-  return val;
-}
+  for (int n = 0; n < ntaps; n++) {
+    double x = n - M / 2.0;
+    double acc = 0.0;
+    for (int k = 0; k < nk; k++) {
+      acc += amp[k] * cos(M_PI * k / CIC_COMP_GRID * x);
+    }
+    double w = 0.54 - 0.46 * cos(2.0 * M_PI * n / M);
+    h[n] = (float)(acc * w);
+  }
+  free(amp);
+  for (int n = 0; n < ntaps / 2; n++) h[ntaps - 1 - n] = h[n];
 
-/* *****************************************************************************
- *
- *                         SIGNAL LOADING AND PREPROCESSING
- *
- * *****************************************************************************/
+  float sum = 0.0f;
+  for (int n = 0; n < ntaps; n++) sum += h[n];
+  for (int n = 0; n < ntaps; n++) h[n] /= sum;
+  return h;
+}
 
 /**
- * Load IQ file and apply preprocessing chain
+ * Design the low-pass / decimation filter chain for a decimation factor
  *
- * Processing steps:
- *   1. Load raw IQ samples
- *   2. Remove DC offset
- *   3. Scale to voltage
- *   4. Optional low-pass filtering
- *   5. Decimation
- *   6. Optional RRC matched filtering
- *   7. Normalize amplitude
+ * Below DECIM_CHAIN_MIN this is the single decimating low-pass. Larger
+ * factors split into CIC stages (one per prime factor of decim / p, p the
+ * smallest prime factor) that cost a few operations per input sample,
+ * followed by a short droop compensating FIR decimating by p at the low
+ * rate. The passband edge follows the output rate.
  *
- * @param cfg        Configuration parameters
- * @param out_len    Output: number of samples after processing
- * @param final_sps  Output: effective samples per symbol
- * @return Processed signal array (caller must free)
+ * @param d      Design to fill in
+ * @param decim  Total decimation factor
  */
-cplxf* load_and_process(Config* cfg, size_t* out_len, float* final_sps,
-                        double* pwr_raw_w, double* pwr_post_w){
-
-  if (pwr_raw_w) *pwr_raw_w = 0.0;
-  if (pwr_post_w) *pwr_post_w = 0.0;
-  printf("--- STEP 1: LOADING & DECIMATION ---\n");
-
-  /* Open input file */
-  FILE* f = fopen(cfg->input_file, "rb");
-  if (!f) {
-    fprintf(stderr, "Error: Cannot open input file: %s\n", cfg->input_file);
-    return NULL;
+static void decim_design(DecimDesign* d, int decim) {
+  memset(d, 0, sizeof(*d));
+  float cutoff_norm = LOWPASS_CUTOFF_NORM / 150.0f;
+  if (cutoff_norm > 0.45f) cutoff_norm = 0.45f;
+  if (decim < 1) decim = 1;
+
+  if (decim < DECIM_CHAIN_MIN) {
+    d->nstages = 1;
+    d->taps[0] = hamming_window_fir(cutoff_norm, LOWPASS_NTAPS);
+    d->ntaps[0] = LOWPASS_NTAPS;
+    d->decim[0] = decim;
+    d->cutoff = cutoff_norm;
+    return;
   }
 
-  /* Get file size */
-  fseek(f, 0, SEEK_END);
-  long file_size = ftell(f);
-  fseek(f, 0, SEEK_SET);
-
-  size_t n_samples;
-  float* i_arr;
-  float* q_arr;
-
-  /* Load samples based on format */
-  if (cfg->input_format == FMT_IQ32) {
-    /* IQ32: 32-bit I, 32-bit Q (int32_t pairs) */
-    n_samples = file_size / (2 * sizeof(int32_t));
-    int32_t* raw_int = (int32_t*)malloc(2 * n_samples * sizeof(int32_t));
-    fread(raw_int, sizeof(int32_t), 2 * n_samples, f);
-    fclose(f);
-
-    printf("   Loaded %zu IQ samples (IQ32 format)\n", n_samples);
-
-    i_arr = (float*)malloc(n_samples * sizeof(float));
-    q_arr = (float*)malloc(n_samples * sizeof(float));
-    for (size_t n = 0; n < n_samples; n++) {
-      i_arr[n] = (float)raw_int[2 * n];
-      q_arr[n] = (float)raw_int[2 * n + 1];
-    }
-    free(raw_int);
-  } else {
-    /* IQ16: 16-bit I, 16-bit Q (int16_t pairs) - default */
-    n_samples = file_size / (2 * sizeof(int16_t));
-    int16_t* raw_int = (int16_t*)malloc(2 * n_samples * sizeof(int16_t));
-    fread(raw_int, sizeof(int16_t), 2 * n_samples, f);
-    fclose(f);
-
-    printf("   Loaded %zu IQ samples (IQ16 format)\n", n_samples);
-
-    i_arr = (float*)malloc(n_samples * sizeof(float));
-    q_arr = (float*)malloc(n_samples * sizeof(float));
-    for (size_t n = 0; n < n_samples; n++) {
-      i_arr[n] = (float)raw_int[2 * n];
-      q_arr[n] = (float)raw_int[2 * n + 1];
+  int p = 2;
+  while (decim % p) p++;
+  int R = decim / p;
+  d->cic_order = CIC_ORDER;
+  for (int rest = R, f = 2; rest > 1;) {
+    if (d->nstages == DECIM_MAX_STAGES - 2) f = rest; /* Merge the rest */
+    if (rest % f) {
+      f++;
+      continue;
     }
-    free(raw_int);
+    int s = d->nstages++;
+    d->taps[s] = cic_stage_taps(f, CIC_ORDER, &d->ntaps[s]);
+    d->decim[s] = f;
+    rest /= f;
   }
 
-  /* Remove DC offset */
-  float i_mean = 0.0f, q_mean = 0.0f;
-  for (size_t n = 0; n < n_samples; n++) {
-    i_mean += i_arr[n];
-    q_mean += q_arr[n];
-  }
-  i_mean /= n_samples;
-  q_mean /= n_samples;
+  /* Compensation FIR at the CIC output rate */
+  double cutoff = DECIM_PASS_FRAC / decim;
+  if (cutoff > cutoff_norm) cutoff = cutoff_norm;
+  int s = d->nstages++;
+  d->taps[s] = cic_comp_fir(cutoff * R, CIC_COMP_NTAPS, R, CIC_ORDER);
+  d->ntaps[s] = CIC_COMP_NTAPS;
+  d->decim[s] = p;
+  d->cutoff = (float)cutoff;
+}
 
-  for (size_t n = 0; n < n_samples; n++) {
-    i_arr[n] -= i_mean;
-    q_arr[n] -= q_mean;
-  }
+/**
+ * Release a filter chain design
+ * @param d  Design
+ */
+static void decim_design_free(DecimDesign* d) {
+  for (int s = 0; s < d->nstages; s++) free(d->taps[s]);
+  memset(d, 0, sizeof(*d));
+}
 
-  /* Scale to voltage */
-  float Vpk = cfg->fs_vpp / 2.0f;
-  float v_per_count;
-  if (cfg->input_format == FMT_IQ32) {
-    v_per_count = Vpk / 2147483648.0f; /* 2^31 for 32-bit */
-  } else {
-    v_per_count = Vpk / 32768.0f; /* 2^15 for 16-bit */
+/**
+ * Log a filter chain design
+ * @param d  Design
+ */
+static void decim_design_print(const DecimDesign* d) {
+  if (!d->cic_order) {
+    printf("   [FILTER] Low-pass enabled - Cutoff: %.4f (Fs), Taps: %d (%s)\n",
+           d->cutoff, d->ntaps[0],
+           fir_method_name(d->taps[0], d->ntaps[0], d->decim[0]));
+    return;
   }
+  int R = 1;
+  for (int s = 0; s + 1 < d->nstages; s++) R *= d->decim[s];
+  int last = d->nstages - 1;
+  printf("   [FILTER] Decimation chain - Cutoff: %.4f (Fs) | CIC order %d, "
+         "x%d in %d stage(s) | Compensation FIR: %d taps, x%d (%s)\n",
+         d->cutoff, d->cic_order, R, last, d->ntaps[last], d->decim[last],
+         fir_method_name(d->taps[last], d->ntaps[last], d->decim[last]));
+}
 
-  cplxf* sig_v = (cplxf*)malloc(n_samples * sizeof(cplxf));
-  for (size_t n = 0; n < n_samples; n++) {
-    sig_v[n] = cplxf_make(i_arr[n] * v_per_count, q_arr[n] * v_per_count);
-  }
-  free(i_arr);
-  free(q_arr);
-  // ---- RAW POWER (before any filtering/decim/normalize) ----
-  if (pwr_raw_w) {
-    *pwr_raw_w = mean_power_w_cplxf(sig_v, n_samples, (double)cfg->rload);
+/**
+ * Initialize filter chain state for a design
+ *
+ * @param ch  Chain to initialize
+ * @param d   Design (owned by the caller)
+ */
+static void decim_chain_init(DecimChain* ch, const DecimDesign* d) {
+  memset(ch, 0, sizeof(*ch));
+  ch->design = d;
+  for (int s = 0; s < d->nstages; s++) {
+    fir_stream_init_decim(&ch->stage[s], d->taps[s], d->ntaps[s],
+                          d->decim[s]);
   }
-  /* Optional low-pass filtering */
-  cplxf* sig_filt;
-
-#if ENABLE_LOWPASS
-  float cutoff_norm = LOWPASS_CUTOFF_NORM / 150.0f;
-  if (cutoff_norm > 0.45f) cutoff_norm = 0.45f;
-  printf("   [FILTER] Low-pass enabled - Cutoff: %.4f (Fs), Taps: %d\n",
-         cutoff_norm, LOWPASS_NTAPS);
-
-  float* lp_taps = hamming_window_fir(cutoff_norm, LOWPASS_NTAPS);
-  sig_filt = convolve_fir(sig_v, n_samples, lp_taps, LOWPASS_NTAPS);
-  free(lp_taps);
-  free(sig_v);
-#else
-  printf("   [FILTER] Low-pass disabled - skipping\n");
-  sig_filt = sig_v;
-#endif
-
-  /* Decimation */
-  size_t out_samples;
-  cplxf* sig_dec;
+}
 
-  if (cfg->decim > 1) {
-    out_samples = n_samples / cfg->decim;
-    sig_dec = (cplxf*)malloc(out_samples * sizeof(cplxf));
-    for (size_t n = 0; n < out_samples; n++) {
-      sig_dec[n] = sig_filt[n * cfg->decim];
-    }
-    *final_sps = cfg->sps / cfg->decim;
-    printf("   [DECIMATION] Factor: %d | New SPS: %.4f\n", cfg->decim,
-           *final_sps);
-    free(sig_filt);
-  } else {
-    sig_dec = sig_filt;
-    out_samples = n_samples;
-    *final_sps = cfg->sps;
+/**
+ * Release filter chain state
+ * @param ch  Chain
+ */
+static void decim_chain_free(DecimChain* ch) {
+  if (!ch->design) return;
+  for (int s = 0; s < ch->design->nstages; s++) {
+    fir_stream_free(&ch->stage[s]);
   }
+  free(ch->tmp[0]);
+  free(ch->tmp[1]);
+  memset(ch, 0, sizeof(*ch));
+}
 
-  /* Optional RRC matched filtering */
-  cplxf* sig_out = sig_dec;
-  size_t final_len = out_samples;
+/**
+ * Make sure both stage scratch buffers hold n samples
+ */
+static void decim_chain_reserve(DecimChain* ch, size_t n) {
+  if (n <= ch->tmp_cap) return;
+  ch->tmp_cap = n * 2;
+  ch->tmp[0] = (cplxf*)realloc(ch->tmp[0], ch->tmp_cap * sizeof(cplxf));
+  ch->tmp[1] = (cplxf*)realloc(ch->tmp[1], ch->tmp_cap * sizeof(cplxf));
+}
 
-  if (cfg->rrc_enable) {
-    float Rs = cfg->rb / 2.0f;
-    float Fs_dec = (Rs * cfg->sps) / cfg->decim;
-    int rrc_ntaps;
-    float* rrc =
-        rrc_taps(Fs_dec, Rs, cfg->rrc_alpha, cfg->rrc_span, &rrc_ntaps);
-    cplxf* sig_rrc = convolve_fir(sig_dec, out_samples, rrc, rrc_ntaps);
-    free(rrc);
-    free(sig_dec);
-
-    if (cfg->rrc_trim_delay) {
-      int gd = (rrc_ntaps - 1) / 2;
-      final_len = out_samples - gd;
-      sig_out = (cplxf*)malloc(final_len * sizeof(cplxf));
-      memcpy(sig_out, sig_rrc + gd, final_len * sizeof(cplxf));
-      free(sig_rrc);
-    } else {
-      sig_out = sig_rrc;
-      final_len = out_samples;
-    }
-  }
-  if (pwr_post_w) {
-    *pwr_post_w = mean_power_w_cplxf(sig_out, final_len, (double)cfg->rload);
-  }
-  /* Normalize amplitude */
-  float max_abs = 0.0f;
-  for (size_t n = 0; n < final_len; n++) {
-    float mag = cplxf_abs(sig_out[n]);
-    if (mag > max_abs) max_abs = mag;
-  }
-  for (size_t n = 0; n < final_len; n++) {
-    sig_out[n] = cplxf_div_scalar(sig_out[n], max_abs + 1e-12f);
+/**
+ * Total number of taps over all stages (bounds the flush output)
+ */
+static size_t decim_chain_taps(const DecimChain* ch) {
+  size_t n = 0;
+  if (!ch->design) return 0;
+  for (int s = 0; s < ch->design->nstages; s++) {
+    n += (size_t)ch->design->ntaps[s];
   }
-
-  *out_len = final_len;
-  return sig_out;
+  return n;
 }
 
-/* *****************************************************************************
- *
- *                         BIT/BYTE CONVERSION UTILITIES
+/**
+ * Push a block through every stage of the chain
  *
- * *****************************************************************************/
+ * @param ch     Chain state
+ * @param in     Input samples
+ * @param n      Number of input samples
+ * @param flush  Non-zero to drain every stage at end of stream
+ * @param out    Output samples (capacity n + decim_chain_taps())
+ * @return Number of output samples produced
+ */
+static size_t decim_chain_process(DecimChain* ch, const cplxf* in, size_t n,
+                                  int flush, cplxf* out) {
+  int last = ch->design->nstages - 1;
+  decim_chain_reserve(ch, n + decim_chain_taps(ch));
+  const cplxf* src = in;
+  size_t len = n;
+  for (int s = 0; s <= last; s++) {
+    cplxf* dst = s == last ? out : ch->tmp[s & 1];
+    size_t k = fir_stream_process(&ch->stage[s], src, len, dst);
+    if (flush) k += fir_stream_flush(&ch->stage[s], dst + k);
+    src = dst;
+    len = k;
+  }
+  return len;
+}
 
 /**
- * Convert packed bytes to unpacked bits (MSB first)
+ * Work back from outputs [j0, j1) of the chain to the input range (with
+ * halos) of every stage
  *
- * @param input      Input byte array
- * @param output     Output bit array
- * @param byteCount  Number of bytes to convert
+ * @param d    Chain design
+ * @param len  Input length
+ * @param j0   First output index
+ * @param j1   End output index
+ * @param lo   Output: first input index of each stage (may be negative)
+ * @param hi   Output: end input index of each stage (may be past the end)
+ * @param olo  Output: first output index of each stage
+ * @param ohi  Output: end output index of each stage
+ * @return Largest number of outputs of any stage
  */
-void bytesToBits(const unsigned char* input, unsigned char* output,
-                 size_t byteCount) {
-  for (size_t i = 0; i < byteCount; i++) {
-    for (int j = 0; j < 8; j++) {
-      output[i * 8 + (7 - j)] = (input[i] >> j) & 1;
-    }
+static size_t decim_chain_plan(const DecimDesign* d, long long len,
+                               long long j0, long long j1, long long* lo,
+                               long long* hi, long long* olo,
+                               long long* ohi) {
+  long long slen[DECIM_MAX_STAGES + 1];
+  slen[0] = len;
+  for (int s = 0; s < d->nstages; s++) slen[s + 1] = slen[s] / d->decim[s];
+
+  long long a = j0, b = j1;
+  size_t need = 0;
+  for (int s = d->nstages - 1; s >= 0; s--) {
+    olo[s] = a;
+    ohi[s] = b;
+    lo[s] = a * d->decim[s] - d->ntaps[s] / 2;
+    hi[s] = (b - 1) * d->decim[s] - d->ntaps[s] / 2 + d->ntaps[s];
+    a = lo[s] > 0 ? lo[s] : 0;
+    b = hi[s] < slen[s] ? hi[s] : slen[s];
+    if (b < a) b = a;
+    if ((size_t)(ohi[s] - olo[s]) > need) need = (size_t)(ohi[s] - olo[s]);
   }
+  return need;
 }
 
 /**
- * Convert unpacked bits to packed bytes (MSB first)
+ * Compute outputs [j0, j1) of the chain over a whole signal
  *
- * @param input     Input bit array
- * @param output    Output byte array
- * @param bitCount  Number of bits to convert
+ * Every stage sees its input as zero outside [0, length), where each
+ * stage's length is the previous one divided by its decimation. Works back
+ * from the wanted outputs to the input range (with halos) of each stage.
+ * The input may be a window of the signal: sig[0] is sample at, and the
+ * window must hold every sample of [0, len) the first stage reads.
+ *
+ * @param ch     Chain state (per worker)
+ * @param sig    Input samples, starting at signal index at
+ * @param at     Signal index of sig[0]
+ * @param len    Input length
+ * @param j0     First output index
+ * @param j1     End output index
+ * @param zeros  Zero samples (at least the longest stage's taps)
+ * @param out    Output samples (j1 - j0)
  */
-void bitsToBytes(const unsigned char* input, unsigned char* output,
-                 size_t bitCount) {
-  for (size_t i = 0; i < (bitCount / 8); i++) {
-    output[i] = 0;
-    for (int j = 0; j < 8; j++) {
-      output[i] |= ((int)input[i * 8 + j]) << (7 - j);
-    }
+static void decim_chain_range(DecimChain* ch, const cplxf* sig, long long at,
+                              long long len, long long j0, long long j1,
+                              const cplxf* zeros, cplxf* out) {
+  const DecimDesign* d = ch->design;
+  long long lo[DECIM_MAX_STAGES], hi[DECIM_MAX_STAGES];
+  long long olo[DECIM_MAX_STAGES], ohi[DECIM_MAX_STAGES];
+  decim_chain_reserve(ch, decim_chain_plan(d, len, j0, j1, lo, hi, olo, ohi));
+
+  /* Run the stages first to last */
+  const cplxf* src = sig;
+  long long base = at, src_len = len - at;
+  for (int s = 0; s < d->nstages; s++) {
+    cplxf* dst = s == d->nstages - 1 ? out : ch->tmp[s & 1];
+    fir_stream_range(&ch->stage[s], src, src_len, lo[s] - base, hi[s] - base,
+                     zeros, dst);
+    src = dst;
+    base = olo[s];
+    src_len = ohi[s] - olo[s];
   }
 }
 
 /* *****************************************************************************
  *
- *                         UDP STREAMING
+ *                         FARROW RESAMPLER
  *
  * *****************************************************************************/
 
-#if ENABLE_UDP_SENDER
 /**
- * Send demodulated bits via UDP (unpacked format: 0x01/0x00)
+ * Cubic Lagrange interpolation in Farrow form
  *
- * @param bits        Bit array to send
- * @param total_bits  Total number of bits
- * @param host        Destination IP address
- * @param port        Destination UDP port
- * @param chunk_size  Bytes per UDP packet
- * @return 0 on success, -1 on error
+ * @param x   Samples x[-1], x[0], x[1], x[2] (points at x[-1])
+ * @param mu  Fractional position between x[0] and x[1] (0..1)
+ * @return Interpolated sample
  */
-int udp_send_unpacked_bits(const unsigned char* bits, size_t total_bits,
-                           const char* host, int port, size_t chunk_size) {
-#ifdef _WIN32
-  WSADATA wsa;
-  SOCKET sock;
-  if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
-    fprintf(stderr, "[UDP] WSAStartup failed\n");
-    return -1;
-  }
-#else
-  int sock;
-#endif
+static inline cplxf farrow_cubic(const cplxf* x, float mu) {
+  cplxf c3 = cplxf_add(cplxf_mul_scalar(cplxf_sub(x[3], x[0]), 1.0f / 6.0f),
+                       cplxf_mul_scalar(cplxf_sub(x[1], x[2]), 0.5f));
+  cplxf c2 = cplxf_sub(cplxf_mul_scalar(cplxf_add(x[0], x[2]), 0.5f), x[1]);
+  cplxf c1 = cplxf_sub(cplxf_sub(x[2], cplxf_mul_scalar(x[1], 0.5f)),
+                       cplxf_add(cplxf_mul_scalar(x[0], 1.0f / 3.0f),
+                                 cplxf_mul_scalar(x[3], 1.0f / 6.0f)));
+  cplxf y = cplxf_add(cplxf_mul_scalar(c3, mu), c2);
+  y = cplxf_add(cplxf_mul_scalar(y, mu), c1);
+  return cplxf_add(cplxf_mul_scalar(y, mu), x[1]);
+}
 
-  struct sockaddr_in dest_addr;
+/**
+ * Cubic Lagrange interpolation in Farrow form, one channel
+ *
+ * Same arithmetic as farrow_cubic() on either component.
+ *
+ * @param x   Samples x[-1], x[0], x[1], x[2] (points at x[-1])
+ * @param mu  Fractional position between x[0] and x[1] (0..1)
+ * @return Interpolated sample
+ */
+static inline float farrow_cubic_f(const float* x, float mu) {
+  float c3 = (x[3] - x[0]) * (1.0f / 6.0f) + (x[1] - x[2]) * 0.5f;
+  float c2 = (x[0] + x[2]) * 0.5f - x[1];
+  float c1 =
+      (x[2] - x[1] * 0.5f) - (x[0] * (1.0f / 3.0f) + x[3] * (1.0f / 6.0f));
+  float y = c3 * mu + c2;
+  y = y * mu + c1;
+  return y * mu + x[1];
+}
+
+/**
+ * Interpolate outputs m0 .. m0+n-1 at input positions m * ratio
+ *
+ * @param x      Input window (x[j] is input sample base + j); must cover
+ *               one sample before and two after every position
+ * @param base   Input index of x[0]
+ * @param ratio  Input samples per output
+ * @param m0     Index of the first output
+ * @param n      Number of outputs
+ * @param out    Output samples
+ */
+static void resample_block(const cplxf* x, long long base, double ratio,
+                           uint64_t m0, size_t n, cplxf* out) {
+  for (size_t k = 0; k < n; k++) {
+    double t = (double)(m0 + k) * ratio;
+    long long i = (long long)floor(t);
+    out[k] = farrow_cubic(x + (i - 1 - base), (float)(t - (double)i));
+  }
+}
+
+/**
+ * Number of outputs for n inputs (every position m * ratio < n)
+ */
+static size_t resample_count(size_t n, double ratio) {
+  size_t m = (size_t)((double)n / ratio);
+  while (m > 0 && (double)(m - 1) * ratio >= (double)n) m--;
+  while ((double)m * ratio < (double)n) m++;
+  return m;
+}
+
+/**
+ * Set up resampling from the decimated rate to the configured loop SPS
+ *
+ * @param cfg        Configuration parameters
+ * @param final_sps  In: SPS after decimation; out: SPS at the loops
+ * @return Input samples per output, 0 if no resampling is needed
+ */
+static double resample_setup(const Config* cfg, float* final_sps) {
+  if (cfg->target_sps <= 0.0f || cfg->target_sps == *final_sps) return 0.0;
+  double in_sps = (double)cfg->sps / (cfg->decim > 1 ? cfg->decim : 1);
+  double ratio = in_sps / (double)cfg->target_sps;
+  printf("   [RESAMPLE] Farrow cubic | SPS: %.4f -> %.4f (ratio %.6f)\n",
+         in_sps, cfg->target_sps, ratio);
+  *final_sps = cfg->target_sps;
+  return ratio;
+}
+
+/**
+ * Initialize a streaming resampler
+ *
+ * Starts with one zero before the first input, as the whole-file path pads
+ * the signal with zeros.
+ *
+ * @param rs     Stage to initialize
+ * @param ratio  Input samples per output
+ */
+static void resample_stream_init(ResampleStream* rs, double ratio) {
+  memset(rs, 0, sizeof(*rs));
+  rs->ratio = ratio;
+  rs->capacity = 8;
+  rs->buf = (cplxf*)calloc(rs->capacity, sizeof(cplxf));
+  rs->len = 1;
+  rs->base = -1;
+}
+
+/**
+ * Release a streaming resampler
+ * @param rs  Stage to free
+ */
+static void resample_stream_free(ResampleStream* rs) {
+  free(rs->buf);
+  rs->buf = NULL;
+  rs->capacity = 0;
+}
+
+/**
+ * Largest number of outputs for n inputs
+ */
+static size_t resample_stream_max_out(const ResampleStream* rs, size_t n) {
+  return (size_t)((double)(n + 4) / rs->ratio) + 2;
+}
+
+/**
+ * Resample a block, carrying the inputs later outputs still need
+ *
+ * @param rs     Stage state
+ * @param in     Input samples (may alias out)
+ * @param n      Number of input samples
+ * @param flush  Non-zero at end of stream (zero-pads the tail)
+ * @param out    Output samples (capacity resample_stream_max_out())
+ * @return Number of output samples produced
+ */
+static size_t resample_stream_process(ResampleStream* rs, const cplxf* in,
+                                      size_t n, int flush, cplxf* out) {
+  size_t pad = flush ? 3 : 0;
+  if (rs->len + n + pad > rs->capacity) {
+    rs->capacity = (rs->len + n + pad) * 2;
+    rs->buf = (cplxf*)realloc(rs->buf, rs->capacity * sizeof(cplxf));
+  }
+  if (n) memcpy(rs->buf + rs->len, in, n * sizeof(cplxf));
+  rs->len += n;
+  rs->n_in += n;
+  for (size_t k = 0; k < pad; k++) rs->buf[rs->len++] = cplxf_make(0.0f, 0.0f);
+
+  /* Outputs whose four taps are all in the buffer */
+  long long end = rs->base + (long long)rs->len;
+  size_t cnt = 0;
+  for (;;) {
+    double t = (double)(rs->next + cnt) * rs->ratio;
+    if (t >= (double)rs->n_in || (long long)floor(t) + 2 >= end) break;
+    cnt++;
+  }
+  resample_block(rs->buf, rs->base, rs->ratio, rs->next, cnt, out);
+  rs->next += cnt;
+
+  /* Keep from the first sample the next output needs */
+  long long keep = (long long)floor((double)rs->next * rs->ratio) - 1;
+  long long drop = keep - rs->base;
+  if (drop > (long long)rs->len) drop = (long long)rs->len;
+  if (drop > 0) {
+    rs->len -= (size_t)drop;
+    memmove(rs->buf, rs->buf + drop, rs->len * sizeof(cplxf));
+    rs->base += drop;
+  }
+  return cnt;
+}
+
+/* *****************************************************************************
+ *
+ *                         AUTOMATIC GAIN CONTROL
+ *
+ * *****************************************************************************/
+
+/**
+ * Initialize the gain control
+ *
+ * @param agc  State to initialize
+ * @param cfg  Configuration parameters
+ */
+static void agc_init(AgcState* agc, const Config* cfg) {
+  memset(agc, 0, sizeof(*agc));
+  agc->level = cfg->agc_level;
+  agc->attack = cfg->agc_attack;
+  agc->decay = cfg->agc_decay;
+  agc->clip = AGC_CLIP_RMS * sqrtf(agc->level);
+  agc->power = -1.0;
+}
+
+/**
+ * Release gain control buffers
+ * @param agc  State
+ */
+static void agc_free(AgcState* agc) {
+  free(agc->pend);
+  agc->pend = NULL;
+  agc->pend_cap = 0;
+}
+
+/**
+ * Sum of |v|^2 over a block (one accumulation order for every path)
+ */
+static double agc_block_power(const cplxf* x, size_t n) {
+  double sum = 0.0;
+  for (size_t k = 0; k < n; k++) sum += (double)cplxf_abs2(x[k]);
+  return sum;
+}
+
+/**
+ * Update the power estimate with one block and return its gain
+ *
+ * The estimate follows rising power with the attack smoothing and falling
+ * power with the decay smoothing, so a burst is caught at once and the
+ * gain recovers gradually after it; one square root per block.
+ *
+ * @param agc  State
+ * @param sum  Sum of |v|^2 over the block
+ * @param n    Samples in the block
+ * @return Gain for the block
+ */
+static float agc_block_gain(AgcState* agc, double sum, size_t n) {
+  double p = n ? sum / (double)n : 0.0;
+  if (agc->power < 0.0) {
+    agc->power = p;
+  } else {
+    double c = p > agc->power ? agc->attack : agc->decay;
+    agc->power += c * (p - agc->power);
+  }
+  return (float)sqrt(agc->level / (agc->power + 1e-30));
+}
+
+/**
+ * Apply a block gain and limit the components
+ *
+ * The limiter keeps the part of a short, strong burst that the block gain
+ * cannot absorb from kicking the carrier and timing loops, whose error
+ * terms grow with the square of the amplitude.
+ *
+ * @param x     Input samples (may alias out)
+ * @param n     Number of samples
+ * @param g     Gain
+ * @param clip  Limit on |I| and |Q|
+ * @param out   Output samples
+ */
+static void agc_apply(const cplxf* x, size_t n, float g, float clip,
+                      cplxf* out) {
+  for (size_t k = 0; k < n; k++) {
+    float re = x[k].re * g;
+    float im = x[k].im * g;
+    out[k].re = re > clip ? clip : (re < -clip ? -clip : re);
+    out[k].im = im > clip ? clip : (im < -clip ? -clip : im);
+  }
+}
+
+/**
+ * Level a stream of samples block by block
+ *
+ * Samples are held until their AGC_BLOCK_SAMPLES block is complete, since
+ * the block's gain depends on its own power.
+ *
+ * @param agc    State
+ * @param in     Input samples (may alias out)
+ * @param n      Number of samples
+ * @param flush  Non-zero to release the last, partial block
+ * @param out    Output samples (capacity n + AGC_BLOCK_SAMPLES)
+ * @return Number of output samples
+ */
+static size_t agc_stream_process(AgcState* agc, const cplxf* in, size_t n,
+                                 int flush, cplxf* out) {
+  if (agc->npend + n > agc->pend_cap) {
+    agc->pend_cap = (agc->npend + n) * 2;
+    agc->pend = (cplxf*)realloc(agc->pend, agc->pend_cap * sizeof(cplxf));
+  }
+  if (n) memcpy(agc->pend + agc->npend, in, n * sizeof(cplxf));
+  agc->npend += n;
+
+  size_t m = 0;
+  while (agc->npend - m >= AGC_BLOCK_SAMPLES ||
+         (flush && agc->npend > m)) {
+    size_t cnt = agc->npend - m;
+    if (cnt > AGC_BLOCK_SAMPLES) cnt = AGC_BLOCK_SAMPLES;
+    const cplxf* blk = agc->pend + m;
+    float g = agc_block_gain(agc, agc_block_power(blk, cnt), cnt);
+    agc_apply(blk, cnt, g, agc->clip, out + m);
+    m += cnt;
+  }
+  agc->npend -= m;
+  memmove(agc->pend, agc->pend + m, agc->npend * sizeof(cplxf));
+  return m;
+}
+
+/* *****************************************************************************
+ *
+ *                         FUSED WHOLE-FILE FRONT-END
+ *
+ * *****************************************************************************/
+
+typedef struct {
+  DecimChain lp;  /* Low-pass stages (decimating)                 */
+  FirStream rrc;  /* RRC matched filter stage                     */
+  cplxf* in;      /* Converted low-pass input of one tile         */
+  size_t in_cap;  /* Allocated length of in                       */
+  cplxf* dec;     /* Decimated samples of one tile plus RRC halo  */
+  cplxf* mf;      /* Matched filter output for the resampler      */
+  int16_t* ph;    /* Q15 low-pass phase streams (I, then Q)       */
+  int16_t* qdec;  /* Q15 decimated samples plus RRC halo (I, Q)   */
+  int16_t* qmf;   /* Q15 matched filter output (I, Q)             */
+} FrontTileWorker;
+
+typedef struct {
+  const cplxf* sig;      /* Input signal (NULL = converted per tile)  */
+  const void* raw;       /* Mapped capture converted per tile         */
+  int format;            /* FMT_* of raw                              */
+  size_t sample_bytes;   /* Bytes per raw sample                      */
+  float dc_i;            /* DC removed from raw I (counts)            */
+  float dc_q;            /* DC removed from raw Q (counts)            */
+  long long sig_len;     /* Input length                              */
+  const DecimDesign* lp; /* Low-pass design (NULL = pick only)        */
+  int decim;             /* Decimation factor                         */
+  long long dec_len;     /* Samples after decimation                  */
+  int defer_dc;          /* DC removal/scaling after the low-pass     */
+  cplxf dc_fold;         /* Deferred DC estimate                      */
+  float v_scale;         /* Deferred volt scale                       */
+  float lp_tap_sum;      /* Low-pass DC gain                          */
+  const float* rrc_taps; /* RRC coefficients (NULL = disabled)        */
+  int rrc_ntaps;         /* RRC taps                                  */
+  size_t first;          /* Decimated index of the first output       */
+  size_t mf_len;         /* Samples after matched filtering           */
+  double ratio;          /* Resampling input per output (0 = off)     */
+  size_t count;          /* Output samples                            */
+  cplxf* out;            /* Output array                              */
+  FrontTileWorker* workers; /* Stages and scratch of each worker      */
+  const cplxf* zeros;    /* Zero padding                              */
+  double* blk_pwr;       /* Sum of |v|^2 of each AGC block            */
+  float* blk_gain;       /* Gain of each AGC block                    */
+  float clip;            /* AGC component limit                       */
+  int q15;               /* Q15 stages on IQ16 counts (0 = float)     */
+  int q15_check;         /* Measure the Q15 error on the first tile   */
+  const int16_t* lp_q15; /* Q15 low-pass taps                         */
+  const int16_t* rrc_q15; /* Q15 RRC taps (NULL = disabled)           */
+  float q15_scale;       /* Volts per count of the Q15 stage output   */
+  size_t q_cap;          /* Samples per Q15 plane of qdec and qmf     */
+  double q15_err_db;     /* Q15 error against the float stages (dB)   */
+} FrontTileJob;
+
+/**
+ * Convert input samples [a, b) of the mapped capture for one tile
+ *
+ * @return Converted samples (worker scratch, valid until the next call)
+ */
+static const cplxf* front_tile_convert(const FrontTileJob* job,
+                                       FrontTileWorker* w, long long a,
+                                       long long b) {
+  size_t n = b > a ? (size_t)(b - a) : 0;
+  if (n > w->in_cap) {
+    w->in_cap = n * 2;
+    w->in = (cplxf*)realloc(w->in, w->in_cap * sizeof(cplxf));
+  }
+  if (n) {
+    iq_convert_block((const char*)job->raw + (size_t)a * job->sample_bytes,
+                     n, job->format, job->dc_i, job->dc_q, job->v_scale,
+                     w->in, NULL);
+  }
+  return w->in;
+}
+
+/**
+ * Low-pass and decimate samples [j0, j1) of the decimated signal
+ *
+ * Without a full-length input signal the tile's low-pass input (with the
+ * filter halos) is converted from the mapped capture first.
+ */
+static void front_tile_decimate(const FrontTileJob* job, FrontTileWorker* w,
+                                long long j0, long long j1, cplxf* out) {
+  long long D = job->decim;
+  if (job->lp && job->sig) {
+    decim_chain_range(&w->lp, job->sig, 0, job->sig_len, j0, j1, job->zeros,
+                      out);
+  } else if (job->lp) {
+    long long lo[DECIM_MAX_STAGES], hi[DECIM_MAX_STAGES];
+    long long olo[DECIM_MAX_STAGES], ohi[DECIM_MAX_STAGES];
+    decim_chain_plan(job->lp, job->sig_len, j0, j1, lo, hi, olo, ohi);
+    long long a = lo[0] > 0 ? lo[0] : 0;
+    long long b = hi[0] < job->sig_len ? hi[0] : job->sig_len;
+    const cplxf* in = front_tile_convert(job, w, a, b);
+    decim_chain_range(&w->lp, in, a, job->sig_len, j0, j1, job->zeros, out);
+  } else if (job->sig) {
+    for (long long j = j0; j < j1; j++) out[j - j0] = job->sig[j * D];
+  } else {
+    for (long long j = j0; j < j1; j++) {
+      out[j - j0] = *front_tile_convert(job, w, j * D, j * D + 1);
+    }
+  }
+
+  /* Deferred DC removal and scaling of the zero-copy path (one stage) */
+  if (job->defer_dc) {
+    const float* taps = job->lp->taps[0];
+    int ntaps = job->lp->ntaps[0];
+    size_t edge = (size_t)ntaps;
+    size_t len = (size_t)job->sig_len;
+    for (long long j = j0; j < j1; j++) {
+      size_t m = (size_t)(j * D);
+      float gain = (m < edge || m + edge >= len)
+                       ? fir_overlap_gain(taps, ntaps, m, len)
+                       : job->lp_tap_sum;
+      cplxf y = cplxf_sub(out[j - j0], cplxf_mul_scalar(job->dc_fold, gain));
+      out[j - j0] = cplxf_mul_scalar(y, job->v_scale);
+    }
+  }
+}
+
+/**
+ * Fill rows [q0, q1) of the Q15 phase streams sample by sample
+ *
+ * Row q of phase p is input lo + q*D + p; inputs outside the capture are
+ * zero.
+ */
+static void front_q15_rows(const FrontTileJob* job, int16_t* pi,
+                           int16_t* pq, size_t Q, long long lo, long long q0,
+                           long long q1) {
+  int D = job->decim;
+  const int16_t* raw = (const int16_t*)job->raw;
+  for (int p = 0; p < D; p++) {
+    for (long long q = q0; q < q1; q++) {
+      size_t at = (size_t)p * Q + (size_t)q;
+      long long m = lo + q * D + p;
+      if (m >= 0 && m < job->sig_len) {
+        dsp_iq16_to_q15(raw + 2 * (size_t)m, 1, (int16_t)job->dc_i,
+                        (int16_t)job->dc_q, pi + at, pq + at, NULL);
+      } else {
+        pi[at] = 0;
+        pq[at] = 0;
+      }
+    }
+  }
+}
+
+/**
+ * Q15 low-pass and decimate samples [j0, j1) into I and Q planes
+ */
+static void front_tile_decimate_q15(const FrontTileJob* job,
+                                    FrontTileWorker* w, long long j0,
+                                    long long j1, int16_t* oi, int16_t* oq) {
+  int D = job->decim;
+  int ntaps = job->lp->ntaps[0];
+  size_t n = (size_t)(j1 - j0);
+  size_t Q = n + (size_t)((ntaps + D - 1) / D);
+  int16_t* pi = w->ph;
+  int16_t* pq = w->ph + (size_t)D * Q;
+
+  /*
+   * Phase p holds inputs lo + q*D + p. Rows [qa, qb) lie inside the
+   * capture for every phase and are converted from the capture straight
+   * into the phase streams; rows at the capture edges go one by one.
+   */
+  long long lo = j0 * D - ntaps / 2;
+  long long qa = lo < 0 ? (-lo + D - 1) / D : 0;
+  long long qb = job->sig_len - lo >= D ? (job->sig_len - lo - D) / D + 1 : 0;
+  if (qa > (long long)Q) qa = (long long)Q;
+  if (qb > (long long)Q) qb = (long long)Q;
+  if (qb < qa) qb = qa;
+  if (qb > qa) {
+    dsp_iq16_to_q15_poly((const int16_t*)job->raw + 2 * (size_t)(lo + qa * D),
+                         (size_t)(qb - qa), D, (int16_t)job->dc_i,
+                         (int16_t)job->dc_q, Q, pi + qa, pq + qa);
+  }
+  front_q15_rows(job, pi, pq, Q, lo, 0, qa);
+  front_q15_rows(job, pi, pq, Q, lo, qb, (long long)Q);
+  dsp_fir_poly_q15(pi, pq, Q, D, n, job->lp_q15, ntaps, oi, oq);
+}
+
+/**
+ * Q15 matched filter samples [k0, k1), converted to float on the way out
+ */
+static void front_tile_match_q15(const FrontTileJob* job, FrontTileWorker* w,
+                                 long long k0, long long k1, cplxf* out) {
+  size_t n = (size_t)(k1 - k0);
+  int16_t* mi = w->qmf;
+  int16_t* mq = w->qmf + job->q_cap;
+  if (job->rrc_q15) {
+    long long half = job->rrc_ntaps / 2;
+    long long lo = (long long)job->first + k0 - half;
+    long long hi = (long long)job->first + k1 - 1 - half + job->rrc_ntaps;
+    long long j0 = lo > 0 ? lo : 0;
+    long long j1 = hi < job->dec_len ? hi : job->dec_len;
+    if (j1 < j0) j1 = j0;
+
+    /* Decimated input with its halo; one extra zero for the tap pairs */
+    size_t len = (size_t)(hi - lo) + 1;
+    int16_t* di = w->qdec;
+    int16_t* dq = w->qdec + job->q_cap;
+    memset(di, 0, len * sizeof(int16_t));
+    memset(dq, 0, len * sizeof(int16_t));
+    if (j1 > j0) {
+      front_tile_decimate_q15(job, w, j0, j1, di + (j0 - lo), dq + (j0 - lo));
+    }
+    dsp_fir_poly_q15(di, dq, len, 1, n, job->rrc_q15, job->rrc_ntaps, mi, mq);
+  } else {
+    front_tile_decimate_q15(job, w, (long long)job->first + k0,
+                            (long long)job->first + k1, mi, mq);
+  }
+  dsp_q15_to_cf32(mi, mq, n, job->q15_scale, (float*)out);
+}
+
+/**
+ * Matched filter samples [k0, k1) (after the group delay trim)
+ */
+static void front_tile_match(const FrontTileJob* job, FrontTileWorker* w,
+                             long long k0, long long k1, cplxf* out) {
+  if (job->q15) {
+    front_tile_match_q15(job, w, k0, k1, out);
+  } else if (job->rrc_taps) {
+    long long half = job->rrc_ntaps / 2;
+    long long lo = (long long)job->first + k0 - half;
+    long long hi = (long long)job->first + k1 - 1 - half + job->rrc_ntaps;
+    long long j0 = lo > 0 ? lo : 0;
+    long long j1 = hi < job->dec_len ? hi : job->dec_len;
+    if (j1 > j0) front_tile_decimate(job, w, j0, j1, w->dec);
+    fir_stream_range(&w->rrc, w->dec, j1 > j0 ? j1 - j0 : 0, lo - j0,
+                     hi - j0, job->zeros, out);
+  } else {
+    front_tile_decimate(job, w, (long long)job->first + k0,
+                        (long long)job->first + k1, out);
+  }
+}
+
+/**
+ * Run one tile of outputs through every front-end stage
+ *
+ * The low-pass output the RRC needs (the tile plus its halo), and the RRC
+ * output the resampler needs, stay in per-worker scratch buffers; the AGC
+ * block powers are gathered on the way out.
+ */
+static void front_tile_task(void* ctx, size_t task, int worker) {
+  FrontTileJob* job = (FrontTileJob*)ctx;
+  FrontTileWorker* w = &job->workers[worker];
+  size_t a = task * FILTER_TILE_SAMPLES;
+  size_t b = a + FILTER_TILE_SAMPLES < job->count ? a + FILTER_TILE_SAMPLES
+                                                   : job->count;
+  cplxf* out = job->out + a;
+
+  if (job->ratio > 0.0) {
+    /* Interpolator taps around every output, zero outside the signal */
+    long long lo = (long long)floor((double)a * job->ratio) - 1;
+    long long hi = (long long)floor((double)(b - 1) * job->ratio) + 3;
+    long long k0 = lo > 0 ? lo : 0;
+    long long k1 = hi < (long long)job->mf_len ? hi : (long long)job->mf_len;
+    if (k1 < k0) k1 = k0;
+    memset(w->mf, 0, (size_t)(k0 - lo) * sizeof(cplxf));
+    if (k1 > k0) front_tile_match(job, w, k0, k1, w->mf + (k0 - lo));
+    memset(w->mf + (k1 - lo), 0, (size_t)(hi - k1) * sizeof(cplxf));
+    resample_block(w->mf, lo, job->ratio, a, b - a, out);
+  } else {
+    front_tile_match(job, w, (long long)a, (long long)b, out);
+  }
+
+  /* Power of each AGC block, while the tile is still in cache */
+  for (size_t k = a; k < b; k += AGC_BLOCK_SAMPLES) {
+    size_t cnt = b - k < AGC_BLOCK_SAMPLES ? b - k : AGC_BLOCK_SAMPLES;
+    job->blk_pwr[k / AGC_BLOCK_SAMPLES] =
+        agc_block_power(job->out + k, cnt);
+  }
+}
+
+static void front_scale_task(void* ctx, size_t task, int worker) {
+  FrontTileJob* job = (FrontTileJob*)ctx;
+  size_t a = task * FILTER_TILE_SAMPLES;
+  size_t b = a + FILTER_TILE_SAMPLES < job->count ? a + FILTER_TILE_SAMPLES
+                                                   : job->count;
+  for (size_t k = a; k < b; k += AGC_BLOCK_SAMPLES) {
+    size_t cnt = b - k < AGC_BLOCK_SAMPLES ? b - k : AGC_BLOCK_SAMPLES;
+    agc_apply(job->out + k, cnt, job->blk_gain[k / AGC_BLOCK_SAMPLES],
+              job->clip, job->out + k);
+  }
+  (void)worker;
+}
+
+/**
+ * Error of the Q15 stages against the float ones
+ *
+ * The first tile of matched filter outputs is also run through the float
+ * stages, from the same DC-free counts.
+ *
+ * @param job  Q15 job
+ * @param w    Worker state (float and Q15 scratch)
+ * @return Error power relative to the float output power (dB)
+ */
+static double front_q15_error_db(const FrontTileJob* job, FrontTileWorker* w) {
+  size_t n = job->mf_len < FILTER_TILE_SAMPLES ? job->mf_len
+                                               : FILTER_TILE_SAMPLES;
+  if (n == 0) return 0.0;
+
+  /* Every input the first n outputs can reach */
+  long long need = ((long long)job->first + (long long)n + job->rrc_ntaps) *
+                       job->decim +
+                   job->lp->ntaps[0];
+  if (need > job->sig_len) need = job->sig_len;
+  cplxf* sig = (cplxf*)malloc((size_t)need * sizeof(cplxf));
+  int16_t* cnt = (int16_t*)malloc(2 * (size_t)need * sizeof(int16_t));
+  cplxf* ref = (cplxf*)malloc(n * sizeof(cplxf));
+  cplxf* fix = (cplxf*)malloc(n * sizeof(cplxf));
+  double err = 0.0, pwr = 0.0;
+  if (sig && cnt && ref && fix) {
+    dsp_iq16_to_q15((const int16_t*)job->raw, (size_t)need,
+                    (int16_t)job->dc_i, (int16_t)job->dc_q, cnt, cnt + need,
+                    NULL);
+    for (long long k = 0; k < need; k++) {
+      sig[k] = cplxf_make((float)cnt[k] * job->v_scale,
+                          (float)cnt[need + k] * job->v_scale);
+    }
+    FrontTileJob fj = *job;
+    fj.sig = sig;
+    fj.sig_len = need;
+    fj.q15 = 0;
+    front_tile_match(&fj, w, 0, (long long)n, ref);
+    front_tile_match(job, w, 0, (long long)n, fix);
+    for (size_t k = 0; k < n; k++) {
+      err += (double)cplxf_abs2(cplxf_sub(fix[k], ref[k]));
+      pwr += (double)cplxf_abs2(ref[k]);
+    }
+  }
+  free(sig);
+  free(cnt);
+  free(ref);
+  free(fix);
+  return 10.0 * log10((err + 1e-300) / (pwr + 1e-300));
+}
+
+/**
+ * Fused whole-file front-end: low-pass, decimation, RRC, resampling and
+ * gain control
+ *
+ * Output tiles of FILTER_TILE_SAMPLES go through all stages back to back,
+ * so only the output exists at full length; each tile reads its inputs
+ * plus the filter halos, which keeps tiles independent and every output
+ * bit the same for any thread count. Without a full-length input signal
+ * each tile converts its own inputs from the mapped capture. The tiles
+ * also measure the power of their AGC blocks; the gains follow in block
+ * order (a short serial loop) and are applied in a final in-place pass
+ * over the output. That pass stays separate: a block's gain depends on
+ * every block before it, so it is only known once all earlier tiles are
+ * done.
+ *
+ * With q15 set the low-pass and RRC run in Q15 on I and Q planes and
+ * the matched filter output is converted to float per tile; with
+ * q15_check the error against the float stages is measured on the first
+ * tile.
+ *
+ * @param job       Stage parameters (sig .. out filled in by the caller)
+ * @param agc       Gain control state
+ * @param threads   Worker threads
+ * @param pwr_post  Output: sum of |v|^2 before the AGC (may be NULL)
+ */
+static void front_end_tiled(FrontTileJob* job, AgcState* agc, int threads,
+                            long double* pwr_post) {
+  size_t ntiles = (job->count + FILTER_TILE_SAMPLES - 1) / FILTER_TILE_SAMPLES;
+  if (threads < 1) threads = 1;
+  if ((size_t)threads > ntiles) threads = ntiles ? (int)ntiles : 1;
+
+  int zlen = job->rrc_ntaps;
+  for (int s = 0; job->lp && s < job->lp->nstages; s++) {
+    if (job->lp->ntaps[s] > zlen) zlen = job->lp->ntaps[s];
+  }
+  size_t mf_cap =
+      job->ratio > 0.0
+          ? (size_t)ceil(FILTER_TILE_SAMPLES * job->ratio) + 8
+          : 0;
+  size_t dec_cap = (mf_cap > FILTER_TILE_SAMPLES ? mf_cap
+                                                 : FILTER_TILE_SAMPLES) +
+                   (size_t)job->rrc_ntaps;
+  job->zeros = (const cplxf*)calloc((size_t)zlen + 1, sizeof(cplxf));
+  size_t nblk = (job->count + AGC_BLOCK_SAMPLES - 1) / AGC_BLOCK_SAMPLES;
+  job->blk_pwr = (double*)calloc(nblk + 1, sizeof(double));
+  job->blk_gain = (float*)calloc(nblk + 1, sizeof(float));
+  job->workers =
+      (FrontTileWorker*)calloc((size_t)threads, sizeof(FrontTileWorker));
+  for (int t = 0; t < threads; t++) {
+    FrontTileWorker* w = &job->workers[t];
+    if (job->lp) decim_chain_init(&w->lp, job->lp);
+    if (job->rrc_taps) {
+      fir_stream_init(&w->rrc, job->rrc_taps, job->rrc_ntaps);
+      w->dec = (cplxf*)malloc(dec_cap * sizeof(cplxf));
+    }
+    if (mf_cap) w->mf = (cplxf*)malloc(mf_cap * sizeof(cplxf));
+  }
+  if (job->q15) {
+    /* Largest matched filter request: a tile, or the resampler's input */
+    job->q_cap = (mf_cap > FILTER_TILE_SAMPLES ? mf_cap
+                                               : FILTER_TILE_SAMPLES) +
+                 (size_t)job->rrc_ntaps + 1;
+    size_t ph_cap = (size_t)job->decim * (job->q_cap + (size_t)zlen);
+    for (int t = 0; t < threads; t++) {
+      FrontTileWorker* w = &job->workers[t];
+      w->ph = (int16_t*)malloc(2 * ph_cap * sizeof(int16_t));
+      w->qdec = (int16_t*)malloc(2 * job->q_cap * sizeof(int16_t));
+      w->qmf = (int16_t*)malloc(2 * job->q_cap * sizeof(int16_t));
+    }
+  }
+
+  dsp_parallel_for(threads, ntiles, front_tile_task, job);
+  if (job->q15_check) {
+    job->q15_err_db = front_q15_error_db(job, &job->workers[0]);
+  }
+
+  long double pwr = 0.0L;
+  for (size_t k = 0; k < nblk; k++) {
+    size_t cnt = job->count - k * AGC_BLOCK_SAMPLES;
+    if (cnt > AGC_BLOCK_SAMPLES) cnt = AGC_BLOCK_SAMPLES;
+    job->blk_gain[k] = agc_block_gain(agc, job->blk_pwr[k], cnt);
+    pwr += (long double)job->blk_pwr[k];
+  }
+  if (pwr_post) *pwr_post = pwr;
+  job->clip = agc->clip;
+  dsp_parallel_for(threads, ntiles, front_scale_task, job);
+
+  for (int t = 0; t < threads; t++) {
+    FrontTileWorker* w = &job->workers[t];
+    decim_chain_free(&w->lp);
+    if (job->rrc_taps) fir_stream_free(&w->rrc);
+    free(w->in);
+    free(w->dec);
+    free(w->mf);
+    free(w->ph);
+    free(w->qdec);
+    free(w->qmf);
+  }
+  free(job->workers);
+  free(job->blk_gain);
+  free(job->blk_pwr);
+  free((void*)job->zeros);
+}
+
+/* *****************************************************************************
+ *
+ *                         SYMBOL PROCESSING - QPSK
+ *
+ * *****************************************************************************/
+
+/**
+ * QPSK hard decision slicer
+ * Maps complex symbol to nearest constellation point (±1, ±1)
+ *
+ * @param z  Input symbol
+ * @return Sliced symbol
+ */
+cplxf slicer_qpsk(cplxf z) {
+  float re = z.re >= 0 ? 1.0f : -1.0f;
+  float im = z.im >= 0 ? 1.0f : -1.0f;
+  return cplxf_make(re, im);
+}
+
+/**
+ * Convert QPSK symbol to bit string
+ *
+ * @param sym  Input symbol
+ * @param out  Output buffer (at least 3 chars)
+ */
+void qpsk_bits(cplxf sym, char* out) {
+  out[0] = sym.re >= 0 ? '1' : '0';
+  out[1] = sym.im >= 0 ? '1' : '0';
+  out[2] = '\0';
+}
+
+/**
+ * Calculate decision-directed EVM for QPSK symbols
+ *
+ * @param syms  Symbol array
+ * @param n     Number of symbols
+ * @return EVM as fraction (0.0 - 1.0)
+ */
+float evm_decision_directed_qpsk(cplxf* syms, size_t n) {
+  /* Estimate complex gain */
+  cplxf num = cplxf_make(0.0f, 0.0f);
+  float den = 0.0f;
+
+  for (size_t i = 0; i < n; i++) {
+    cplxf ref = slicer_qpsk(syms[i]);
+    num = cplxf_add(num, cplxf_mul(cplxf_conj(ref), syms[i]));
+    den += cplxf_abs2(ref);
+  }
+
+  cplxf a = cplxf_div_scalar(num, den + 1e-30f);
+
+  /* Calculate EVM */
+  float err_sum = 0.0f, ref_sum = 0.0f;
+
+  for (size_t i = 0; i < n; i++) {
+    cplxf ref = slicer_qpsk(syms[i]);
+    cplxf e = cplxf_sub(syms[i], cplxf_mul(a, ref));
+    cplxf a_ref = cplxf_mul(a, ref);
+    err_sum += cplxf_abs2(e);
+    ref_sum += cplxf_abs2(a_ref);
+  }
+
+  return sqrtf(err_sum / (ref_sum + 1e-30f));
+}
+
+/* *****************************************************************************
+ *
+ *                         SYMBOL PROCESSING - BPSK
+ *
+ * *****************************************************************************/
+
+/**
+ * BPSK hard decision slicer
+ *
+ * @param val  Input sample
+ * @return +1.0 or -1.0
+ */
+float slicer_bpsk(float val) { return val >= 0 ? 1.0f : -1.0f; }
+
+/**
+ * Convert BPSK symbol to bit character
+ *
+ * @param sym  Input symbol
+ * @return '1' or '0'
+ */
+char bpsk_bit(float sym) { return sym >= 0 ? '1' : '0'; }
+
+/**
+ * Calculate decision-directed EVM for BPSK symbols
+ *
+ * @param syms  Symbol array
+ * @param n     Number of symbols
+ * @return EVM as fraction (0.0 - 1.0)
+ */
+float evm_decision_directed_bpsk(float* syms, size_t n) {
+  /* Estimate gain */
+  float num = 0.0f, den = 0.0f;
+
+  for (size_t i = 0; i < n; i++) {
+    float ref = slicer_bpsk(syms[i]);
+    num += ref * syms[i];
+    den += ref * ref;
+  }
+
+  float a = num / (den + 1e-30f);
+
+  /* Calculate EVM */
+  float err_sum = 0.0f, ref_sum = 0.0f;
+
+  for (size_t i = 0; i < n; i++) {
+    float ref = slicer_bpsk(syms[i]);
+    float e = syms[i] - a * ref;
+    float a_ref = a * ref;
+    err_sum += e * e;
+    ref_sum += a_ref * a_ref;
+  }
+
+  return sqrtf(err_sum / (ref_sum + 1e-30f));
+}
+
+/* *****************************************************************************
+ *
+ *                         INTERPOLATION HELPERS
+ *
+ * *****************************************************************************/
+
+/**
+ * Linear interpolation for float samples
+ *
+ * @param buffer  Sample buffer
+ * @param N       Buffer length
+ * @param pos     Fractional position
+ * @return Interpolated sample
+ */
+static inline float interpolate_sample_f(const float* buffer, size_t N,
+                                         double pos) {
+  float val = 0.0f;
+
+  if (pos >= 0.0 && pos < (double)N - 1.0) {
+    size_t pi = (size_t)pos;
+    double pf = pos - (double)pi;
+    float pff = (float)pf;
+    val = buffer[pi] * (1.0f - pff) + buffer[pi + 1] * pff;
+  }
+
+  return val;
+}
+
+/**
+ * Farrow cubic interpolation for float samples
+ *
+ * Uses the resampler's cubic Lagrange kernel over the four samples around
+ * pos; falls back to linear interpolation at the buffer edges.
+ *
+ * @param buffer  Sample buffer
+ * @param N       Buffer length
+ * @param pos     Fractional position
+ * @return Interpolated sample
+ */
+static inline float interpolate_cubic_f(const float* buffer, size_t N,
+                                        double pos) {
+  if (pos >= 1.0 && pos < (double)N - 2.0) {
+    size_t pi = (size_t)pos;
+    return farrow_cubic_f(buffer + pi - 1, (float)(pos - (double)pi));
+  }
+  return interpolate_sample_f(buffer, N, pos);
+}
+
+/**
+ * Interpolate a complex sample from split I and Q planes
+ *
+ * @param win_i   I plane
+ * @param win_q   Q plane
+ * @param N       Plane length
+ * @param pos     Fractional position
+ * @param cubic   Non-zero for the Farrow cubic, zero for linear
+ * @return Interpolated sample
+ */
+static inline cplxf interpolate_planes(const float* win_i, const float* win_q,
+                                       size_t N, double pos, int cubic) {
+  if (cubic) {
+    return cplxf_make(interpolate_cubic_f(win_i, N, pos),
+                      interpolate_cubic_f(win_q, N, pos));
+  }
+  return cplxf_make(interpolate_sample_f(win_i, N, pos),
+                    interpolate_sample_f(win_q, N, pos));
+}
+
+/* *****************************************************************************
+ *
+ *                         SIGNAL LOADING AND PREPROCESSING
+ *
+ * *****************************************************************************/
+
+/**
+ * ADC count to volt scale for the configured input format
+ *
+ * @param cfg  Configuration parameters
+ * @return Volts per ADC count
+ */
+static float volts_per_count(const Config* cfg) {
+  float Vpk = cfg->fs_vpp / 2.0f;
+  if (cfg->input_format == FMT_IQ32) {
+    return Vpk / 2147483648.0f; /* 2^31 for 32-bit */
+  }
+  if (cfg->input_format == FMT_CF32) {
+    return Vpk; /* 1.0 is full scale */
+  }
+  if (cfg->input_format == FMT_CS8) {
+    return Vpk / 128.0f; /* 2^7 for 8-bit */
+  }
+  return Vpk / 32768.0f; /* 2^15 for 16-bit */
+}
+
+/**
+ * Convert raw samples to volts with DC removal (fused SIMD kernel)
+ *
+ * Conversion, DC removal, scaling and the raw power sum are done in a single
+ * pass over the input, so the block is read only once.
+ *
+ * @param raw      Raw interleaved samples
+ * @param n        Number of samples
+ * @param format   FMT_* input format
+ * @param i_dc     DC offset of I (counts)
+ * @param q_dc     DC offset of Q (counts)
+ * @param scale    Volts per count
+ * @param dst      Output: complex voltage samples
+ * @param pwr_acc  In/out: running sum of |dst|^2 (V^2, NULL to skip)
+ */
+static void iq_convert_block(const void* raw, size_t n, int format, float i_dc,
+                             float q_dc, float scale, cplxf* dst,
+                             double* pwr_acc) {
+  switch (format) {
+    case FMT_IQ32:
+      dsp_iq32_to_cf32((const int32_t*)raw, n, i_dc, q_dc, scale, (float*)dst,
+                       pwr_acc);
+      break;
+    case FMT_CF32:
+      dsp_cf32_to_cf32((const float*)raw, n, i_dc, q_dc, scale, (float*)dst,
+                       pwr_acc);
+      break;
+    case FMT_CS8:
+      dsp_iq8_to_cf32((const int8_t*)raw, n, i_dc, q_dc, scale, (float*)dst,
+                      pwr_acc);
+      break;
+    default:
+      dsp_iq16_to_cf32((const int16_t*)raw, n, i_dc, q_dc, scale, (float*)dst,
+                       pwr_acc);
+      break;
+  }
+}
+
+/**
+ * Initialize the DC removal stage
+ *
+ * @param dc   Stage to initialize
+ * @param cfg  Configuration parameters
+ */
+static void dc_block_init(DcBlock* dc, const Config* cfg) {
+  memset(dc, 0, sizeof(*dc));
+  dc->mode = cfg->dc_mode;
+  dc->format = cfg->input_format;
+  dc->scale = volts_per_count(cfg);
+  dc->mu = (double)cfg->dc_alpha;
+  if (dc->mode == DC_WINDOW) {
+    dc->win = (size_t)(cfg->dc_window > 0 ? cfg->dc_window : 1);
+    dc->ring = (double*)calloc(2 * dc->win, sizeof(double));
+    if (!dc->ring) {
+      fprintf(stderr, "Error: DC window allocation failed, using IIR\n");
+      dc->mode = DC_IIR;
+    }
+  }
+}
+
+/**
+ * Release the DC removal stage
+ * @param dc  Stage to free
+ */
+static void dc_block_free(DcBlock* dc) {
+  free(dc->ring);
+  dc->ring = NULL;
+}
+
+/**
+ * Compensated (Kahan) add of one term to a running double sum
+ */
+static inline void kahan_add(double* sum, double* comp, double x) {
+  double y = x - *comp;
+  double t = *sum + y;
+  *comp = (t - *sum) - y;
+  *sum = t;
+}
+
+/**
+ * Read sample k of an interleaved raw block
+ */
+static inline void iq_fetch(const void* raw, int format, size_t k, double* i,
+                            double* q) {
+  switch (format) {
+    case FMT_IQ32:
+      *i = ((const int32_t*)raw)[2 * k];
+      *q = ((const int32_t*)raw)[2 * k + 1];
+      break;
+    case FMT_CF32:
+      *i = ((const float*)raw)[2 * k];
+      *q = ((const float*)raw)[2 * k + 1];
+      break;
+    case FMT_CS8:
+      *i = ((const int8_t*)raw)[2 * k];
+      *q = ((const int8_t*)raw)[2 * k + 1];
+      break;
+    default:
+      *i = ((const int16_t*)raw)[2 * k];
+      *q = ((const int16_t*)raw)[2 * k + 1];
+      break;
+  }
+}
+
+/**
+ * Add a block to the global DC sums (DC_GLOBAL)
+ *
+ * Integer blocks are summed exactly in 64-bit integers, float blocks in
+ * double; each block total is folded into a compensated double sum, so the
+ * mean stays accurate for captures of any length.
+ *
+ * @param dc   DC stage
+ * @param raw  Raw interleaved samples
+ * @param n    Number of samples
+ * @param pwr  Output: sum of |raw|^2 over the block in counts^2 (NULL to
+ *             skip)
+ */
+static void dc_block_accumulate(DcBlock* dc, const void* raw, size_t n,
+                                double* pwr) {
+  double bi = 0.0, bq = 0.0, bp = 0.0;
+  if (dc->format == FMT_CF32) {
+    dsp_cf32_stats((const float*)raw, n, &bi, &bq, &bp);
+  } else {
+    int64_t si = 0, sq = 0;
+    for (size_t k = 0; k < n; k++) {
+      double xi, xq;
+      iq_fetch(raw, dc->format, k, &xi, &xq);
+      si += (int64_t)xi;
+      sq += (int64_t)xq;
+      bp += xi * xi + xq * xq;
+    }
+    bi = (double)si;
+    bq = (double)sq;
+  }
+  if (pwr) *pwr = bp;
+  kahan_add(&dc->sum_i, &dc->comp_i, bi);
+  kahan_add(&dc->sum_q, &dc->comp_q, bq);
+  dc->count += n;
+}
+
+/**
+ * Remove DC, scale to volts and accumulate raw power for one block
+ *
+ * DC_GLOBAL uses the mean of everything accumulated so far and DC_NONE no
+ * offset (fused SIMD conversion); DC_IIR and DC_WINDOW update their
+ * estimate per sample.
+ *
+ * @param dc       DC stage
+ * @param raw      Raw interleaved samples
+ * @param n        Number of samples
+ * @param dst      Output: complex voltage samples
+ * @param pwr_acc  In/out: running sum of |dst|^2 (V^2)
+ */
+static void dc_block_process(DcBlock* dc, const void* raw, size_t n,
+                             cplxf* dst, double* pwr_acc) {
+  if (n == 0) return;
+
+  if (dc->mode == DC_GLOBAL || dc->mode == DC_NONE) {
+    float i_mean = 0.0f, q_mean = 0.0f;
+    if (dc->mode == DC_GLOBAL && dc->count > 0) {
+      i_mean = (float)(dc->sum_i / (double)dc->count);
+      q_mean = (float)(dc->sum_q / (double)dc->count);
+    }
+    iq_convert_block(raw, n, dc->format, i_mean, q_mean, dc->scale, dst,
+                     pwr_acc);
+    return;
+  }
+
+  double acc = 0.0;
+  const double scale = (double)dc->scale;
+
+  if (dc->mode == DC_IIR) {
+    /* Single-pole blocker: y = x - d, d += mu * (x - d) */
+    if (!dc->primed) {
+      iq_fetch(raw, dc->format, 0, &dc->est_i, &dc->est_q);
+      dc->primed = 1;
+    }
+    for (size_t k = 0; k < n; k++) {
+      double xi, xq;
+      iq_fetch(raw, dc->format, k, &xi, &xq);
+      double ei = xi - dc->est_i;
+      double eq = xq - dc->est_q;
+      dc->est_i += dc->mu * ei;
+      dc->est_q += dc->mu * eq;
+      float re = (float)(ei * scale);
+      float im = (float)(eq * scale);
+      dst[k] = cplxf_make(re, im);
+      acc += (double)re * (double)re + (double)im * (double)im;
+    }
+  } else {
+    /* Running mean over the last win samples; integer input keeps the
+     * window sums exact, float input relies on the compensation terms */
+    for (size_t k = 0; k < n; k++) {
+      double xi, xq;
+      iq_fetch(raw, dc->format, k, &xi, &xq);
+      if (dc->fill == dc->win) {
+        kahan_add(&dc->wsum_i, &dc->wcomp_i, -dc->ring[2 * dc->head]);
+        kahan_add(&dc->wsum_q, &dc->wcomp_q, -dc->ring[2 * dc->head + 1]);
+      } else {
+        dc->fill++;
+      }
+      dc->ring[2 * dc->head] = xi;
+      dc->ring[2 * dc->head + 1] = xq;
+      if (++dc->head == dc->win) dc->head = 0;
+      kahan_add(&dc->wsum_i, &dc->wcomp_i, xi);
+      kahan_add(&dc->wsum_q, &dc->wcomp_q, xq);
+
+      double mi = dc->wsum_i / (double)dc->fill;
+      double mq = dc->wsum_q / (double)dc->fill;
+      float re = (float)((xi - mi) * scale);
+      float im = (float)((xq - mq) * scale);
+      dst[k] = cplxf_make(re, im);
+      acc += (double)re * (double)re + (double)im * (double)im;
+    }
+  }
+
+  if (pwr_acc) *pwr_acc += acc;
+}
+
+/**
+ * Open the configured input as an IQ source
+ *
+ * Live names (stdin, UDP, named pipe) open a live stream; anything else is
+ * a file, a glob pattern or a comma separated list of files read as one
+ * continuous capture. A name that exists as a file is always opened as
+ * that file, even if it contains ',' or glob characters.
+ *
+ * @param src  Source to open
+ * @param cfg  Configuration parameters
+ * @return 0 on success, -1 on error
+ */
+static int ingest_open(IqSource* src, const Config* cfg) {
+  size_t sb = format_sample_bytes(cfg->input_format);
+  int rc = iq_live_is_spec(cfg->input_file)
+               ? iq_source_open_live(src, cfg->input_file, sb)
+               : iq_source_open_files(src, cfg->input_file, sb);
+  if (rc != 0) {
+    fprintf(stderr, "Error: Cannot open input file: %s\n", cfg->input_file);
+    return -1;
+  }
+
+  size_t nfiles = iq_source_file_info(src, 0, NULL, NULL);
+  if (nfiles > 1) {
+    printf("   [INGEST] Sequence of %zu files (one continuous stream):\n",
+           nfiles);
+    for (size_t k = 0; k < nfiles; k++) {
+      const char* path;
+      uint64_t n;
+      iq_source_file_info(src, k, &path, &n);
+      printf("      %s (%llu samples)\n", path, (unsigned long long)n);
+    }
+  }
+  return 0;
+}
+
+/**
+ * Input sample rate used to convert times to sample indices
+ *
+ * @param cfg  Configuration parameters
+ * @return Sample rate in Hz (from SigMF, else Rs * sps)
+ */
+static double input_sample_rate(const Config* cfg) {
+  if (cfg->fs > 0.0f) return (double)cfg->fs;
+  return (double)cfg->rb / 2.0 * (double)cfg->sps;
+}
+
+/**
+ * Seek an open source to the configured sample range
+ *
+ * --start-time/--duration take precedence over --start-sample and
+ * --num-samples. Only the selected slice is read afterwards; a live
+ * stream drops the samples before the range and ends after it.
+ *
+ * @param src  Open source (full file or live stream)
+ * @param cfg  Configuration parameters
+ * @return 0 on success, -1 if the range starts beyond the end of the file
+ */
+static int ingest_select_range(IqSource* src, const Config* cfg) {
+  uint64_t first = cfg->start_sample;
+  uint64_t count = cfg->num_samples;
+
+  if (cfg->start_time >= 0.0 || cfg->duration >= 0.0) {
+    double fs = input_sample_rate(cfg);
+    first = cfg->start_time > 0.0 ? (uint64_t)(cfg->start_time * fs + 0.5) : 0;
+    count = cfg->duration > 0.0 ? (uint64_t)(cfg->duration * fs + 0.5) : 0;
+  }
+  if (first == 0 && count == 0) return 0;
+
+  if (src->live) {
+    if (iq_source_set_range(src, first, count) != 0) {
+      fprintf(stderr, "Error: Live stream ended before sample %llu\n",
+              (unsigned long long)first);
+      return -1;
+    }
+    printf("   [INGEST] Live range: skipped %llu samples, taking %llu "
+           "(%.3f s @ %.3e Hz, 0 = until end of stream)\n",
+           (unsigned long long)first, (unsigned long long)count,
+           (double)count / input_sample_rate(cfg), input_sample_rate(cfg));
+    return 0;
+  }
+
+  uint64_t total = src->n_samples;
+  if (iq_source_set_range(src, first, count) != 0) {
+    fprintf(stderr, "Error: Start sample %llu is beyond the end (%llu)\n",
+            (unsigned long long)first, (unsigned long long)total);
+    return -1;
+  }
+  printf("   [INGEST] Range: samples %llu..%llu of %llu (%.3f s @ %.3e Hz)\n",
+         (unsigned long long)src->first,
+         (unsigned long long)(src->first + src->n_samples),
+         (unsigned long long)total,
+         (double)src->n_samples / input_sample_rate(cfg),
+         input_sample_rate(cfg));
+  return 0;
+}
+
+/**
+ * Enable the configured read-ahead on an open source
+ *
+ * With IO_READAHEAD a reader thread keeps a ring of large buffers filled
+ * ahead of the DSP, so disk reads overlap with processing of the previous
+ * blocks. Buffers hold a whole number of blocks, so the consumer sees the
+ * same block boundaries as with mapped reads. Falls back to mapped reads
+ * if the ring cannot be set up.
+ *
+ * @param src            Open source
+ * @param cfg            Configuration parameters
+ * @param block_samples  Samples the consumer asks for per call
+ */
+static void ingest_setup_io(IqSource* src, const Config* cfg,
+                            size_t block_samples) {
+  if (cfg->io_mode != IO_READAHEAD) return;
+
+  size_t block_bytes = block_samples * src->sample_bytes;
+  size_t nblocks = IQ_SOURCE_READAHEAD_BYTES / block_bytes;
+  size_t buf_bytes = (nblocks > 0 ? nblocks : 1) * block_bytes;
+
+  if (iq_source_readahead(src, IQ_SOURCE_READAHEAD_BUFS, buf_bytes) != 0) {
+    printf("   [INGEST] Read-ahead unavailable, using mapped reads\n");
+    return;
+  }
+  printf("   [INGEST] Read-ahead thread: %d x %.1f MB buffers\n",
+         IQ_SOURCE_READAHEAD_BUFS, (double)buf_bytes / (1 << 20));
+}
+
+/**
+ * Load IQ file and apply preprocessing chain
+ *
+ * Processing steps:
+ *   1. Map raw IQ samples (no intermediate copies)
+ *   2. Remove DC offset
+ *   3. Scale to voltage
+ *   4. Optional low-pass filtering
+ *   5. Decimation
+ *   6. Optional RRC matched filtering
+ *   7. Normalize amplitude
+ *
+ * Steps 4-7 run fused, tile by tile (see front_end_tiled()); with a
+ * global or no DC estimate steps 2-3 run in the tiles too.
+ *
+ * @param cfg        Configuration parameters
+ * @param out_len    Output: number of samples after processing
+ * @param final_sps  Output: effective samples per symbol
+ * @return Processed signal array (caller must free)
+ */
+cplxf* load_and_process(Config* cfg, size_t* out_len, float* final_sps,
+                        double* pwr_raw_w, double* pwr_post_w){
+
+  if (pwr_raw_w) *pwr_raw_w = 0.0;
+  if (pwr_post_w) *pwr_post_w = 0.0;
+  printf("--- STEP 1: LOADING & DECIMATION ---\n");
+
+  /* Map input file */
+  IqSource src;
+  if (ingest_open(&src, cfg) != 0) return NULL;
+
+  if (ingest_select_range(&src, cfg) != 0) {
+    iq_source_close(&src);
+    return NULL;
+  }
+
+  size_t n_samples = (size_t)src.n_samples;
+  if (n_samples == 0) {
+    fprintf(stderr, "Error: No complete IQ samples in: %s\n",
+            cfg->input_file);
+    iq_source_close(&src);
+    return NULL;
+  }
+  printf("   Mapped %zu IQ samples (%s format, %s kernels)\n", n_samples,
+         format_name(cfg->input_format), dsp_simd_level());
+
+  const void* raw;
+  size_t got;
+  double sum_v2 = 0.0;
+  DcBlock dc;
+  dc_block_init(&dc, cfg);
+
+  /*
+   * Mapped capture with a global (or no) DC estimate: one read-only pass
+   * gathers the DC and raw power sums, then every filter tile converts its
+   * own inputs (with the filter halos) straight from the mapping, so the
+   * capture is never copied at full length. The IIR and windowed blockers
+   * run sequentially over the whole capture and convert it up front, as
+   * does a capture that cannot be mapped in one piece (a file sequence),
+   * unless the Q15 stages only need its counts in memory.
+   *
+   * Zero-copy cf32: the mapped samples are fed to the low-pass filter as
+   * they are. DC removal and volt scaling are linear, so they are applied
+   * to the filter output at decimation time instead of to every input
+   * sample (single-stage low-pass only).
+   */
+  const void* map = NULL;
+  const cplxf* sig_in = NULL;
+  cplxf dc_fold = cplxf_make(0.0f, 0.0f);
+  if (dc.mode == DC_GLOBAL || dc.mode == DC_NONE) {
+    map = iq_source_map_all(&src);
+  }
+#if ENABLE_LOWPASS
+  if (map && cfg->input_format == FMT_CF32 && cfg->decim < DECIM_CHAIN_MIN) {
+    sig_in = (const cplxf*)map;
+  }
+#endif
+
+  /*
+   * Q15 front-end: IQ16 counts stay 16-bit (separate I and Q planes)
+   * through DC removal, the low-pass and the RRC, and become float only
+   * at the loop input (single-stage low-pass, global or no DC estimate)
+   */
+  int use_q15 = 0;
+#if ENABLE_LOWPASS
+  if (cfg->q15) {
+    use_q15 = cfg->input_format == FMT_IQ16 &&
+              cfg->decim < DECIM_CHAIN_MIN &&
+              (dc.mode == DC_GLOBAL || dc.mode == DC_NONE);
+    if (!use_q15) {
+      printf("   [Q15] Needs IQ16 input, global or no DC removal and "
+             "decimation below %d - using float\n", DECIM_CHAIN_MIN);
+    }
+  }
+#endif
+
+  /*
+   * Q15 on a capture that cannot be mapped in one piece: its counts are
+   * read into memory as they are and then stand in for the mapping
+   */
+  int16_t* sig_q15 = NULL;
+  if (use_q15 && !map) {
+    ingest_setup_io(&src, cfg, INGEST_BLOCK_SAMPLES);
+    sig_q15 = (int16_t*)malloc(n_samples * src.sample_bytes);
+    if (!sig_q15) {
+      fprintf(stderr, "Error: Memory allocation failed\n");
+      dc_block_free(&dc);
+      iq_source_close(&src);
+      return NULL;
+    }
+    size_t filled = 0;
+    while ((got = iq_source_next(&src, INGEST_BLOCK_SAMPLES, &raw)) > 0) {
+      memcpy((char*)sig_q15 + filled * src.sample_bytes, raw,
+             got * src.sample_bytes);
+      filled += got;
+    }
+    int read_failed = iq_source_error(&src);
+    iq_source_close(&src);
+    if (read_failed) {
+      fprintf(stderr, "Error: Reading %s failed\n", cfg->input_file);
+      free(sig_q15);
+      dc_block_free(&dc);
+      return NULL;
+    }
+    map = sig_q15;
+  }
+
+  cplxf* sig_v = NULL;
+  float dc_i = 0.0f, dc_q = 0.0f;
+  if (map) {
+    /* Single read-only pass: DC and raw power statistics */
+    double sum_p = 0.0, comp_p = 0.0;
+    for (size_t k = 0; k < n_samples; k += INGEST_BLOCK_SAMPLES) {
+      size_t cnt = n_samples - k;
+      if (cnt > INGEST_BLOCK_SAMPLES) cnt = INGEST_BLOCK_SAMPLES;
+      double bp = 0.0;
+      dc_block_accumulate(&dc, (const char*)map + k * src.sample_bytes, cnt,
+                          &bp);
+      kahan_add(&sum_p, &comp_p, bp);
+    }
+    double mi = 0.0, mq = 0.0;
+    if (dc.mode == DC_GLOBAL) {
+      mi = dc.sum_i / (double)n_samples;
+      mq = dc.sum_q / (double)n_samples;
+    }
+    if (use_q15) {
+      /* DC to the nearest count */
+      dc_i = (float)floor(mi + 0.5);
+      dc_q = (float)floor(mq + 0.5);
+    } else {
+      dc_i = (float)mi;
+      dc_q = (float)mq;
+    }
+    dc_fold = cplxf_make(dc_i, dc_q);
+
+    double s2 = (double)dc.scale * (double)dc.scale;
+    double ac = sum_p / (double)n_samples - (mi * mi + mq * mq);
+    sum_v2 = s2 * (ac > 0.0 ? ac : 0.0) * (double)n_samples;
+    if (sig_in) {
+      printf("   [INGEST] CF32 capture filtered in place (zero-copy)\n");
+    } else if (sig_q15) {
+      printf("   [INGEST] Capture read into memory, converted per filter "
+             "tile\n");
+    } else {
+      printf("   [INGEST] Capture converted per filter tile (no full-rate "
+             "copy)\n");
+    }
+  } else {
+    ingest_setup_io(&src, cfg, INGEST_BLOCK_SAMPLES);
+
+    /*
+     * Pass 1 (global DC mean only): exact block sums read straight from the
+     * input blocks. The IIR and windowed blockers need no extra pass.
+     */
+    if (dc.mode == DC_GLOBAL) {
+      while ((got = iq_source_next(&src, INGEST_BLOCK_SAMPLES, &raw)) > 0) {
+        dc_block_accumulate(&dc, raw, got, NULL);
+      }
+      if (iq_source_error(&src)) {
+        fprintf(stderr, "Error: Reading %s failed\n", cfg->input_file);
+        dc_block_free(&dc);
+        iq_source_close(&src);
+        return NULL;
+      }
+      iq_source_rewind(&src);
+    }
+
+    /*
+     * Pass 2: remove DC, scale and measure raw power in one fused pass,
+     * converting from the input blocks directly into the first filter
+     * stage's input buffer
+     */
+    sig_v = (cplxf*)malloc(n_samples * sizeof(cplxf));
+    if (!sig_v) {
+      fprintf(stderr, "Error: Memory allocation failed\n");
+      dc_block_free(&dc);
+      iq_source_close(&src);
+      return NULL;
+    }
+
+    size_t filled = 0;
+    while ((got = iq_source_next(&src, INGEST_BLOCK_SAMPLES, &raw)) > 0) {
+      dc_block_process(&dc, raw, got, sig_v + filled, &sum_v2);
+      filled += got;
+    }
+    int read_failed = iq_source_error(&src);
+    iq_source_close(&src);
+    if (read_failed) {
+      fprintf(stderr, "Error: Reading %s failed\n", cfg->input_file);
+      free(sig_v);
+      dc_block_free(&dc);
+      return NULL;
+    }
+  }
+  float v_scale = dc.scale;
+  dc_block_free(&dc);
+
+  // ---- RAW POWER (before any filtering/decim/normalize) ----
+  if (pwr_raw_w && cfg->rload > 0.0f) {
+    *pwr_raw_w = sum_v2 / (double)n_samples / (double)cfg->rload;
+  }
+  /* Optional low-pass filtering */
+
+  DecimDesign lpd;
+  memset(&lpd, 0, sizeof(lpd));
+#if ENABLE_LOWPASS
+  decim_design(&lpd, cfg->decim);
+  decim_design_print(&lpd);
+#else
+  printf("   [FILTER] Low-pass disabled - skipping\n");
+#endif
+
+  /* Decimating low-pass: only the outputs that are kept get computed */
+  size_t out_samples = n_samples;
+  if (cfg->decim > 1) {
+    out_samples = n_samples / (size_t)cfg->decim;
+    *final_sps = cfg->sps / cfg->decim;
+    printf("   [DECIMATION] Factor: %d | New SPS: %.4f\n", cfg->decim,
+           *final_sps);
+  } else {
+    *final_sps = cfg->sps;
+  }
+
+  FrontTileJob job;
+  memset(&job, 0, sizeof(job));
+  job.sig = map ? sig_in : sig_v;
+  job.raw = map;
+  job.format = cfg->input_format;
+  job.sample_bytes = src.sample_bytes;
+  job.dc_i = dc_i;
+  job.dc_q = dc_q;
+  job.sig_len = (long long)n_samples;
+  job.lp = lpd.nstages ? &lpd : NULL;
+  job.decim = cfg->decim > 1 ? cfg->decim : 1;
+  job.dec_len = (long long)out_samples;
+  job.count = out_samples;
+
+  /* Deferred DC removal and scaling of the zero-copy path */
+  job.defer_dc = sig_in != NULL;
+  job.dc_fold = dc_fold;
+  job.v_scale = v_scale;
+  for (int k = 0; sig_in && k < lpd.ntaps[0]; k++) {
+    job.lp_tap_sum += lpd.taps[0][k];
+  }
+
+  /* Q15 stages: taps scaled to Q15, their gains folded into one scale */
+  int16_t* lp_q15 = NULL;
+  int16_t* rrc_q15 = NULL;
+  if (use_q15) {
+    lp_q15 = (int16_t*)malloc((size_t)lpd.ntaps[0] * sizeof(int16_t));
+    job.q15 = 1;
+    job.q15_check = cfg->q15_check;
+    job.lp_q15 = lp_q15;
+    job.q15_scale = v_scale * dsp_q15_taps(lpd.taps[0], lpd.ntaps[0], lp_q15);
+  }
+
+  /* Optional RRC matched filtering */
+  float* rrc = NULL;
+  if (cfg->rrc_enable) {
+    float Rs = cfg->rb / 2.0f;
+    float Fs_dec = (Rs * cfg->sps) / cfg->decim;
+    int rrc_ntaps;
+    rrc = rrc_taps(Fs_dec, Rs, cfg->rrc_alpha, cfg->rrc_span, &rrc_ntaps);
+    printf("   [FILTER] RRC matched filter - Taps: %d (%s)\n", rrc_ntaps,
+           fir_method_name(rrc, rrc_ntaps, 1));
+    job.rrc_taps = rrc;
+    job.rrc_ntaps = rrc_ntaps;
+    if (use_q15) {
+      rrc_q15 = (int16_t*)malloc((size_t)rrc_ntaps * sizeof(int16_t));
+      job.rrc_q15 = rrc_q15;
+      job.q15_scale *= dsp_q15_taps(rrc, rrc_ntaps, rrc_q15);
+    }
+
+    /* Trimming the group delay just starts the outputs gd samples later */
+    size_t gd = cfg->rrc_trim_delay ? (size_t)((rrc_ntaps - 1) / 2) : 0;
+    if (gd > out_samples) gd = out_samples;
+    job.first = gd;
+    job.count = out_samples - gd;
+  }
+
+  /* Optional resampling to the loop SPS */
+  job.mf_len = job.count;
+  job.ratio = resample_setup(cfg, final_sps);
+  if (job.ratio > 0.0) job.count = resample_count(job.mf_len, job.ratio);
+
+  /* All stages in one pass over L2-sized tiles, spread over the threads */
+  size_t final_len = job.count;
+  cplxf* sig_out = (cplxf*)malloc((final_len ? final_len : 1) * sizeof(cplxf));
+  if (!sig_out) {
+    fprintf(stderr, "Error: Memory allocation failed\n");
+  } else {
+    job.out = sig_out;
+    long double pwr_acc = 0.0L;
+    AgcState agc;
+    agc_init(&agc, cfg);
+    front_end_tiled(&job, &agc, cfg->threads, &pwr_acc);
+    agc_free(&agc);
+    if (job.q15_check) {
+      printf("   [Q15] Fixed-point low-pass%s | Error vs float: %.1f dB\n",
+             job.rrc_q15 ? " and RRC" : "", job.q15_err_db);
+    } else if (job.q15) {
+      printf("   [Q15] Fixed-point low-pass%s\n",
+             job.rrc_q15 ? " and RRC" : "");
+    }
+    if (pwr_post_w && final_len && cfg->rload > 0.0f) {
+      *pwr_post_w = (double)(pwr_acc / (long double)final_len /
+                             (long double)cfg->rload);
+    }
+  }
+
+  if (sig_q15) {
+    free(sig_q15);
+  } else if (map) {
+    iq_source_close(&src);
+  } else {
+    free(sig_v);
+  }
+  decim_design_free(&lpd);
+  free(rrc);
+  free(lp_q15);
+  free(rrc_q15);
+  if (!sig_out) return NULL;
+
+  *out_len = final_len;
+  return sig_out;
+}
+
+/* *****************************************************************************
+ *
+ *                         BIT/BYTE CONVERSION UTILITIES
+ *
+ * *****************************************************************************/
+
+/**
+ * Convert packed bytes to unpacked bits (MSB first)
+ *
+ * @param input      Input byte array
+ * @param output     Output bit array
+ * @param byteCount  Number of bytes to convert
+ */
+void bytesToBits(const unsigned char* input, unsigned char* output,
+                 size_t byteCount) {
+  for (size_t i = 0; i < byteCount; i++) {
+    for (int j = 0; j < 8; j++) {
+      output[i * 8 + (7 - j)] = (input[i] >> j) & 1;
+    }
+  }
+}
+
+/**
+ * Convert unpacked bits to packed bytes (MSB first)
+ *
+ * @param input     Input bit array
+ * @param output    Output byte array
+ * @param bitCount  Number of bits to convert
+ */
+void bitsToBytes(const unsigned char* input, unsigned char* output,
+                 size_t bitCount) {
+  for (size_t i = 0; i < (bitCount / 8); i++) {
+    output[i] = 0;
+    for (int j = 0; j < 8; j++) {
+      output[i] |= ((int)input[i * 8 + j]) << (7 - j);
+    }
+  }
+}
+
+/* *****************************************************************************
+ *
+ *                         UDP STREAMING
+ *
+ * *****************************************************************************/
+
+#if ENABLE_UDP_SENDER
+/**
+ * Send demodulated bits via UDP (unpacked format: 0x01/0x00)
+ *
+ * @param bits        Bit array to send
+ * @param total_bits  Total number of bits
+ * @param host        Destination IP address
+ * @param port        Destination UDP port
+ * @param chunk_size  Bytes per UDP packet
+ * @return 0 on success, -1 on error
+ */
+int udp_send_unpacked_bits(const unsigned char* bits, size_t total_bits,
+                           const char* host, int port, size_t chunk_size) {
+#ifdef _WIN32
+  WSADATA wsa;
+  SOCKET sock;
+  if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+    fprintf(stderr, "[UDP] WSAStartup failed\n");
+    return -1;
+  }
+#else
+  int sock;
+#endif
+
+  struct sockaddr_in dest_addr;
+
+  /* Create socket */
+#ifdef _WIN32
+  sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock == INVALID_SOCKET) {
+    fprintf(stderr, "[UDP] Socket creation failed\n");
+    WSACleanup();
+    return -1;
+  }
+#else
+  sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0) {
+    fprintf(stderr, "[UDP] Socket creation failed\n");
+    return -1;
+  }
+#endif
+
+  /* Setup destination address */
+  memset(&dest_addr, 0, sizeof(dest_addr));
+  dest_addr.sin_family = AF_INET;
+  dest_addr.sin_port = htons(port);
+
+#ifdef _WIN32
+  dest_addr.sin_addr.S_un.S_addr = inet_addr(host);
+#else
+  inet_pton(AF_INET, host, &dest_addr.sin_addr);
+#endif
+
+  printf("\n--- UDP SENDER ---\n");
+  printf("   Destination: %s:%d\n", host, port);
+  printf("   Chunk size: %zu bytes (unpacked)\n", chunk_size);
+  printf("   Total bits: %zu\n", total_bits);
+
+  /* Allocate send buffer */
+  unsigned char* unpacked_buffer = (unsigned char*)malloc(chunk_size);
+  if (!unpacked_buffer) {
+    fprintf(stderr, "[UDP] Memory allocation failed\n");
+#ifdef _WIN32
+    closesocket(sock);
+    WSACleanup();
+#else
+    close(sock);
+#endif
+    return -1;
+  }
+
+  size_t total_sent = 0;
+  size_t packet_count = 0;
+
+  /* Send loop */
+  for (size_t i = 0; i < total_bits; i += chunk_size) {
+    size_t bits_to_send =
+        (i + chunk_size <= total_bits) ? chunk_size : (total_bits - i);
+
+    /* Convert bits to unpacked bytes (0x01 or 0x00) */
+    for (size_t j = 0; j < bits_to_send; j++) {
+      unpacked_buffer[j] = bits[i + j] ? 0x01 : 0x00;
+    }
+
+    /* Send UDP packet */
+    int sent = sendto(sock, (const char*)unpacked_buffer, (int)bits_to_send, 0,
+                      (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+
+    if (sent < 0) {
+      fprintf(stderr, "[UDP] Send failed on packet %zu\n", packet_count);
+    } else {
+      total_sent += sent;
+      packet_count++;
+      if (packet_count % 100 == 0) {
+        printf("   Sent %zu packets, %zu bytes\n", packet_count, total_sent);
+      }
+    }
+
+    /* Inter-packet delay */
+#ifdef _WIN32
+    Sleep(UDP_DELAY_MS);
+#else
+    usleep(UDP_DELAY_MS * 1000);
+#endif
+  }
+
+  printf("   COMPLETE: %zu packets, %zu bytes sent\n", packet_count,
+         total_sent);
+
+  free(unpacked_buffer);
+
+#ifdef _WIN32
+  closesocket(sock);
+  WSACleanup();
+#else
+  close(sock);
+#endif
+
+  return 0;
+}
+#endif /* ENABLE_UDP_SENDER */
+
+/* *****************************************************************************
+ *
+ *                         BLIND PROCESSING CHAIN
+ *
+ * *****************************************************************************/
+
+/**
+ * Apply blind processing chain: Viterbi -> NRZ-M -> PSR
+ *
+ * @param in       Input bit array (unpacked)
+ * @param out      Output bit array (unpacked)
+ * @param in_len   Number of input bits
+ * @return Number of output bits, or -1 on error
+ */
+int process_blind(const unsigned char* in, unsigned char* out, int in_len) {
+  int current_len = in_len;
+
+  /* Allocate working buffers */
+  unsigned char* temp1 = (unsigned char*)malloc(in_len);
+  unsigned char* temp2 = (unsigned char*)malloc(in_len);
+  unsigned char* current = (unsigned char*)malloc(in_len);
+
+  if (!temp1 || !temp2 || !current) {
+    printf("Error: Memory allocation failed\n");
+    free(temp1);
+    free(temp2);
+    free(current);
+    return -1;
+  }
+
+  memcpy(current, in, in_len);
+
+  /* Stage 1: Convolutional (Viterbi) decoding */
+#if ENABLE_CONVOLUTION
+  printf("  [CONV] Enabled - decoding...\n");
+  int packed_len = current_len / 8;
+  unsigned char* packed_input = (unsigned char*)malloc(packed_len);
+  unsigned char* conv_output = (unsigned char*)malloc(packed_len / 2);
+  bitsToBytes(current, packed_input, current_len);
+  convolutional_decode_viterbi(packed_input, conv_output, packed_len);
+  current_len = packed_len / 2;
+  memcpy(temp1, conv_output, current_len);
+  free(packed_input);
+  free(conv_output);
+#else
+  printf("  [CONV] Disabled - skipping\n");
+  bitsToBytes(current, temp1, current_len);
+  current_len = current_len / 8;
+#endif
+
+  /* Stage 2: NRZ-M differential decoding */
+#if ENABLE_NRZM
+  printf("  [NRZM] Enabled - decoding...\n");
+  nrzm_decode(temp1, temp2, current_len, 0);
+  memcpy(temp1, temp2, current_len);
+#else
+  printf("  [NRZM] Disabled - skipping\n");
+#endif
+
+  /* Stage 3: PSR (pseudo-random) descrambling */
+#if ENABLE_PSR
+  printf("  [PSR]  Enabled - descrambling...\n");
+#ifdef __cplusplus
+  Scrambler s;
+  s.Scramble(&temp1[4]);
+#else
+  printf("  [PSR]  Warning: PSR requires C++, skipping...\n");
+#endif
+#else
+  printf("  [PSR]  Disabled - skipping\n");
+#endif
+
+  /* Convert back to bits */
+  int out_len = current_len * 8;
+  bytesToBits(temp1, out, current_len);
+
+  free(temp1);
+  free(temp2);
+  free(current);
+
+  return out_len;
+}
+
+/* *****************************************************************************
+ *
+ *                         FRAME SYNC & REED-SOLOMON DECODE
+ *
+ * *****************************************************************************/
+
+/* CCSDS sync word: 0x1ACFFC1D in bit form (MSB first) */
+static const unsigned char sync_pattern[SYNC_BITS] = {
+    0, 0, 0, 1, 1, 0, 1, 0, /* 0x1A */
+    1, 1, 0, 0, 1, 1, 1, 1, /* 0xCF */
+    1, 1, 1, 1, 1, 1, 0, 0, /* 0xFC */
+    0, 0, 0, 1, 1, 1, 0, 1  /* 0x1D */
+};
+
+/**
+ * Initialize frame sync state
+ * @param fs  State to initialize
+ */
+static void frame_sync_init(FrameSync* fs) {
+  memset(fs, 0, sizeof(*fs));
+}
+
+/**
+ * Release frame sync buffers
+ * @param fs  State to free
+ */
+static void frame_sync_free(FrameSync* fs) {
+  free(fs->bits);
+  fs->bits = NULL;
+  fs->len = fs->capacity = 0;
+}
+
+/**
+ * Descramble and RS-decode one frame, printing the TM frame on success
+ *
+ * @param fs          Frame sync state (counters)
+ * @param frame_bits  FRAME_SIZE_BITS bits starting at the sync word
+ */
+static void frame_sync_decode(FrameSync* fs, const unsigned char* frame_bits) {
+  /* Pack bits to bytes (1279 bytes = 10232 bits) */
+  unsigned char frame_bytes[FRAME_SIZE_BYTES];
+  bitsToBytes(frame_bits, frame_bytes, FRAME_SIZE_BITS);
+
+  /* Create working buffer for RS decode */
+  unsigned char tempBuffer[FRAME_SIZE_BYTES];
+  memcpy(tempBuffer, frame_bytes, FRAME_SIZE_BYTES);
+
+  /* Descramble (skip first 4 bytes - sync word) */
+#ifdef __cplusplus
+  Scrambler s;
+  s.Scramble(&tempBuffer[4]);
+#endif
+
+  /* Reed-Solomon decode */
+  int msgSize = FRAME_SIZE_BYTES;
+  int error_counter_rs = ccsds_decode_rs(tempBuffer, msgSize);
+
+  if (error_counter_rs == fs->last_error_counter_rs) {
+    /* RS decode successful */
+    msgSize -= 4; /* Remove sync word (4 bytes) */
+
+    unsigned char TM_Frame_buffer[FRAME_SIZE_BYTES];
+    memmove(TM_Frame_buffer, tempBuffer + 4, msgSize);
+
+    msgSize -= 160; /* Remove RS parity bytes (160 bytes for interleave=5) */
+
+    printf(" - RS OK, TM size = %d bytes\n", msgSize);
+
+    /* Print the entire TM frame in hex */
+    printf("================== TM FRAME %d ==================\n",
+           fs->tm_ok_count + 1);
+    for (int i = 0; i < msgSize; i++) {
+      printf("%02X ", TM_Frame_buffer[i]);
+      if ((i + 1) % 32 == 0) {
+        printf("\n");
+      }
+    }
+    if (msgSize % 32 != 0) {
+      printf("\n");
+    }
+    printf("================================================\n\n");
+
+    fs->tm_ok_count++;
+  } else {
+    fs->last_error_counter_rs = error_counter_rs;
+    printf(" - RS FAILED (errors=%d)\n", error_counter_rs);
+    fs->tm_bad_count++;
+  }
+}
+
+/**
+ * Search a bit array for sync words and decode every complete frame
+ *
+ * A QPSK Costas loop may lock a quarter turn off, which NRZ-M decoding
+ * leaves as a complemented bit stream, so the complemented sync word also
+ * starts a frame and the frame is complemented before decoding.
+ *
+ * @param fs     Frame sync state (counters)
+ * @param bits   Bit array (unpacked)
+ * @param len    Number of bits
+ * @param base   Stream index of bits[0] (for reporting)
+ * @param final  Non-zero if no more bits will follow
+ * @return Index of the first bit that still has to be searched
+ */
+static size_t frame_sync_scan(FrameSync* fs, const unsigned char* bits,
+                              size_t len, size_t base, int final) {
+  size_t offset = 0;
+
+  while (offset + FRAME_SIZE_BITS <= len) {
+    /* Find sync word */
+    size_t sync_found = 0;
+    int found = 0;
+    unsigned char inv = 0;
+    for (size_t i = offset; i + FRAME_SIZE_BITS <= len; i++) {
+      unsigned char x = bits[i] ^ sync_pattern[0];
+      int match = 1;
+      for (int j = 1; j < SYNC_BITS && match; j++) {
+        if ((bits[i + j] ^ sync_pattern[j]) != x) {
+          match = 0;
+        }
+      }
+      if (match) {
+        sync_found = i;
+        found = 1;
+        inv = x;
+        break;
+      }
+    }
+
+    if (!found) {
+      if (final) printf("No more sync words found.\n");
+      /* Every start position up to here has been checked */
+      offset = len - FRAME_SIZE_BITS + 1;
+      break;
+    }
+
+    fs->frame_count++;
+    printf("Frame %d: Sync at bit %zu%s", fs->frame_count, base + sync_found,
+           inv ? " (inverted)" : "");
+
+    if (inv) {
+      unsigned char frame_bits[FRAME_SIZE_BITS];
+      for (size_t k = 0; k < FRAME_SIZE_BITS; k++) {
+        frame_bits[k] = bits[sync_found + k] ^ 1;
+      }
+      frame_sync_decode(fs, frame_bits);
+    } else {
+      frame_sync_decode(fs, &bits[sync_found]);
+    }
+
+    /* Move to next potential frame */
+    offset = sync_found + FRAME_SIZE_BITS;
+  }
+
+  return offset;
+}
+
+/**
+ * Append bits to the frame sync buffer and decode all frames they complete
+ *
+ * Bits that may still hold the start of a frame are kept for the next call,
+ * so frames spanning block boundaries are found exactly as in a single scan.
+ *
+ * @param fs     Frame sync state
+ * @param bits   New bits (unpacked)
+ * @param n      Number of new bits
+ * @param final  Non-zero if no more bits will follow
+ */
+static void frame_sync_push(FrameSync* fs, const unsigned char* bits, size_t n,
+                            int final) {
+  if (fs->len + n > fs->capacity) {
+    size_t cap = fs->capacity ? fs->capacity : (size_t)FRAME_SIZE_BITS * 2;
+    while (cap < fs->len + n) cap *= 2;
+    fs->bits = (unsigned char*)realloc(fs->bits, cap);
+    fs->capacity = cap;
+  }
+  memcpy(fs->bits + fs->len, bits, n);
+  fs->len += n;
+
+  size_t consumed = frame_sync_scan(fs, fs->bits, fs->len, fs->base, final);
+  if (consumed > fs->len) consumed = fs->len;
+
+  memmove(fs->bits, fs->bits + consumed, fs->len - consumed);
+  fs->len -= consumed;
+  fs->base += consumed;
+}
+
+/**
+ * Print frame processing summary
+ * @param fs  Frame sync state
+ */
+static void frame_sync_summary(const FrameSync* fs) {
+  printf("\n--- FRAME PROCESSING SUMMARY ---\n");
+  printf("Frames found:  %d\n", fs->frame_count);
+  printf("TM OK:         %d\n", fs->tm_ok_count);
+  printf("TM BAD:        %d\n", fs->tm_bad_count);
+  printf("Success rate:  %.1f%%\n",
+         fs->frame_count > 0 ? (100.0f * fs->tm_ok_count / fs->frame_count)
+                             : 0.0f);
+}
+
+/* *****************************************************************************
+ *
+ *                         EVM / ENERGY REPORT
+ *
+ * *****************************************************************************/
+
+/**
+ * Print EVM and the derived energy / noise estimates
+ *
+ * @param cfg         Configuration parameters
+ * @param evm         Decision-directed EVM (fraction)
+ * @param pwr_post_w  Measured power after filtering (W)
+ */
+static void report_evm(const Config* cfg, float evm, double pwr_post_w) {
+  printf("\n=== EVM (%s) ===\n", cfg->modulation == MOD_BPSK ? "BPSK" : "OQPSK");
+  printf("EVM: %.4f%% (%.2f dB)\n", evm * 100.0f,
+         20.0f * log10f(evm + 1e-30f));
+  printf("SNR(rough): ~%.2f dB\n", -20.0f * log10f(evm + 1e-30f));
+
+  // ================= ENERGY / NOISE REPORT =================
+  {
+    const double bits_per_sym = (cfg->modulation == MOD_BPSK) ? 1.0 : 2.0;
+
+    // Bu kod tabanında cfg.rb pratikte "bit rate" gibi kullanılıyor (RRC'de
+    // rb/2 yapılmış).
+    const double Rb = (double)cfg->rb;    // bit/s
+    const double Rs = Rb / bits_per_sym;  // sym/s
+
+    const double alpha = (cfg->rrc_enable ? (double)cfg->rrc_alpha : 0.0);
+    const double Bocc =
+        Rs * (1.0 + alpha);  // Hz (two-sided, sizin eski çıktınızla uyumlu)
+
+    // EVM -> Es/N0 varsayımı (AWGN + iyi lock + iyi eşitleme varsayımı)
+    const double evm2 = (double)evm * (double)evm + 1e-30;
+    const double EsN0 = 1.0 / evm2;
+    const double EbN0 = EsN0 / bits_per_sym;
+
+    // Eb/N0 ile in-band SNR ilişkisi: SNR = (Eb/N0) * (Rb / Bocc)
+    const double SNR_lin = EbN0 * (Rb / (Bocc + 1e-30));
+
+    // Ölçtüğünüz toplam güçten (post) Psig ve Pn'i ayır (yaklaşık)
+    const double Ptot = pwr_post_w;
+    const double Psig = Ptot * (SNR_lin / (1.0 + SNR_lin));
+    const double Pn_inband = Ptot * (1.0 / (1.0 + SNR_lin));
+
+    // Enerjiler
+    const double Eb = Psig / (Rb + 1e-30);  // J/bit
+    const double Es = Psig / (Rs + 1e-30);  // J/sym
+
+    // Noise spectral density
+    const double N0 = Pn_inband / (Bocc + 1e-30);  // W/Hz (== J)
+
+    printf("\n=== ENERGY / NOISE (est.) ===\n");
+    printf("Rb            : %.3e bit/s\n", Rb);
+    printf("Rs            : %.3e sym/s\n", Rs);
+    printf("Bocc (est)    : %.3e Hz  (alpha=%.2f)\n", Bocc, alpha);
+
+    printf("Psig_post (est): %.6e W (%.2f dBm)\n", Psig, watt_to_dbm(Psig));
+    printf("Pn_inband (est): %.6e W (%.2f dBm)\n", Pn_inband,
+           watt_to_dbm(Pn_inband));
+    printf("N0 (est)      : %.6e W/Hz (%.2f dBm/Hz)\n", N0,
+           w_per_hz_to_dbm_per_hz(N0));
+
+    printf("Eb            : %.6e J/bit\n", Eb);
+    printf("Es            : %.6e J/sym\n", Es);
+
+    printf("Es/N0         : %.2f dB\n", 10.0 * log10(EsN0 + 1e-30));
+    printf("Eb/N0         : %.2f dB\n", 10.0 * log10(EbN0 + 1e-30));
+    printf("SNR_inband    : %.2f dB\n", 10.0 * log10(SNR_lin + 1e-30));
+  }
+}
+
+/* *****************************************************************************
+ *
+ *                         CARRIER NCO
+ *
+ * *****************************************************************************/
+
+/* cos/sin of k/NCO_LUT_SIZE turns, one extra entry for interpolation */
+static cplxf nco_lut[NCO_LUT_SIZE + 1];
+
+/**
+ * Fill the NCO table (once)
+ */
+static void nco_init(void) {
+  static int ready = 0;
+  if (ready) return;
+  for (int k = 0; k <= NCO_LUT_SIZE; k++) {
+    double t = 2.0 * M_PI * (double)k / (double)NCO_LUT_SIZE;
+    nco_lut[k].re = (float)cos(t);
+    nco_lut[k].im = (float)sin(t);
+  }
+  ready = 1;
+}
+
+/**
+ * Phase accumulator increment for an angle
+ * @param rad  Angle (rad)
+ * @return Increment (2^32 = one turn, wraps modulo a turn)
+ */
+static inline uint32_t nco_step(double rad) {
+  double x = rad * (4294967296.0 / (2.0 * M_PI));
+  /* A diverged loop must not make the conversion undefined */
+  if (!(x > -9.0e18 && x < 9.0e18)) return 0;
+  return (uint32_t)(int64_t)x;
+}
+
+/**
+ * Unit phasor exp(-i*phase) from the table
+ * @param phase  Phase (2^32 = one turn)
+ * @return cos(phase) - i*sin(phase)
+ */
+static inline cplxf nco_exp_neg(uint32_t phase) {
+  const cplxf* e = &nco_lut[phase >> NCO_FRAC_BITS];
+  float f = (float)(phase & ((1u << NCO_FRAC_BITS) - 1)) *
+            (1.0f / (float)(1u << NCO_FRAC_BITS));
+  cplxf c = {e[0].re + f * (e[1].re - e[0].re),
+             -(e[0].im + f * (e[1].im - e[0].im))};
+  return c;
+}
+
+/* *****************************************************************************
+ *
+ *                         CARRIER ACQUISITION
+ *
+ * *****************************************************************************/
+
+/**
+ * Initialize carrier acquisition state
+ * @param acq  State to initialize
+ * @param cfg  Configuration parameters
+ */
+static void acq_init(AcqState* acq, const Config* cfg) {
+  memset(acq, 0, sizeof(*acq));
+  if (cfg->acq_len <= 0) return;
+  acq->len = (size_t)cfg->acq_len;
+  acq->order = cfg->modulation == MOD_BPSK ? 2 : 4;
+  acq->period = (size_t)cfg->reacq_period;
+  acq->hist = (cplxf*)malloc(acq->len * sizeof(cplxf));
+  acq->re = (float*)malloc(2 * acq->len * sizeof(float));
+  if (!acq->hist || !acq->re) {
+    fprintf(stderr, "Warning: no memory for carrier acquisition\n");
+    free(acq->hist);
+    free(acq->re);
+    memset(acq, 0, sizeof(*acq));
+    return;
+  }
+  acq->im = acq->re + acq->len;
+}
+
+/**
+ * Release carrier acquisition buffers
+ * @param acq  Acquisition state
+ */
+static void acq_free(AcqState* acq) {
+  free(acq->hist);
+  free(acq->re);
+}
+
+/**
+ * Append loop input samples to the acquisition ring
+ *
+ * @param acq  Acquisition state
+ * @param in   Samples
+ * @param n    Number of samples (only the last len are kept)
+ */
+static void acq_push(AcqState* acq, const cplxf* in, size_t n) {
+  if (n > acq->len) {
+    in += n - acq->len;
+    n = acq->len;
+  }
+  size_t first = acq->len - acq->head < n ? acq->len - acq->head : n;
+  memcpy(acq->hist + acq->head, in, first * sizeof(cplxf));
+  memcpy(acq->hist, in + first, (n - first) * sizeof(cplxf));
+  acq->head = (acq->head + n) & (acq->len - 1);
+  acq->fill = acq->fill + n < acq->len ? acq->fill + n : acq->len;
+}
+
+/**
+ * Estimate the carrier offset from the samples in the ring
+ *
+ * The ring (oldest sample first, zero-padded when not full) is raised to
+ * the acquisition order and transformed; the offset is the interpolated
+ * peak bin divided by the order.
+ *
+ * @param acq      Acquisition state
+ * @param freq     Output: carrier offset (rad/sample)
+ * @param line_db  Output: peak over mean bin power (dB)
+ * @return 1 if the line is strong enough to use, 0 otherwise
+ */
+static int acq_estimate(AcqState* acq, double* freq, double* line_db) {
+  size_t len = acq->len;
+  size_t start = (acq->head + len - acq->fill) & (len - 1);
+  for (size_t k = 0; k < len; k++) {
+    if (k >= acq->fill) {
+      acq->re[k] = 0.0f;
+      acq->im[k] = 0.0f;
+      continue;
+    }
+    cplxf x = acq->hist[(start + k) & (len - 1)];
+    cplxf y = cplxf_mul(x, x);
+    if (acq->order == 4) y = cplxf_mul(y, y);
+    acq->re[k] = y.re;
+    acq->im[k] = y.im;
+  }
+
+  *freq = 0.0;
+  *line_db = 0.0;
+  if (dsp_fft_cf32(acq->re, acq->im, len) != 0) return 0;
+
+  /* Strongest bin against the mean bin power */
+  size_t peak = 0;
+  double peak_pwr = -1.0;
+  double sum = 0.0;
+  for (size_t k = 0; k < len; k++) {
+    double p = (double)acq->re[k] * acq->re[k] +
+               (double)acq->im[k] * acq->im[k];
+    sum += p;
+    if (p > peak_pwr) {
+      peak_pwr = p;
+      peak = k;
+    }
+  }
+  double mean = sum / (double)len;
+  if (!(peak_pwr > 0.0) || !(mean > 0.0)) return 0;
+  *line_db = 10.0 * log10(peak_pwr / mean);
+
+  /* Parabolic interpolation of the magnitude around the peak */
+  size_t kl = (peak + len - 1) & (len - 1);
+  size_t kr = (peak + 1) & (len - 1);
+  double ml = hypot((double)acq->re[kl], (double)acq->im[kl]);
+  double mc = sqrt(peak_pwr);
+  double mr = hypot((double)acq->re[kr], (double)acq->im[kr]);
+  double den = ml - 2.0 * mc + mr;
+  double delta = den < 0.0 ? 0.5 * (ml - mr) / den : 0.0;
+
+  double bin = (double)peak + delta;
+  if (bin >= (double)len / 2.0) bin -= (double)len;
+  *freq = 2.0 * M_PI * bin / ((double)len * (double)acq->order);
+  return *line_db >= ACQ_MIN_LINE_DB;
+}
+
+/* *****************************************************************************
+ *
+ *                         LOOP STATE KERNELS
+ *
+ * *****************************************************************************/
+
+/**
+ * Scale of the loop gains for the configured AGC level
+ *
+ * The phase and M&M detectors grow with the amplitude of the loop input,
+ * so the default gains (and the auto-tune grid) assume AGC_LOOP_LEVEL, the
+ * mean power peak normalization used to leave on OQPSK captures (0.23 to
+ * 0.38). Gains are scaled by this factor, and by its square for detectors
+ * that grow with the power, so --agc-level does not retune the loops.
+ *
+ * @param cfg  Configuration parameters
+ * @return Gain scale (1 at the default level)
+ */
+static double loop_gain_scale(const Config* cfg) {
+  return sqrt((double)AGC_LOOP_LEVEL / (double)cfg->agc_level);
+}
+
+/**
+ * Initialize Costas loop state (zero phase and frequency)
+ * @param st  State to initialize
+ */
+static void costas_init(CostasState* st) {
+  nco_init();
+  st->phase = 0;
+  st->freq = 0.0;
+  st->freq_acc = 0.0;
+  st->freq_n = 0;
+}
+
+/**
+ * Run the BPSK Costas loop over a block of samples
+ * Phase detector: sign(I) * Q
+ *
+ * @param st        Loop state (carried between blocks)
+ * @param in        Input samples
+ * @param n         Number of samples
+ * @param out_i     Output: I plane of the carrier-corrected samples
+ * @param out_q     Output: Q plane of the carrier-corrected samples
+ * @param cfg       Configuration parameters
+ */
+static void costas_run_bpsk(CostasState* st, const cplxf* in, size_t n,
+                            float* out_i, float* out_q, const Config* cfg) {
+  const double alpha = (double)cfg->costas_alpha * loop_gain_scale(cfg);
+  const double beta = (double)cfg->costas_beta * loop_gain_scale(cfg);
+  uint32_t phase = st->phase;
+  double freq = st->freq;
+  double acc = st->freq_acc;
+
+  for (size_t k = 0; k < n; k++) {
+    cplxf y = cplxf_mul(in[k], nco_exp_neg(phase));
+
+    /* BPSK phase error detector */
+    double err = (double)copysignf(1.0f, y.re) * (double)y.im;
+
+    /* Update loop filter */
+    freq += beta * err;
+    phase += nco_step(freq + alpha * err);
+    acc += freq;
+
+    out_i[k] = y.re;
+    out_q[k] = y.im;
+  }
+
+  st->phase = phase;
+  st->freq = freq;
+  st->freq_acc = acc;
+  st->freq_n += n;
+}
+
+/**
+ * Run the QPSK Costas loop over a block of samples
+ * Phase detector: sign(I)*Q - sign(Q)*I
+ *
+ * @param st        Loop state (carried between blocks)
+ * @param in        Input samples
+ * @param n         Number of samples
+ * @param out_i     Output: I plane of the carrier-corrected samples
+ * @param out_q     Output: Q plane of the carrier-corrected samples
+ * @param cfg       Configuration parameters
+ */
+static void costas_run_qpsk(CostasState* st, const cplxf* in, size_t n,
+                            float* out_i, float* out_q, const Config* cfg) {
+  const double alpha = (double)cfg->costas_alpha * loop_gain_scale(cfg);
+  const double beta = (double)cfg->costas_beta * loop_gain_scale(cfg);
+  uint32_t phase = st->phase;
+  double freq = st->freq;
+  double acc = st->freq_acc;
+
+  for (size_t k = 0; k < n; k++) {
+    cplxf y = cplxf_mul(in[k], nco_exp_neg(phase));
+
+    /* QPSK phase error detector */
+    double err = (double)copysignf(1.0f, y.re) * (double)y.im -
+                 (double)copysignf(1.0f, y.im) * (double)y.re;
+
+    /* Update loop filter */
+    freq += beta * err;
+    phase += nco_step(freq + alpha * err);
+    acc += freq;
+
+    out_i[k] = y.re;
+    out_q[k] = y.im;
+  }
+
+  st->phase = phase;
+  st->freq = freq;
+  st->freq_acc = acc;
+  st->freq_n += n;
+}
+
+/**
+ * Initialize Mueller & Müller timing loop state
+ *
+ * @param st           State to initialize
+ * @param current_sps  Nominal samples per symbol
+ * @param idx0         First sampling instant (absolute sample index)
+ * @param max_iters    Iteration limit (0 = unlimited)
+ */
+static void timing_init(TimingState* st, float current_sps, double idx0,
+                        size_t max_iters) {
+  st->idx = idx0;
+  st->sps_est = (double)current_sps;
+  st->sps_nom = current_sps;
+  st->prev_sym = cplxf_make(0.0f, 0.0f);
+  st->prev_dec = cplxf_make(0.0f, 0.0f);
+  st->ref = cplxf_make(0.0f, 0.0f);
+  st->prev_q = cplxf_make(0.0f, 0.0f);
+  st->pwr = 0.0;
+  st->ted_gain = 1.0;
+  st->kp = 0.0;
+  st->ki = 0.0;
+  st->first = 1;
+  st->stopped = 0;
+  st->iters = 0;
+  st->max_iters = max_iters;
+}
+
+/**
+ * Raised cosine pulse
+ * @param t     Time (symbols)
+ * @param beta  Roll-off factor
+ * @return Pulse value (1 at t = 0)
+ */
+static double raised_cosine(double t, double beta) {
+  if (fabs(t) < 1e-9) return 1.0;
+  double sinc = sin(M_PI * t) / (M_PI * t);
+  double x = 2.0 * beta * t;
+  if (fabs(fabs(x) - 1.0) < 1e-9) return sinc * M_PI / 4.0;
+  return sinc * cos(M_PI * beta * t) / (1.0 - x * x);
+}
+
+/**
+ * Set up the TIMING_GARDNER loop filter
+ *
+ * The detector slope is the derivative at zero of the Gardner S-curve
+ *   S(tau) = sum_m [p(m - 1 + tau) - p(m + tau)] * p(m - 1/2 + tau)
+ * for unit-power random symbols through a raised cosine p with the RRC
+ * roll-off; the PI gains are the standard second-order loop design.
+ *
+ * @param st   Timing state
+ * @param cfg  Configuration parameters
+ */
+static void timing_loop_design(TimingState* st, const Config* cfg) {
+  double beta = cfg->rrc_alpha > 0.0f ? (double)cfg->rrc_alpha : 0.5;
+  const double h = 1e-3;
+  double s_plus = 0.0;
+  double s_minus = 0.0;
+  for (int m = -64; m <= 64; m++) {
+    s_plus += (raised_cosine(m - 1 + h, beta) - raised_cosine(m + h, beta)) *
+              raised_cosine(m - 0.5 + h, beta);
+    s_minus += (raised_cosine(m - 1 - h, beta) - raised_cosine(m - h, beta)) *
+               raised_cosine(m - 0.5 - h, beta);
+  }
+  /* The S-curve falls through zero: a late sample gives a negative error */
+  st->ted_gain = (s_minus - s_plus) / (2.0 * h);
+
+  double zeta = TIMING_DAMPING;
+  double theta = (double)cfg->timing_bw / (zeta + 0.25 / zeta);
+  double d = 1.0 + 2.0 * zeta * theta + theta * theta;
+  st->kp = 4.0 * zeta * theta / d;
+  st->ki = 4.0 * theta * theta / d;
+}
+
+/**
+ * Run the BPSK M&M timing loop over a window of I-channel samples
+ *
+ * The window holds samples [win_start, win_start + win_len) of the
+ * carrier-corrected stream; the loop consumes symbols until the next
+ * sampling instant would need samples beyond the window.
+ *
+ * @param st         Loop state (carried between windows)
+ * @param win        I-channel samples
+ * @param win_len    Window length
+ * @param win_start  Absolute index of win[0]
+ * @param syms       Output: recovered symbols (appended)
+ * @param sps_log    Output: SPS log (appended, NULL to skip)
+ * @param cfg        Configuration parameters
+ */
+static void timing_run_bpsk(TimingState* st, const float* win,
+                            size_t win_len, size_t win_start,
+                            FloatBuffer* syms, FloatBuffer* sps_log,
+                            const Config* cfg) {
+  const double sps_nom = (double)st->sps_nom;
+  const double sps_min = 0.50 * sps_nom;
+  const double sps_max = 1.50 * sps_nom;
+  const double min_step = 0.10; /* Minimum forward progress */
+  const double base = (double)win_start;
+  const double alpha = (double)cfg->timing_alpha * loop_gain_scale(cfg);
+  const double beta = (double)cfg->timing_beta * loop_gain_scale(cfg);
+
+  while (!st->stopped && st->idx - base < (double)win_len - st->sps_est - 5.0) {
+    if (st->max_iters && ++st->iters > st->max_iters) {
+      st->stopped = 1; /* Bad parameter combo - bail out */
+      break;
+    }
+
+    float sym = interpolate_sample_f(win, win_len, st->idx - base);
+    float_buffer_append(syms, sym);
+
+    if (st->first) {
+      st->prev_sym.re = sym;
+      st->prev_dec.re = slicer_bpsk(sym);
+      st->first = 0;
+      if (sps_log) float_buffer_append(sps_log, (float)st->sps_est);
+      st->idx += st->sps_est;
+      continue;
+    }
+
+    float dec = slicer_bpsk(sym);
+
+    /* M&M timing error detector for BPSK */
+    double err = (double)st->prev_dec.re * (double)sym -
+                 (double)dec * (double)st->prev_sym.re;
+
+    if (!isfinite(err) || !isfinite(st->sps_est) || !isfinite(st->idx)) {
+      st->stopped = 1;
+      break;
+    }
+
+    /* Update SPS estimate */
+    st->sps_est += beta * err;
+
+    /* Clamp SPS */
+    if (st->sps_est < sps_min) st->sps_est = sps_min;
+    if (st->sps_est > sps_max) st->sps_est = sps_max;
+
+    /* Calculate step */
+    double step = st->sps_est + alpha * err;
+    if (!isfinite(step) || step < min_step) step = min_step;
+    st->idx += step;
+
+    if (sps_log) float_buffer_append(sps_log, (float)st->sps_est);
+
+    st->prev_sym.re = sym;
+    st->prev_dec.re = dec;
+
+    if (!isfinite(st->idx) || !isfinite(st->sps_est)) {
+      printf("Timing loop blew up (idx/sps not finite). Breaking.\n");
+      st->stopped = 1;
+      break;
+    }
+  }
+}
+
+/**
+ * Run the OQPSK M&M timing loop over a window of carrier-corrected samples
+ * I and Q are sampled with a half-symbol offset, each from its own plane.
+ *
+ * @param st         Loop state (carried between windows)
+ * @param win_i      I plane of the carrier-corrected samples
+ * @param win_q      Q plane of the carrier-corrected samples
+ * @param win_len    Window length
+ * @param win_start  Absolute index of win_i[0] / win_q[0]
+ * @param syms       Output: recovered symbols (appended)
+ * @param sps_log    Output: SPS log (appended, NULL to skip)
+ * @param cfg        Configuration parameters
+ */
+static void timing_run_oqpsk(TimingState* st, const float* win_i,
+                             const float* win_q, size_t win_len,
+                             size_t win_start, SignalBuffer* syms,
+                             FloatBuffer* sps_log, const Config* cfg) {
+  const double base = (double)win_start;
+  const double alpha = (double)cfg->timing_alpha * loop_gain_scale(cfg);
+  const double beta = (double)cfg->timing_beta * loop_gain_scale(cfg);
+
+  while (st->idx - base < (double)win_len - st->sps_est - 5.0) {
+    /* OQPSK: I and Q with half-symbol offset */
+    double pos = st->idx - base;
+    double pos_q = pos + st->sps_est / 2.0;
+    cplxf sym = cplxf_make(interpolate_sample_f(win_i, win_len, pos),
+                           interpolate_sample_f(win_q, win_len, pos_q));
+
+    signal_buffer_append(syms, sym);
+
+    if (st->first) {
+      st->prev_sym = sym;
+      st->prev_dec = slicer_qpsk(sym);
+      st->first = 0;
+      if (sps_log) float_buffer_append(sps_log, (float)st->sps_est);
+      st->idx += st->sps_est;
+      continue;
+    }
+
+    cplxf dec = slicer_qpsk(sym);
+
+    /* M&M timing error detector */
+    double term1 = (double)st->prev_dec.re * (double)sym.re +
+                   (double)st->prev_dec.im * (double)sym.im;
+    double term2 = (double)dec.re * (double)st->prev_sym.re +
+                   (double)dec.im * (double)st->prev_sym.im;
+    double err = term1 - term2;
+
+    /* Update SPS estimate */
+    st->sps_est += beta * err;
+
+    /* Clamp SPS */
+    double sps_min = 0.5 * (double)st->sps_nom;
+    double sps_max = 1.5 * (double)st->sps_nom;
+    if (st->sps_est < sps_min) st->sps_est = sps_min;
+    if (st->sps_est > sps_max) st->sps_est = sps_max;
+
+    /* Calculate step */
+    double step = st->sps_est + alpha * err;
+    if (step < 0.10) step = 0.10;
+    st->idx += step;
+
+    if (sps_log) float_buffer_append(sps_log, (float)st->sps_est);
+
+    st->prev_sym = sym;
+    st->prev_dec = dec;
+  }
+}
+
+/**
+ * Run the Gardner timing loop over a window of matched-filter samples
+ *
+ * The detector compares the symbols on either side of each midpoint, so it
+ * works before the carrier is removed: BPSK uses d * conj(mid), which does
+ * not depend on the carrier phase. For OQPSK the I and Q terms of that
+ * product cancel, so d * mid (twice the carrier phase) is taken against a
+ * smoothed y^2 - mid^2 reference that carries the same phase. When the
+ * carrier is already removed (CARRIER_SAMPLE) the OQPSK detector takes the
+ * I transition around the midpoint and the Q transition around the
+ * on-time sample directly. For each symbol the on-time sample is appended
+ * to raw; OQPSK also appends the sample half a symbol later (the Q
+ * instant).
+ *
+ * TIMING_GARDNER interpolates with the Farrow cubic and runs the PI loop
+ * filter from timing_loop_design(); TIMING_MM interpolates linearly with
+ * the --timing-alpha / --timing-beta gains.
+ *
+ * @param st         Loop state (carried between windows)
+ * @param win_i      I plane of the matched-filter samples
+ * @param win_q      Q plane of the matched-filter samples
+ * @param win_len    Window length
+ * @param win_start  Absolute index of win_i[0] / win_q[0]
+ * @param oqpsk      Non-zero for OQPSK (two samples per symbol)
+ * @param raw        Output: samples at the symbol instants (appended)
+ * @param sps_log    Output: SPS log (appended, NULL to skip)
+ * @param cfg        Configuration parameters
+ */
+static void timing_run_gardner(TimingState* st, const float* win_i,
+                               const float* win_q, size_t win_len,
+                               size_t win_start, int oqpsk, SignalBuffer* raw,
+                               FloatBuffer* sps_log, const Config* cfg) {
+  const double sps_nom = (double)st->sps_nom;
+  const double sps_min = 0.5 * sps_nom;
+  const double sps_max = 1.5 * sps_nom;
+  const double base = (double)win_start;
+  const int cubic = cfg->timing_mode == TIMING_GARDNER;
+  const int corrected = cfg->carrier_mode == CARRIER_SAMPLE;
+  /* The Gardner detector grows with the power */
+  const double kn = loop_gain_scale(cfg) * loop_gain_scale(cfg);
+  const double alpha = (double)cfg->timing_alpha * kn;
+  const double beta = (double)cfg->timing_beta * kn;
+
+  while (!st->stopped && st->idx - base < (double)win_len - st->sps_est - 5.0) {
+    if (st->max_iters && ++st->iters > st->max_iters) {
+      st->stopped = 1; /* Bad parameter combo - bail out */
+      break;
+    }
+
+    double pos = st->idx - base;
+    double half = st->sps_est / 2.0;
+    cplxf y = interpolate_planes(win_i, win_q, win_len, pos, cubic);
+    cplxf mid = interpolate_planes(win_i, win_q, win_len, pos - half, cubic);
+    cplxf q = y;
+    if (oqpsk) q = interpolate_planes(win_i, win_q, win_len, pos + half, cubic);
+
+    signal_buffer_append(raw, y);
+    if (oqpsk) signal_buffer_append(raw, q);
+
+    if (st->first) {
+      st->prev_sym = y;
+      st->prev_q = q;
+      st->pwr = (double)cplxf_abs2(y);
+      st->first = 0;
+      if (sps_log) float_buffer_append(sps_log, (float)st->sps_est);
+      st->idx += st->sps_est;
+      continue;
+    }
+
+    /* Gardner timing error detector */
+    cplxf d = cplxf_sub(st->prev_sym, y);
+    double err;
+    if (oqpsk && corrected) {
+      err = (double)d.re * (double)mid.re +
+            (double)(st->prev_q.im - q.im) * (double)y.im;
+    } else if (oqpsk) {
+      cplxf r = cplxf_sub(cplxf_mul(y, y), cplxf_mul(mid, mid));
+      st->ref.re += (float)(GARDNER_REF_GAIN * (double)(r.re - st->ref.re));
+      st->ref.im += (float)(GARDNER_REF_GAIN * (double)(r.im - st->ref.im));
+      cplxf g = cplxf_mul(cplxf_mul(d, mid), cplxf_conj(st->ref));
+      float mag = cplxf_abs(st->ref);
+      err = mag > 0.0f ? (double)g.re / (double)mag : 0.0;
+      /* I and Q transitions both count: halve to match the BPSK gain */
+      if (!cubic) err *= 0.5;
+    } else {
+      err = (double)d.re * (double)mid.re + (double)d.im * (double)mid.im;
+    }
+
+    if (!isfinite(err) || !isfinite(st->sps_est) || !isfinite(st->idx)) {
+      st->stopped = 1;
+      break;
+    }
+
+    double step;
+    if (cubic) {
+      /* Normalized detector output: timing error in symbols */
+      st->pwr += GARDNER_PWR_GAIN * ((double)cplxf_abs2(y) - st->pwr);
+      double tau = st->pwr > 0.0 ? err / (st->pwr * st->ted_gain) : 0.0;
+
+      st->sps_est += st->ki * tau * sps_nom;
+      if (st->sps_est < sps_min) st->sps_est = sps_min;
+      if (st->sps_est > sps_max) st->sps_est = sps_max;
+      step = st->sps_est + st->kp * tau * sps_nom;
+    } else {
+      /* Update SPS estimate */
+      st->sps_est += beta * err;
+
+      /* Clamp SPS */
+      if (st->sps_est < sps_min) st->sps_est = sps_min;
+      if (st->sps_est > sps_max) st->sps_est = sps_max;
+
+      /* Calculate step */
+      step = st->sps_est + alpha * err;
+    }
+    if (step < 0.10) step = 0.10;
+    st->idx += step;
+
+    if (sps_log) float_buffer_append(sps_log, (float)st->sps_est);
+
+    st->prev_sym = y;
+    st->prev_q = q;
+  }
+}
+
+/**
+ * Run the BPSK Costas loop at the symbol rate
+ * Phase detector: sign(I) * Q
+ *
+ * @param st        Loop state (frequency in rad/symbol)
+ * @param y         On-time samples from the Gardner loop
+ * @param n         Number of symbols
+ * @param sps       Samples per symbol (scales the loop gains)
+ * @param syms      Output: recovered symbols (appended)
+ * @param cfg       Configuration parameters
+ */
+static void costas_run_sym_bpsk(CostasState* st, const cplxf* y, size_t n,
+                                float sps, FloatBuffer* syms,
+                                const Config* cfg) {
+  const double alpha =
+      (double)cfg->costas_alpha * (double)sps * loop_gain_scale(cfg);
+  const double beta = (double)cfg->costas_beta * (double)sps * (double)sps *
+                      loop_gain_scale(cfg);
+  uint32_t phase = st->phase;
+  double freq = st->freq;
+  double acc = st->freq_acc;
+
+  for (size_t k = 0; k < n; k++) {
+    cplxf r = cplxf_mul(y[k], nco_exp_neg(phase));
+
+    /* BPSK phase error detector */
+    double err = (double)copysignf(1.0f, r.re) * (double)r.im;
+
+    /* Update loop filter */
+    freq += beta * err;
+    phase += nco_step(freq + alpha * err);
+    acc += freq;
+
+    float_buffer_append(syms, r.re);
+  }
+
+  st->phase = phase;
+  st->freq = freq;
+  st->freq_acc = acc;
+  st->freq_n += n;
+}
+
+/**
+ * Run the OQPSK Costas loop at the symbol rate
+ * Phase detector: sign(I)*Q at the I instant - sign(Q)*I at the Q instant
+ *
+ * Which of the two Gardner instants carries I is not known before the
+ * data: the squared-signal detector sees both the same way. Taking the
+ * Q instant as I reads like a quarter-turn carrier lock one bit later.
+ * NRZ-M turns that into a complemented stream, and frame_sync_scan()
+ * matches the complemented sync word at any bit offset.
+ *
+ * @param st        Loop state (frequency in rad/symbol)
+ * @param y         Sample pairs (I instant, Q instant) from the Gardner loop
+ * @param n         Number of symbols (pairs)
+ * @param sps       Samples per symbol (scales the loop gains)
+ * @param syms      Output: recovered symbols (appended)
+ * @param cfg       Configuration parameters
+ */
+static void costas_run_sym_oqpsk(CostasState* st, const cplxf* y, size_t n,
+                                 float sps, SignalBuffer* syms,
+                                 const Config* cfg) {
+  const double alpha =
+      (double)cfg->costas_alpha * (double)sps * loop_gain_scale(cfg);
+  const double beta = (double)cfg->costas_beta * (double)sps * (double)sps *
+                      loop_gain_scale(cfg);
+  uint32_t phase = st->phase;
+  double freq = st->freq;
+  double acc = st->freq_acc;
+
+  for (size_t k = 0; k < n; k++) {
+    /* The Q instant is half a symbol of carrier rotation later */
+    cplxf ri = cplxf_mul(y[2 * k], nco_exp_neg(phase));
+    cplxf rq = cplxf_mul(y[2 * k + 1],
+                         nco_exp_neg(phase + nco_step(0.5 * freq)));
+
+    /* OQPSK phase error detector */
+    double err = (double)copysignf(1.0f, ri.re) * (double)ri.im -
+                 (double)copysignf(1.0f, rq.im) * (double)rq.re;
+
+    /* Update loop filter */
+    freq += beta * err;
+    phase += nco_step(freq + alpha * err);
+    acc += freq;
+
+    signal_buffer_append(syms, cplxf_make(ri.re, rq.im));
+  }
+
+  st->phase = phase;
+  st->freq = freq;
+  st->freq_acc = acc;
+  st->freq_n += n;
+}
+
+/* *****************************************************************************
+ *
+ *                         DEMODULATION LOOPS - BPSK
+ *
+ * *****************************************************************************/
+
+/**
+ * Run BPSK demodulation with Costas carrier recovery and M&M timing recovery
+ *
+ * The signal goes through the loop engine chunk by chunk, so no
+ * carrier-corrected copy of it is made. With CARRIER_SYMBOL, Gardner timing
+ * runs first and the Costas loop runs on the symbols.
+ *
+ * @param sig          Input signal array
+ * @param N            Signal length
+ * @param current_sps  Samples per symbol
+ * @param cfg          Configuration parameters
+ * @param syms_out     Output: recovered symbols (caller frees)
+ * @param nsyms        Output: number of symbols
+ * @param sps_log      Output: SPS log (caller frees, NULL if quiet)
+ * @param nlog         Output: log length
+ * @param quiet        If non-zero, suppress output and skip logging
+ */
+void run_loops_bpsk(cplxf* sig, size_t N, float current_sps, Config* cfg,
+                    float** syms_out, size_t* nsyms, float** sps_log,
+                    size_t* nlog, int quiet) {
+  if (!quiet) {
+    printf("\n--- STEP 2: RUNNING BPSK LOOPS (%s) ---\n",
+           cfg->carrier_mode == CARRIER_SYMBOL ? "Gardner + symbol-rate Costas"
+           : cfg->timing_mode == TIMING_GARDNER ? "Costas + Gardner"
+                                                : "Costas + Mueller");
+  }
 
-  /* Create socket */
-#ifdef _WIN32
-  sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-  if (sock == INVALID_SOCKET) {
-    fprintf(stderr, "[UDP] Socket creation failed\n");
-    WSACleanup();
-    return -1;
+  /* Safety limit to prevent infinite loops */
+  const double sps_nom = (double)current_sps;
+  size_t max_iters = (size_t)((double)N / fmax(sps_nom, 1e-6)) * 4 + 1000;
+
+  DemodStream ds;
+  demod_stream_init(&ds, cfg, current_sps, max_iters);
+  if (!quiet) ds.sps_log = float_buffer_create(100000);
+
+  for (size_t k = 0; k < N; k += LOOP_CHUNK_SAMPLES) {
+    size_t n = N - k < LOOP_CHUNK_SAMPLES ? N - k : LOOP_CHUNK_SAMPLES;
+    demod_stream_process(&ds, sig + k, n, cfg);
   }
-#else
-  sock = socket(AF_INET, SOCK_DGRAM, 0);
-  if (sock < 0) {
-    fprintf(stderr, "[UDP] Socket creation failed\n");
-    return -1;
+  demod_stream_flush(&ds, cfg);
+  if (!quiet) demod_stream_report_acq(&ds);
+
+  printf("timing continues %f \n", ds.timing.sps_est);
+
+  *syms_out = ds.syms_bpsk->data;
+  *nsyms = ds.syms_bpsk->len;
+  free(ds.syms_bpsk);
+  ds.syms_bpsk = NULL;
+
+  if (ds.sps_log) {
+    *sps_log = ds.sps_log->data;
+    *nlog = ds.sps_log->len;
+    free(ds.sps_log);
+    ds.sps_log = NULL;
+  } else {
+    *sps_log = NULL;
+    *nlog = 0;
   }
-#endif
 
-  /* Setup destination address */
-  memset(&dest_addr, 0, sizeof(dest_addr));
-  dest_addr.sin_family = AF_INET;
-  dest_addr.sin_port = htons(port);
+  demod_stream_free(&ds);
+}
 
-#ifdef _WIN32
-  dest_addr.sin_addr.S_un.S_addr = inet_addr(host);
+/* *****************************************************************************
+ *
+ *                         DEMODULATION LOOPS - OQPSK
+ *
+ * *****************************************************************************/
+
+/**
+ * Run OQPSK demodulation with Costas carrier recovery and M&M timing recovery
+ *
+ * The signal goes through the loop engine chunk by chunk, so no
+ * carrier-corrected copy of it is made. With CARRIER_SYMBOL, Gardner timing
+ * runs first and the Costas loop runs on the symbols.
+ *
+ * @param sig          Input signal array
+ * @param N            Signal length
+ * @param current_sps  Samples per symbol
+ * @param cfg          Configuration parameters
+ * @param syms_out     Output: recovered symbols (caller frees)
+ * @param nsyms        Output: number of symbols
+ * @param sps_log      Output: SPS log (caller frees, NULL if quiet)
+ * @param nlog         Output: log length
+ * @param quiet        If non-zero, suppress output and skip logging
+ */
+void run_loops(cplxf* sig, size_t N, float current_sps, Config* cfg,
+               cplxf** syms_out, size_t* nsyms, float** sps_log, size_t* nlog,
+               int quiet) {
+  if (!quiet) {
+    printf("\n--- STEP 2: RUNNING OQPSK LOOPS (%s) ---\n",
+           cfg->carrier_mode == CARRIER_SYMBOL ? "Gardner + symbol-rate Costas"
+           : cfg->timing_mode == TIMING_GARDNER ? "Costas + Gardner"
+                                                : "Costas + Mueller");
+  }
+
+  DemodStream ds;
+  demod_stream_init(&ds, cfg, current_sps, 0);
+  if (!quiet) ds.sps_log = float_buffer_create(100000);
+
+  for (size_t k = 0; k < N; k += LOOP_CHUNK_SAMPLES) {
+    size_t n = N - k < LOOP_CHUNK_SAMPLES ? N - k : LOOP_CHUNK_SAMPLES;
+    demod_stream_process(&ds, sig + k, n, cfg);
+  }
+  demod_stream_flush(&ds, cfg);
+  if (!quiet) demod_stream_report_acq(&ds);
+
+  *syms_out = ds.syms_qpsk->data;
+  *nsyms = ds.syms_qpsk->len;
+  free(ds.syms_qpsk);
+  ds.syms_qpsk = NULL;
+
+  if (ds.sps_log) {
+    *sps_log = ds.sps_log->data;
+    *nlog = ds.sps_log->len;
+    free(ds.sps_log);
+    ds.sps_log = NULL;
+  } else {
+    *sps_log = NULL;
+    *nlog = 0;
+  }
+
+  demod_stream_free(&ds);
+}
+
+/* *****************************************************************************
+ *
+ *                         STREAMING PIPELINE
+ *
+ * *****************************************************************************/
+
+/**
+ * Initialize the streaming front-end (DC, low-pass, decimation, RRC, gain)
+ *
+ * @param fe         Front-end state to initialize
+ * @param cfg        Configuration parameters
+ * @param final_sps  Output: effective samples per symbol
+ */
+static void front_end_stream_init(FrontEndStream* fe, const Config* cfg,
+                                  float* final_sps) {
+  memset(fe, 0, sizeof(*fe));
+  dc_block_init(&fe->dc, cfg);
+
+#if ENABLE_LOWPASS
+  decim_design(&fe->lpd, cfg->decim);
+  decim_design_print(&fe->lpd);
+  decim_chain_init(&fe->lp, &fe->lpd);
 #else
-  inet_pton(AF_INET, host, &dest_addr.sin_addr);
+  printf("   [FILTER] Low-pass disabled - skipping\n");
 #endif
 
-  printf("\n--- UDP SENDER ---\n");
-  printf("   Destination: %s:%d\n", host, port);
-  printf("   Chunk size: %zu bytes (unpacked)\n", chunk_size);
-  printf("   Total bits: %zu\n", total_bits);
+  fe->decim = cfg->decim > 1 ? cfg->decim : 1;
+  if (cfg->decim > 1) {
+    *final_sps = cfg->sps / cfg->decim;
+    printf("   [DECIMATION] Factor: %d | New SPS: %.4f\n", cfg->decim,
+           *final_sps);
+  } else {
+    *final_sps = cfg->sps;
+  }
 
-  /* Allocate send buffer */
-  unsigned char* unpacked_buffer = (unsigned char*)malloc(chunk_size);
-  if (!unpacked_buffer) {
-    fprintf(stderr, "[UDP] Memory allocation failed\n");
-#ifdef _WIN32
-    closesocket(sock);
-    WSACleanup();
+  if (cfg->rrc_enable) {
+    float Rs = cfg->rb / 2.0f;
+    float Fs_dec = (Rs * cfg->sps) / cfg->decim;
+    int rrc_ntaps;
+    fe->rrc_taps =
+        rrc_taps(Fs_dec, Rs, cfg->rrc_alpha, cfg->rrc_span, &rrc_ntaps);
+    printf("   [FILTER] RRC matched filter - Taps: %d (%s)\n", rrc_ntaps,
+           fir_method_name(fe->rrc_taps, rrc_ntaps, 1));
+    fir_stream_init(&fe->rrc, fe->rrc_taps, rrc_ntaps);
+    if (cfg->rrc_trim_delay) fe->trim_left = (size_t)((rrc_ntaps - 1) / 2);
+  }
+
+  double ratio = resample_setup(cfg, final_sps);
+  if (ratio > 0.0) resample_stream_init(&fe->rs, ratio);
+  agc_init(&fe->agc, cfg);
+}
+
+/**
+ * Release front-end buffers
+ * @param fe  Front-end state
+ */
+static void front_end_stream_free(FrontEndStream* fe) {
+  dc_block_free(&fe->dc);
+  decim_chain_free(&fe->lp);
+  decim_design_free(&fe->lpd);
+  fir_stream_free(&fe->rrc);
+  resample_stream_free(&fe->rs);
+  agc_free(&fe->agc);
+  free(fe->rrc_taps);
+  free(fe->v);
+  free(fe->tmp_a);
+}
+
+/**
+ * Largest number of outputs one front-end call can produce
+ *
+ * @param fe  Front-end state
+ * @param n   Input samples in the call
+ * @return Output capacity the caller must provide
+ */
+static size_t front_end_stream_max_out(const FrontEndStream* fe, size_t n) {
+  size_t cap = n + decim_chain_taps(&fe->lp) + (size_t)fe->rrc.ntaps;
+  if (fe->rs.ratio > 0.0) {
+    size_t rs_cap = resample_stream_max_out(&fe->rs, cap);
+    if (rs_cap > cap) cap = rs_cap;
+  }
+  return cap + AGC_BLOCK_SAMPLES;
+}
+
+/**
+ * Push voltage samples through low-pass, decimation, RRC and resampler
+ *
+ * @param fe     Front-end state
+ * @param v      Voltage samples (NULL together with flush to drain)
+ * @param n      Number of samples
+ * @param flush  Non-zero to drain the filter tails at end of stream
+ * @param out    Output: filtered samples (before normalization)
+ * @return Number of output samples
+ */
+static size_t front_end_stream_filter(FrontEndStream* fe, const cplxf* v,
+                                      size_t n, int flush, cplxf* out) {
+  size_t cap = front_end_stream_max_out(fe, n);
+  if (cap > fe->tmp_cap) {
+    fe->tmp_a = (cplxf*)realloc(fe->tmp_a, cap * sizeof(cplxf));
+    fe->tmp_cap = cap;
+  }
+
+  /* Decimating low-pass (phase carried across blocks by the stage) */
+  size_t k = 0;
+#if ENABLE_LOWPASS
+  k = decim_chain_process(&fe->lp, v, n, flush, fe->tmp_a);
 #else
-    close(sock);
+  /* Decimation (phase carried across blocks) */
+  for (size_t j = 0; j < n; j++) {
+    if (fe->decim_phase == 0) fe->tmp_a[k++] = v[j];
+    if (++fe->decim_phase == (size_t)fe->decim) fe->decim_phase = 0;
+  }
 #endif
-    return -1;
+
+  /* RRC matched filter */
+  size_t r = k;
+  if (!fe->rrc_taps) {
+    memcpy(out, fe->tmp_a, k * sizeof(cplxf));
+  } else {
+    r = fir_stream_process(&fe->rrc, fe->tmp_a, k, out);
+    if (flush) r += fir_stream_flush(&fe->rrc, out + r);
+
+    /* Group delay trim applies to the head of the stream only */
+    size_t skip = fe->trim_left < r ? fe->trim_left : r;
+    if (skip) {
+      memmove(out, out + skip, (r - skip) * sizeof(cplxf));
+      fe->trim_left -= skip;
+      r -= skip;
+    }
   }
 
-  size_t total_sent = 0;
-  size_t packet_count = 0;
+  /* Resampling to the loop SPS */
+  if (fe->rs.ratio > 0.0) {
+    r = resample_stream_process(&fe->rs, out, r, flush, out);
+  }
+  return r;
+}
 
-  /* Send loop */
-  for (size_t i = 0; i < total_bits; i += chunk_size) {
-    size_t bits_to_send =
-        (i + chunk_size <= total_bits) ? chunk_size : (total_bits - i);
+/**
+ * Process one block of raw IQ samples through the whole front-end
+ *
+ * DC is removed with the running mean of everything seen so far, since the
+ * whole-file statistics used by load_and_process() are not available while
+ * streaming; the AGC holds back at most one block of output.
+ *
+ * @param fe     Front-end state
+ * @param raw    Raw interleaved samples (ignored when flushing)
+ * @param n      Number of samples
+ * @param flush  Non-zero to drain the filter tails at end of stream
+ * @param out    Output: gain-controlled samples
+ * @return Number of output samples
+ */
+static size_t front_end_stream_process(FrontEndStream* fe, const void* raw,
+                                       size_t n, int flush, cplxf* out) {
+  if (n > fe->v_cap) {
+    fe->v = (cplxf*)realloc(fe->v, n * sizeof(cplxf));
+    fe->v_cap = n;
+  }
 
-    /* Convert bits to unpacked bytes (0x01 or 0x00) */
-    for (size_t j = 0; j < bits_to_send; j++) {
-      unpacked_buffer[j] = bits[i + j] ? 0x01 : 0x00;
-    }
+  if (n > 0) {
+    /* Global mode: running mean of everything seen so far */
+    if (fe->dc.mode == DC_GLOBAL) dc_block_accumulate(&fe->dc, raw, n, NULL);
 
-    /* Send UDP packet */
-    int sent = sendto(sock, (const char*)unpacked_buffer, (int)bits_to_send, 0,
-                      (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+    double sum_v2 = 0.0;
+    dc_block_process(&fe->dc, raw, n, fe->v, &sum_v2);
+    fe->pwr_raw_acc += (long double)sum_v2;
+    fe->n_raw += n;
+  }
 
-    if (sent < 0) {
-      fprintf(stderr, "[UDP] Send failed on packet %zu\n", packet_count);
+  size_t r = front_end_stream_filter(fe, fe->v, n, flush, out);
+
+  /* Post-filter power, then block gain control */
+  for (size_t k = 0; k < r; k++) {
+    fe->pwr_post_acc += (long double)cplxf_abs2(out[k]);
+  }
+  fe->n_post += r;
+
+  return agc_stream_process(&fe->agc, out, r, flush, out);
+}
+
+/**
+ * Initialize streaming demodulator state
+ *
+ * @param ds           State to initialize
+ * @param cfg          Configuration parameters
+ * @param current_sps  Samples per symbol at the loop input
+ * @param max_iters    BPSK timing iteration limit (0 = unlimited)
+ */
+static void demod_stream_init(DemodStream* ds, const Config* cfg,
+                              float current_sps, size_t max_iters) {
+  memset(ds, 0, sizeof(*ds));
+  costas_init(&ds->costas);
+  acq_init(&ds->acq, cfg);
+  ds->per_symbol = cfg->carrier_mode == CARRIER_SYMBOL;
+  if (ds->per_symbol || cfg->timing_mode == TIMING_GARDNER) {
+    ds->raw = signal_buffer_create(4096);
+  }
+  if (cfg->modulation == MOD_BPSK) {
+    timing_init(&ds->timing, current_sps, (double)current_sps, max_iters);
+    ds->syms_bpsk = float_buffer_create(4096);
+  } else {
+    double idx0 = ds->raw ? (double)current_sps : 0.0;
+    timing_init(&ds->timing, current_sps, idx0, 0);
+    ds->syms_qpsk = signal_buffer_create(4096);
+  }
+  if (cfg->timing_mode == TIMING_GARDNER) {
+    timing_loop_design(&ds->timing, cfg);
+  }
+}
+
+/**
+ * Release streaming demodulator buffers
+ * @param ds  Demodulator state
+ */
+static void demod_stream_free(DemodStream* ds) {
+  plane_free(ds->win_i);
+  plane_free(ds->win_q);
+  signal_buffer_free(ds->raw);
+  signal_buffer_free(ds->syms_qpsk);
+  float_buffer_free(ds->syms_bpsk);
+  float_buffer_free(ds->sps_log);
+  acq_free(&ds->acq);
+}
+
+/**
+ * Run carrier and timing recovery over one block of front-end output
+ *
+ * Carrier-corrected samples are kept in a sliding window that only holds
+ * what the timing interpolator still needs; symbols are appended to the
+ * state's symbol buffer. With CARRIER_SYMBOL the window holds the
+ * front-end output itself and the Costas loop runs on the Gardner
+ * samples. With TIMING_GARDNER at the sample rate the Gardner samples are
+ * the symbols.
+ *
+ * @param ds   Demodulator state
+ * @param in   Front-end output samples
+ * @param n    Number of samples
+ * @param cfg  Configuration parameters
+ */
+static void demod_stream_loops(DemodStream* ds, const cplxf* in, size_t n,
+                               const Config* cfg) {
+  int bpsk = cfg->modulation == MOD_BPSK;
+  int per_symbol = ds->per_symbol;
+  int gardner = ds->raw != NULL; /* Gardner detector (looks back) */
+
+  if (ds->win_len + n > ds->win_cap) {
+    size_t cap = (ds->win_len + n) * 2;
+    float* wi = plane_alloc(cap);
+    float* wq = plane_alloc(cap);
+    if (ds->win_len) {
+      memcpy(wi, ds->win_i, ds->win_len * sizeof(float));
+      memcpy(wq, ds->win_q, ds->win_len * sizeof(float));
+    }
+    plane_free(ds->win_i);
+    plane_free(ds->win_q);
+    ds->win_i = wi;
+    ds->win_q = wq;
+    ds->win_cap = cap;
+  }
+
+  /* Interleaved input is split into the planes once, here */
+  float* dst_i = ds->win_i + ds->win_len;
+  float* dst_q = ds->win_q + ds->win_len;
+  if (per_symbol) {
+    if (ds->pre_step) {
+      uint32_t ph = ds->pre_phase;
+      for (size_t k = 0; k < n; k++) {
+        cplxf y = cplxf_mul(in[k], nco_exp_neg(ph));
+        dst_i[k] = y.re;
+        dst_q[k] = y.im;
+        ph += ds->pre_step;
+      }
+      ds->pre_phase = ph;
     } else {
-      total_sent += sent;
-      packet_count++;
-      if (packet_count % 100 == 0) {
-        printf("   Sent %zu packets, %zu bytes\n", packet_count, total_sent);
+      for (size_t k = 0; k < n; k++) {
+        dst_i[k] = in[k].re;
+        dst_q[k] = in[k].im;
       }
     }
+    ds->win_len += n;
 
-    /* Inter-packet delay */
-#ifdef _WIN32
-    Sleep(UDP_DELAY_MS);
-#else
-    usleep(UDP_DELAY_MS * 1000);
-#endif
-  }
-
-  printf("   COMPLETE: %zu packets, %zu bytes sent\n", packet_count,
-         total_sent);
+    timing_run_gardner(&ds->timing, ds->win_i, ds->win_q, ds->win_len,
+                       ds->win_start, !bpsk, ds->raw, ds->sps_log, cfg);
+    if (bpsk) {
+      costas_run_sym_bpsk(&ds->costas, ds->raw->data, ds->raw->len,
+                          ds->timing.sps_nom, ds->syms_bpsk, cfg);
+    } else {
+      costas_run_sym_oqpsk(&ds->costas, ds->raw->data, ds->raw->len / 2,
+                           ds->timing.sps_nom, ds->syms_qpsk, cfg);
+    }
+    ds->raw->len = 0;
+  } else if (gardner) {
+    if (bpsk) {
+      costas_run_bpsk(&ds->costas, in, n, dst_i, dst_q, cfg);
+    } else {
+      costas_run_qpsk(&ds->costas, in, n, dst_i, dst_q, cfg);
+    }
+    ds->win_len += n;
+
+    timing_run_gardner(&ds->timing, ds->win_i, ds->win_q, ds->win_len,
+                       ds->win_start, !bpsk, ds->raw, ds->sps_log, cfg);
+    const cplxf* r = ds->raw->data;
+    if (bpsk) {
+      for (size_t k = 0; k < ds->raw->len; k++) {
+        float_buffer_append(ds->syms_bpsk, r[k].re);
+      }
+    } else {
+      for (size_t k = 0; k + 1 < ds->raw->len; k += 2) {
+        signal_buffer_append(ds->syms_qpsk, cplxf_make(r[k].re, r[k + 1].im));
+      }
+    }
+    ds->raw->len = 0;
+  } else if (bpsk) {
+    costas_run_bpsk(&ds->costas, in, n, dst_i, dst_q, cfg);
+    ds->win_len += n;
 
-  free(unpacked_buffer);
+    timing_run_bpsk(&ds->timing, ds->win_i, ds->win_len, ds->win_start,
+                    ds->syms_bpsk, ds->sps_log, cfg);
+  } else {
+    costas_run_qpsk(&ds->costas, in, n, dst_i, dst_q, cfg);
+    ds->win_len += n;
 
-#ifdef _WIN32
-  closesocket(sock);
-  WSACleanup();
-#else
-  close(sock);
-#endif
+    timing_run_oqpsk(&ds->timing, ds->win_i, ds->win_q, ds->win_len,
+                     ds->win_start, ds->syms_qpsk, ds->sps_log, cfg);
+  }
 
-  return 0;
+  /* Drop samples the interpolator can no longer reach (Gardner also
+   * looks back half a symbol) */
+  double rel = ds->timing.idx - (double)ds->win_start;
+  if (gardner) {
+    /* The cubic reaches one sample further back */
+    double reach = cfg->timing_mode == TIMING_GARDNER ? 2.0 : 1.0;
+    rel -= ds->timing.sps_est / 2.0 + reach;
+  }
+  size_t drop = rel > 0.0 ? (size_t)rel : 0;
+  if (drop > ds->win_len) drop = ds->win_len;
+  if (drop) {
+    size_t keep = (ds->win_len - drop) * sizeof(float);
+    memmove(ds->win_i, ds->win_i + drop, keep);
+    memmove(ds->win_q, ds->win_q + drop, keep);
+    ds->win_len -= drop;
+    ds->win_start += drop;
+  }
 }
-#endif /* ENABLE_UDP_SENDER */
 
-/* *****************************************************************************
+/**
+ * Take an acquisition estimate into the loops
  *
- *                         BLIND PROCESSING CHAIN
+ * The sample-rate Costas loop starts from it. With CARRIER_SYMBOL the
+ * Gardner loop runs ahead of the Costas loop and needs the offset out of
+ * its input, so the estimate sets the feedforward derotation instead and
+ * the Costas loop tracks what is left.
  *
- * *****************************************************************************/
+ * @param ds    Demodulator state
+ * @param freq  Carrier offset (rad/sample)
+ */
+static void demod_stream_seed(DemodStream* ds, double freq) {
+  if (ds->per_symbol) {
+    ds->pre_step = nco_step(freq);
+    ds->costas.freq = 0.0;
+  } else {
+    ds->costas.freq = freq;
+  }
+}
 
 /**
- * Apply blind processing chain: Viterbi -> NRZ-M -> PSR
+ * Make the initial acquisition estimate and run the held-back prefix
+ * @param ds   Demodulator state
+ * @param cfg  Configuration parameters
+ */
+static void demod_stream_acquire(DemodStream* ds, const Config* cfg) {
+  AcqState* acq = &ds->acq;
+  acq->found = acq_estimate(acq, &acq->freq, &acq->line_db);
+  if (acq->found) demod_stream_seed(ds, acq->freq);
+  acq->done = 1;
+
+  /* The ring has not wrapped yet: the prefix is hist[0 .. fill) */
+  demod_stream_loops(ds, acq->hist, acq->fill, cfg);
+}
+
+/**
+ * Compare the Costas frequency against a fresh estimate and reseed it when
+ * the loop has drifted away from the line
+ * @param ds  Demodulator state
+ */
+static void demod_stream_reacquire(DemodStream* ds) {
+  AcqState* acq = &ds->acq;
+  CostasState* c = &ds->costas;
+  double freq, line_db;
+  int found = acq_estimate(acq, &freq, &line_db);
+
+  /* The loop frequency jitters by many bins from update to update; its
+   * mean since the last check is what should sit on the line */
+  size_t n = c->freq_n;
+  double loop = n ? c->freq_acc / (double)n : c->freq;
+  c->freq_acc = 0.0;
+  c->freq_n = 0;
+  if (!found || !n) return;
+
+  if (ds->per_symbol) {
+    loop = loop / ds->timing.sps_est +
+           (double)(int32_t)ds->pre_step * (2.0 * M_PI / 4294967296.0);
+  }
+  double bin = 2.0 * M_PI / ((double)acq->len * (double)acq->order);
+  if (fabs(loop - freq) > ACQ_REACQ_BINS * bin) {
+    demod_stream_seed(ds, freq);
+    acq->reacqs++;
+  }
+}
+
+/**
+ * Run one block of front-end output through acquisition and the loops
  *
- * @param in       Input bit array (unpacked)
- * @param out      Output bit array (unpacked)
- * @param in_len   Number of input bits
- * @return Number of output bits, or -1 on error
+ * Until the first acquisition FFT is full the samples are only collected;
+ * then the Costas frequency is seeded and the prefix runs through the
+ * loops ahead of the block. With re-acquisition on, the latest samples are
+ * kept and checked every period.
+ *
+ * @param ds   Demodulator state
+ * @param in   Front-end output samples
+ * @param n    Number of samples
+ * @param cfg  Configuration parameters
  */
-int process_blind(const unsigned char* in, unsigned char* out, int in_len) {
-  int current_len = in_len;
+static void demod_stream_process(DemodStream* ds, const cplxf* in, size_t n,
+                                 const Config* cfg) {
+  AcqState* acq = &ds->acq;
+  if (!acq->len) {
+    demod_stream_loops(ds, in, n, cfg);
+    return;
+  }
+
+  if (!acq->done) {
+    size_t take = acq->len - acq->fill < n ? acq->len - acq->fill : n;
+    acq_push(acq, in, take);
+    in += take;
+    n -= take;
+    if (acq->fill < acq->len) return;
+    demod_stream_acquire(ds, cfg);
+  }
+  if (!n) return;
+
+  demod_stream_loops(ds, in, n, cfg);
+  if (acq->period) {
+    acq_push(acq, in, n);
+    acq->since += n;
+    if (acq->since >= acq->period) {
+      acq->since = 0;
+      demod_stream_reacquire(ds);
+    }
+  }
+}
 
-  /* Allocate working buffers */
-  unsigned char* temp1 = (unsigned char*)malloc(in_len);
-  unsigned char* temp2 = (unsigned char*)malloc(in_len);
-  unsigned char* current = (unsigned char*)malloc(in_len);
+/**
+ * Finish a stream: a capture shorter than the acquisition FFT is
+ * estimated zero-padded and its samples run through the loops
+ * @param ds   Demodulator state
+ * @param cfg  Configuration parameters
+ */
+static void demod_stream_flush(DemodStream* ds, const Config* cfg) {
+  if (ds->acq.len && !ds->acq.done && ds->acq.fill) {
+    demod_stream_acquire(ds, cfg);
+  }
+}
 
-  if (!temp1 || !temp2 || !current) {
-    printf("Error: Memory allocation failed\n");
-    free(temp1);
-    free(temp2);
-    free(current);
-    return -1;
+/**
+ * Print the carrier acquisition result
+ * @param ds  Demodulator state
+ */
+static void demod_stream_report_acq(const DemodStream* ds) {
+  const AcqState* acq = &ds->acq;
+  if (!acq->len || !acq->done) return;
+  if (acq->found) {
+    printf("Carrier acquisition: %+.6f rad/sample (line %.1f dB)\n",
+           acq->freq, acq->line_db);
+  } else {
+    printf("Carrier acquisition: no line (%.1f dB), loops start at 0\n",
+           acq->line_db);
   }
+  if (acq->period) printf("Re-acquisitions: %u\n", acq->reacqs);
+}
 
-  memcpy(current, in, in_len);
+/**
+ * Initialize the streaming blind processing chain
+ * @param bs  State to initialize
+ */
+static void blind_stream_init(BlindStream* bs) {
+  memset(bs, 0, sizeof(*bs));
 
-  /* Stage 1: Convolutional (Viterbi) decoding */
 #if ENABLE_CONVOLUTION
-  printf("  [CONV] Enabled - decoding...\n");
-  int packed_len = current_len / 8;
-  unsigned char* packed_input = (unsigned char*)malloc(packed_len);
-  unsigned char* conv_output = (unsigned char*)malloc(packed_len / 2);
-  bitsToBytes(current, packed_input, current_len);
-  convolutional_decode_viterbi(packed_input, conv_output, packed_len);
-  current_len = packed_len / 2;
-  memcpy(temp1, conv_output, current_len);
-  free(packed_input);
-  free(conv_output);
+  printf("  [CONV] Not available in streaming mode - skipping\n");
 #else
   printf("  [CONV] Disabled - skipping\n");
-  bitsToBytes(current, temp1, current_len);
-  current_len = current_len / 8;
 #endif
-
-  /* Stage 2: NRZ-M differential decoding */
 #if ENABLE_NRZM
   printf("  [NRZM] Enabled - decoding...\n");
-  nrzm_decode(temp1, temp2, current_len, 0);
-  memcpy(temp1, temp2, current_len);
 #else
   printf("  [NRZM] Disabled - skipping\n");
 #endif
-
-  /* Stage 3: PSR (pseudo-random) descrambling */
 #if ENABLE_PSR
   printf("  [PSR]  Enabled - descrambling...\n");
-#ifdef __cplusplus
+  /* process_blind() descrambles the first frame slot of the stream */
   Scrambler s;
-  s.Scramble(&temp1[4]);
-#else
-  printf("  [PSR]  Warning: PSR requires C++, skipping...\n");
-#endif
+  s.Scramble(bs->psr_seq);
 #else
   printf("  [PSR]  Disabled - skipping\n");
 #endif
-
-  /* Convert back to bits */
-  int out_len = current_len * 8;
-  bytesToBits(temp1, out, current_len);
-
-  free(temp1);
-  free(temp2);
-  free(current);
-
-  return out_len;
 }
 
-/* *****************************************************************************
- *
- *                         DEMODULATION LOOPS - BPSK
- *
- * *****************************************************************************/
-
 /**
- * Run BPSK demodulation with Costas carrier recovery and M&M timing recovery
+ * Apply the blind processing chain to a block of demodulated bits
  *
- * @param sig          Input signal array
- * @param N            Signal length
- * @param current_sps  Samples per symbol
- * @param cfg          Configuration parameters
- * @param costas_out   Output: carrier-corrected signal (caller frees)
- * @param syms_out     Output: recovered symbols (caller frees)
- * @param nsyms        Output: number of symbols
- * @param freq_log     Output: frequency log (caller frees, NULL if quiet)
- * @param sps_log      Output: SPS log (caller frees, NULL if quiet)
- * @param nlog         Output: log length
- * @param quiet        If non-zero, suppress output and skip logging
+ * Matches process_blind() on the concatenated stream: NRZ-M state is
+ * carried across blocks and only whole bytes are emitted.
+ *
+ * @param bs   Blind chain state
+ * @param in   Input bits (unpacked)
+ * @param n    Number of input bits
+ * @param out  Output bits (capacity n + 7)
+ * @return Number of output bits
  */
-void run_loops_bpsk(cplxf* sig, size_t N, float current_sps, Config* cfg,
-                    cplxf** costas_out, float** syms_out, size_t* nsyms,
-                    float** freq_log, float** sps_log, size_t* nlog,
-                    int quiet) {
-  if (!quiet) {
-    printf("\n--- STEP 2: RUNNING BPSK LOOPS (Costas + Mueller) ---\n");
-  }
-
-  cplxf* costas_buf = (cplxf*)malloc(N * sizeof(cplxf));
-  int save_costas = !quiet;
-
-  if (save_costas) {
-    *freq_log = (float*)malloc(N * sizeof(float));
-  } else {
-    *freq_log = NULL;
-  }
+static size_t blind_stream_process(BlindStream* bs, const unsigned char* in,
+                                   size_t n, unsigned char* out) {
+  size_t total = (size_t)bs->npend + n;
+  size_t nout = total - total % 8;
 
-  /*
-   * BPSK Costas Loop - Carrier Recovery
-   * Phase detector: sign(I) * Q
-   */
-  double phase = 0.0, freq = 0.0;
-
-  for (size_t k = 0; k < N; k++) {
-    cplxf out = cplxf_mul(sig[k], cplxf_exp_i_d(-phase));
-
-    /* BPSK phase error detector */
-    double err = (double)copysignf(1.0f, out.re) * (double)out.im;
+  for (size_t i = 0; i < nout; i++) {
+    unsigned char b =
+        i < (size_t)bs->npend ? bs->pend[i] : in[i - (size_t)bs->npend];
 
-    /* Update loop filter */
-    freq += (double)cfg->costas_beta * err;
-    phase += freq + (double)cfg->costas_alpha * err;
+#if ENABLE_NRZM
+    unsigned char d = b ^ (unsigned char)bs->nrzm_prev;
+    bs->nrzm_prev = b;
+    b = d;
+#endif
 
-    /* Wrap phase */
-    while (phase > M_PI) phase -= 2.0 * M_PI;
-    while (phase < -M_PI) phase += 2.0 * M_PI;
+#if ENABLE_PSR
+    uint64_t p = bs->bit_pos + i;
+    if (p >= SYNC_BITS && p < SYNC_BITS + sizeof(bs->psr_seq) * 8) {
+      size_t q = (size_t)(p - SYNC_BITS);
+      b ^= (bs->psr_seq[q / 8] >> (7 - q % 8)) & 1;
+    }
+#endif
 
-    costas_buf[k] = out;
-    if (save_costas) (*freq_log)[k] = (float)freq;
+    out[i] = b;
   }
 
-  *costas_out = costas_buf;
-
-  /* Extract I channel for timing recovery */
-  float* i_channel = (float*)malloc(N * sizeof(float));
-  for (size_t k = 0; k < N; k++) {
-    i_channel[k] = costas_buf[k].re;
+  /* Keep the bits that do not fill a byte yet */
+  size_t left = total - nout;
+  unsigned char keep[8];
+  for (size_t i = 0; i < left; i++) {
+    size_t src = nout + i;
+    keep[i] =
+        src < (size_t)bs->npend ? bs->pend[src] : in[src - (size_t)bs->npend];
   }
+  memcpy(bs->pend, keep, left);
+  bs->npend = (int)left;
+  bs->bit_pos += nout;
 
-  /*
-   * Mueller & Müller Timing Loop - Symbol Recovery
-   */
-  double sps_est = (double)current_sps;
-  double idx = sps_est;
-  size_t initial_capacity = quiet ? 50000 : 100000;
-
-  FloatBuffer* sym_buf = float_buffer_create(initial_capacity);
-  FloatBuffer* sps_buf =
-      save_costas ? float_buffer_create(initial_capacity) : NULL;
-
-  float prev_sym = 0.0f, prev_dec = 0.0f;
-  int first = 1;
-
-  const double sps_nom = (double)current_sps;
-  const double sps_min = 0.50 * sps_nom;
-  const double sps_max = 1.50 * sps_nom;
-  const double min_step = 0.10; /* Minimum forward progress */
-
-  /* Safety limit to prevent infinite loops */
-  size_t max_iters = (size_t)((double)N / fmax(sps_nom, 1e-6)) * 4 + 1000;
-  size_t iters = 0;
+  return nout;
+}
 
-  while (idx < (double)N - sps_est - 5.0) {
-    if (++iters > max_iters) {
-      break; /* Bad parameter combo - bail out */
-    }
+/**
+ * Make sure the per-block bit buffers can hold n bits
+ *
+ * @param sp  Streaming pipeline
+ * @param n   Number of bits
+ */
+static void stream_bits_reserve(StreamPipeline* sp, size_t n) {
+  if (n + 8 <= sp->bits_cap) return;
+  sp->bits_cap = (n + 8) * 2;
+  sp->bits = (unsigned char*)realloc(sp->bits, sp->bits_cap);
+  sp->proc = (unsigned char*)realloc(sp->proc, sp->bits_cap);
+}
 
-    float sym = interpolate_sample_f(i_channel, N, idx);
-    float_buffer_append(sym_buf, sym);
+/**
+ * Keep the most recent symbols for the final EVM estimate
+ *
+ * @param sp   Streaming pipeline
+ * @param sym  Recovered symbol (BPSK uses .re)
+ */
+static void stream_evm_push(StreamPipeline* sp, cplxf sym) {
+  if (sp->evm_cap == 0) return;
+  sp->evm_ring[sp->evm_head] = sym;
+  if (++sp->evm_head == sp->evm_cap) sp->evm_head = 0;
+  if (sp->evm_fill < sp->evm_cap) sp->evm_fill++;
+}
 
-    if (first) {
-      prev_sym = sym;
-      prev_dec = slicer_bpsk(sym);
-      first = 0;
-      if (save_costas) float_buffer_append(sps_buf, (float)sps_est);
-      idx += sps_est;
-      continue;
+/**
+ * Demodulate, bit-slice, descramble and frame-sync one front-end block
+ *
+ * @param sp     Streaming pipeline
+ * @param in     Front-end output samples
+ * @param n      Number of samples
+ * @param final  Non-zero for the last block of the stream
+ * @param cfg    Configuration parameters
+ */
+static void stream_pipeline_consume(StreamPipeline* sp, const cplxf* in,
+                                    size_t n, int final, const Config* cfg) {
+  demod_stream_process(&sp->demod, in, n, cfg);
+  if (final) demod_stream_flush(&sp->demod, cfg);
+
+  /* Symbols -> bits, keeping the EVM tail */
+  size_t nsyms;
+  size_t nbits;
+  if (cfg->modulation == MOD_BPSK) {
+    FloatBuffer* sb = sp->demod.syms_bpsk;
+    nsyms = sb->len;
+    nbits = nsyms;
+    stream_bits_reserve(sp, nbits);
+    for (size_t i = 0; i < nsyms; i++) {
+      sp->bits[i] = sb->data[i] >= 0 ? 1 : 0;
+      stream_evm_push(sp, cplxf_make(sb->data[i], 0.0f));
     }
-
-    float dec = slicer_bpsk(sym);
-
-    /* M&M timing error detector for BPSK */
-    double err =
-        (double)prev_dec * (double)sym - (double)dec * (double)prev_sym;
-
-    if (!isfinite(err) || !isfinite(sps_est) || !isfinite(idx)) {
-      break;
+    sb->len = 0;
+  } else {
+    SignalBuffer* sb = sp->demod.syms_qpsk;
+    nsyms = sb->len;
+    nbits = nsyms * 2;
+    stream_bits_reserve(sp, nbits);
+    for (size_t i = 0; i < nsyms; i++) {
+      sp->bits[i * 2] = sb->data[i].re >= 0 ? 1 : 0;
+      sp->bits[i * 2 + 1] = sb->data[i].im >= 0 ? 1 : 0;
+      stream_evm_push(sp, sb->data[i]);
     }
+    sb->len = 0;
+  }
+  sp->total_syms += nsyms;
+  sp->total_bits += nbits;
 
-    /* Update SPS estimate */
-    sps_est += (double)cfg->timing_beta * err;
-
-    /* Clamp SPS */
-    if (sps_est < sps_min) sps_est = sps_min;
-    if (sps_est > sps_max) sps_est = sps_max;
-
-    /* Calculate step */
-    double step = sps_est + (double)cfg->timing_alpha * err;
-    if (!isfinite(step) || step < min_step) step = min_step;
-    idx += step;
-
-    if (save_costas) float_buffer_append(sps_buf, (float)sps_est);
-
-    prev_sym = sym;
-    prev_dec = dec;
+  /* Blind processing chain */
+  size_t nproc = blind_stream_process(&sp->blind, sp->bits, nbits, sp->proc);
+  sp->total_proc += nproc;
 
-    if (!isfinite(idx) || !isfinite(sps_est)) {
-      printf("Timing loop blew up (idx/sps not finite). Breaking.\n");
-      break;
+  if (sp->bits_file) {
+    for (size_t i = 0; i < nproc; i++) {
+      fputc(sp->proc[i] ? '1' : '0', sp->bits_file);
     }
   }
 
-  printf("timing continues %f \n", sps_est);
-
-  free(i_channel);
-
-  *syms_out = sym_buf->data;
-  *nsyms = sym_buf->len;
-  free(sym_buf);
-
-  if (save_costas) {
-    *sps_log = sps_buf->data;
-    *nlog = sps_buf->len;
-    free(sps_buf);
-  } else {
-    *sps_log = NULL;
-    *nlog = 0;
-  }
+  /* Frame sync & RS decode */
+  frame_sync_push(&sp->sync, sp->proc, nproc, final);
 }
 
-/* *****************************************************************************
- *
- *                         DEMODULATION LOOPS - OQPSK
- *
- * *****************************************************************************/
-
 /**
- * Run OQPSK demodulation with Costas carrier recovery and M&M timing recovery
+ * Run the whole demodulator in bounded memory, one block at a time
  *
- * @param sig          Input signal array
- * @param N            Signal length
- * @param current_sps  Samples per symbol
- * @param cfg          Configuration parameters
- * @param costas_out   Output: carrier-corrected signal (caller frees)
- * @param syms_out     Output: recovered symbols (caller frees)
- * @param nsyms        Output: number of symbols
- * @param freq_log     Output: frequency log (caller frees, NULL if quiet)
- * @param sps_log      Output: SPS log (caller frees, NULL if quiet)
- * @param nlog         Output: log length
- * @param quiet        If non-zero, suppress output and skip logging
+ * The capture is read in cfg->block_samples chunks and every stage keeps
+ * its state between chunks (filter history, decimation phase, loop state,
+ * NRZ-M state, partially received frames), so frames are reported as soon
+ * as they are complete and memory use does not depend on capture length.
+ *
+ * @param cfg  Configuration parameters
+ * @return Process exit code
  */
-void run_loops(cplxf* sig, size_t N, float current_sps, Config* cfg,
-               cplxf** costas_out, cplxf** syms_out, size_t* nsyms,
-               float** freq_log, float** sps_log, size_t* nlog, int quiet) {
-  if (!quiet) {
-    printf("\n--- STEP 2: RUNNING OQPSK LOOPS (Costas + Mueller) ---\n");
+static int run_streaming(Config* cfg) {
+  printf("--- STREAMING MODE (block: %d samples) ---\n", cfg->block_samples);
+
+  IqSource src;
+  if (ingest_open(&src, cfg) != 0) return 1;
+  int live = src.live != NULL;
+  if (live) {
+    printf("   Live input: %s (%s format, %s kernels, %.1f MB ring)\n",
+           cfg->input_file, format_name(cfg->input_format), dsp_simd_level(),
+           (double)IQ_LIVE_RING_BYTES / (1 << 20));
   }
-
-  cplxf* costas_buf = (cplxf*)malloc(N * sizeof(cplxf));
-  int save_costas = !quiet;
-
-  if (save_costas) {
-    *freq_log = (float*)malloc(N * sizeof(float));
-  } else {
-    *freq_log = NULL;
+  if (ingest_select_range(&src, cfg) != 0) {
+    iq_source_close(&src);
+    return 1;
+  }
+  if (!live) {
+    printf("   Mapped %zu IQ samples (%s format, %s kernels)\n",
+           (size_t)src.n_samples, format_name(cfg->input_format),
+           dsp_simd_level());
+    ingest_setup_io(&src, cfg, (size_t)cfg->block_samples);
   }
 
-  /*
-   * QPSK Costas Loop - Carrier Recovery
-   * Phase detector: sign(I)*Q - sign(Q)*I
-   */
-  double phase = 0.0, freq = 0.0;
+  StreamPipeline sp;
+  memset(&sp, 0, sizeof(sp));
 
-  for (size_t k = 0; k < N; k++) {
-    cplxf out = cplxf_mul(sig[k], cplxf_exp_i_d(-phase));
+  if (cfg->q15) printf("   [Q15] Whole-file mode only - using float\n");
+  float final_sps;
+  front_end_stream_init(&sp.fe, cfg, &final_sps);
+  demod_stream_init(&sp.demod, cfg, final_sps, 0);
 
-    /* QPSK phase error detector */
-    double err = (double)copysignf(1.0f, out.re) * (double)out.im -
-                 (double)copysignf(1.0f, out.im) * (double)out.re;
+  printf("\n--- STREAMING: LOOPS / BLIND / FRAME SYNC (0x1ACFFC1D) ---\n");
+  blind_stream_init(&sp.blind);
+  frame_sync_init(&sp.sync);
 
-    /* Update loop filter */
-    freq += (double)cfg->costas_beta * err;
-    phase += freq + (double)cfg->costas_alpha * err;
+  /* EVM is taken over the last symbols, as in whole-file mode */
+  sp.evm_cap = (size_t)(cfg->evm_last_syms > 0 ? cfg->evm_last_syms
+                                               : DEFAULT_EVM_LAST_SYMS);
+  sp.evm_ring = (cplxf*)malloc(sp.evm_cap * sizeof(cplxf));
 
-    /* Wrap phase */
-    while (phase > M_PI) phase -= 2.0 * M_PI;
-    while (phase < -M_PI) phase += 2.0 * M_PI;
+  sp.bits_file = fopen("output_bits.txt", "w");
 
-    costas_buf[k] = out;
-    if (save_costas) (*freq_log)[k] = (float)freq;
-  }
+  size_t out_cap = front_end_stream_max_out(&sp.fe, (size_t)cfg->block_samples);
+  cplxf* fe_out = (cplxf*)malloc(out_cap * sizeof(cplxf));
 
-  *costas_out = costas_buf;
+  for (;;) {
+    const void* raw = NULL;
+    size_t got = iq_source_next(&src, (size_t)cfg->block_samples, &raw);
+    int final = (got == 0);
 
-  /*
-   * Mueller & Müller Timing Loop - Symbol Recovery
-   * For OQPSK: I and Q sampled with half-symbol offset
-   */
-  double sps_est = (double)current_sps;
-  double idx = 0.0;
-  size_t initial_capacity = quiet ? 50000 : 100000;
+    size_t n = front_end_stream_process(&sp.fe, raw, got, final, fe_out);
+    stream_pipeline_consume(&sp, fe_out, n, final, cfg);
 
-  SignalBuffer* sym_buf = signal_buffer_create(initial_capacity);
-  FloatBuffer* sps_buf =
-      save_costas ? float_buffer_create(initial_capacity) : NULL;
+    if (final) break;
+  }
+  int read_failed = iq_source_error(&src);
+
+  if (live) {
+    IqLiveStats st;
+    iq_live_stats(src.live, &st);
+    printf("\n--- LIVE INPUT ---\n");
+    printf("Received: %llu packets, %llu bytes\n",
+           (unsigned long long)st.packets, (unsigned long long)st.bytes);
+    printf("Overflow: %llu packets (%llu bytes) dropped, %llu ring-full waits\n",
+           (unsigned long long)st.dropped_packets,
+           (unsigned long long)st.dropped_bytes,
+           (unsigned long long)st.full_waits);
+  }
+  iq_source_close(&src);
+  if (sp.bits_file) fclose(sp.bits_file);
 
-  int first = 1;
-  cplxf prev_sym = cplxf_make(0.0f, 0.0f);
-  cplxf prev_dec = cplxf_make(0.0f, 0.0f);
-  const float sps_nom = current_sps;
+  printf("\n--- DEMODULATED ---\n");
+  printf("Symbols: %zu\n", (size_t)sp.total_syms);
+  printf("Bits: %zu (%d bit%s/symbol)\n", (size_t)sp.total_bits,
+         cfg->modulation == MOD_BPSK ? 1 : 2,
+         cfg->modulation == MOD_BPSK ? "" : "s");
+  printf("Output: %zu bits\n", (size_t)sp.total_proc);
+  if (sp.bits_file) printf("Saved to output_bits.txt\n");
+  demod_stream_report_acq(&sp.demod);
+
+  frame_sync_summary(&sp.sync);
+
+  double pwr_raw_w =
+      sp.fe.n_raw ? (double)(sp.fe.pwr_raw_acc / (long double)sp.fe.n_raw /
+                             (long double)cfg->rload)
+                  : 0.0;
+  double pwr_post_w =
+      sp.fe.n_post ? (double)(sp.fe.pwr_post_acc / (long double)sp.fe.n_post /
+                              (long double)cfg->rload)
+                   : 0.0;
+  printf("\n=== POWER (measured from voltage samples) ===\n");
+  printf("Ptot_raw  : %.6e W (%.2f dBm)\n", pwr_raw_w, watt_to_dbm(pwr_raw_w));
+  printf("Ptot_post : %.6e W (%.2f dBm)\n", pwr_post_w,
+         watt_to_dbm(pwr_post_w));
 
-  while (idx < (double)N - sps_est - 5.0) {
-    /* OQPSK: I and Q with half-symbol offset */
-    cplxf i_sample = interpolate_sample(costas_buf, N, idx);
-    cplxf q_sample = interpolate_sample(costas_buf, N, idx + sps_est / 2.0);
-    cplxf sym = cplxf_make(i_sample.re, q_sample.im);
-
-    signal_buffer_append(sym_buf, sym);
-
-    if (first) {
-      prev_sym = sym;
-      prev_dec = slicer_qpsk(sym);
-      first = 0;
-      if (save_costas) float_buffer_append(sps_buf, (float)sps_est);
-      idx += sps_est;
-      continue;
+  /* EVM over the retained tail, skipping the acquisition transient */
+  if (sp.total_syms > (uint64_t)cfg->evm_skip_syms + 1000) {
+    size_t evm_n = sp.evm_fill;
+    uint64_t avail = sp.total_syms - (uint64_t)cfg->evm_skip_syms;
+    if ((uint64_t)evm_n > avail) evm_n = (size_t)avail;
+
+    /* Unroll the ring, oldest symbol first */
+    cplxf* tail = (cplxf*)malloc(evm_n * sizeof(cplxf));
+    size_t first = (sp.evm_head + sp.evm_cap - evm_n) % sp.evm_cap;
+    for (size_t i = 0; i < evm_n; i++) {
+      tail[i] = sp.evm_ring[(first + i) % sp.evm_cap];
     }
 
-    cplxf dec = slicer_qpsk(sym);
-
-    /* M&M timing error detector */
-    double term1 = (double)prev_dec.re * (double)sym.re +
-                   (double)prev_dec.im * (double)sym.im;
-    double term2 = (double)dec.re * (double)prev_sym.re +
-                   (double)dec.im * (double)prev_sym.im;
-    double err = term1 - term2;
-
-    /* Update SPS estimate */
-    sps_est += (double)cfg->timing_beta * err;
-
-    /* Clamp SPS */
-    double sps_min = 0.5 * (double)sps_nom;
-    double sps_max = 1.5 * (double)sps_nom;
-    if (sps_est < sps_min) sps_est = sps_min;
-    if (sps_est > sps_max) sps_est = sps_max;
-
-    /* Calculate step */
-    double step = sps_est + (double)cfg->timing_alpha * err;
-    if (step < 0.10) step = 0.10;
-    idx += step;
-
-    if (save_costas) float_buffer_append(sps_buf, (float)sps_est);
+    float evm;
+    if (cfg->modulation == MOD_BPSK) {
+      float* tail_f = (float*)malloc(evm_n * sizeof(float));
+      for (size_t i = 0; i < evm_n; i++) tail_f[i] = tail[i].re;
+      evm = evm_decision_directed_bpsk(tail_f, evm_n);
+      free(tail_f);
+    } else {
+      evm = evm_decision_directed_qpsk(tail, evm_n);
+    }
+    free(tail);
 
-    prev_sym = sym;
-    prev_dec = dec;
+    report_evm(cfg, evm, pwr_post_w);
   }
 
-  *syms_out = sym_buf->data;
-  *nsyms = sym_buf->len;
-  free(sym_buf);
-
-  if (save_costas) {
-    *sps_log = sps_buf->data;
-    *nlog = sps_buf->len;
-    free(sps_buf);
-  } else {
-    *sps_log = NULL;
-    *nlog = 0;
+  free(fe_out);
+  free(sp.evm_ring);
+  free(sp.bits);
+  free(sp.proc);
+  frame_sync_free(&sp.sync);
+  demod_stream_free(&sp.demod);
+  front_end_stream_free(&sp.fe);
+
+  if (read_failed) {
+    fflush(stdout);
+    fprintf(stderr, "Error: Reading %s failed; the results above cover "
+            "only the samples read before it\n", cfg->input_file);
+    return 1;
   }
+  return 0;
 }
 
 /* *****************************************************************************
@@ -1783,10 +6213,25 @@ int main(int argc, char** argv) {
 
   /* Parse command-line arguments */
   config_parse_args(&cfg, argc, argv);
+  if (config_apply_sigmf(&cfg) != 0) return 1;
+  dsp_simd_limit(cfg.simd_level);
+  dsp_conv_mode(cfg.conv_mode);
+  if (cfg.threads <= 0) cfg.threads = dsp_pool_cpu_count();
+
+  /* Live input has no known length: only the streaming pipeline takes it */
+  if (iq_live_is_spec(cfg.input_file) && !cfg.stream_mode) {
+    printf("Live input: using streaming mode\n");
+    cfg.stream_mode = 1;
+  }
 
   /* Print configuration summary */
   config_print(&cfg);
 
+  /* Bounded-memory block streaming runs the whole chain per block */
+  if (cfg.stream_mode) {
+    return run_streaming(&cfg);
+  }
+
   /* =========================================================================
    * STEP 1: Load and preprocess signal
    * =========================================================================
@@ -1810,10 +6255,8 @@ int main(int argc, char** argv) {
    * STEP 2: Demodulation (Costas + Timing Recovery)
    * =========================================================================
    */
-  cplxf* costas = NULL;
   cplxf* syms_qpsk = NULL;
   float* syms_bpsk = NULL;
-  float* freq_log = NULL;
   float* sps_log = NULL;
   size_t nsyms = 0, nlog = 0;
 
@@ -1857,11 +6300,10 @@ int main(int argc, char** argv) {
           float evm = 1000.0f;
 
           if (cfg.modulation == MOD_BPSK) {
-            cplxf* tc;
-            float *ts, *tfl, *tsl;
+            float *ts, *tsl;
             size_t tns, tnl;
-            run_loops_bpsk(sig, sig_len, final_sps, &test_cfg, &tc, &ts, &tns,
-                           &tfl, &tsl, &tnl, 1);
+            run_loops_bpsk(sig, sig_len, final_sps, &test_cfg, &ts, &tns, &tsl,
+                           &tnl, 1);
             if (tns > (size_t)cfg.evm_skip_syms + 1000) {
               size_t start = cfg.evm_skip_syms;
               if (cfg.evm_last_syms > 0 &&
@@ -1869,16 +6311,14 @@ int main(int argc, char** argv) {
                 start = tns - cfg.evm_last_syms;
               evm = evm_decision_directed_bpsk(ts + start, tns - start);
             }
-            free(tc);
             free(ts);
-            if (tfl) free(tfl);
             if (tsl) free(tsl);
           } else {
-            cplxf *tc, *ts;
-            float *tfl, *tsl;
+            cplxf* ts;
+            float* tsl;
             size_t tns, tnl;
-            run_loops(sig, sig_len, final_sps, &test_cfg, &tc, &ts, &tns, &tfl,
-                      &tsl, &tnl, 1);
+            run_loops(sig, sig_len, final_sps, &test_cfg, &ts, &tns, &tsl, &tnl,
+                      1);
             if (tns > (size_t)cfg.evm_skip_syms + 1000) {
               size_t start = cfg.evm_skip_syms;
               if (cfg.evm_last_syms > 0 &&
@@ -1886,9 +6326,7 @@ int main(int argc, char** argv) {
                 start = tns - cfg.evm_last_syms;
               evm = evm_decision_directed_qpsk(ts + start, tns - start);
             }
-            free(tc);
             free(ts);
-            if (tfl) free(tfl);
             if (tsl) free(tsl);
           }
 
@@ -1926,11 +6364,11 @@ int main(int argc, char** argv) {
 
   /* Run final demodulation */
   if (cfg.modulation == MOD_BPSK) {
-    run_loops_bpsk(sig, sig_len, final_sps, &cfg, &costas, &syms_bpsk, &nsyms,
-                   &freq_log, &sps_log, &nlog, 0);
+    run_loops_bpsk(sig, sig_len, final_sps, &cfg, &syms_bpsk, &nsyms,
+                   &sps_log, &nlog, 0);
   } else {
-    run_loops(sig, sig_len, final_sps, &cfg, &costas, &syms_qpsk, &nsyms,
-              &freq_log, &sps_log, &nlog, 0);
+    run_loops(sig, sig_len, final_sps, &cfg, &syms_qpsk, &nsyms, &sps_log,
+              &nlog, 0);
   }
 
   printf("---bruh---");
@@ -2006,112 +6444,10 @@ int main(int argc, char** argv) {
      */
     printf("\n--- FRAME SYNC & RS DECODE (0x1ACFFC1D) ---\n");
 
-    /* CCSDS sync word: 0x1ACFFC1D in bit form (MSB first) */
-    const unsigned char sync_pattern[32] = {
-        0, 0, 0, 1, 1, 0, 1, 0, /* 0x1A */
-        1, 1, 0, 0, 1, 1, 1, 1, /* 0xCF */
-        1, 1, 1, 1, 1, 1, 0, 0, /* 0xFC */
-        0, 0, 0, 1, 1, 1, 0, 1  /* 0x1D */
-    };
-
-    static int last_error_counter_rs = 0;
-    int tm_ok_count = 0;
-    int tm_bad_count = 0;
-    int frame_count = 0;
-
-    /* Search for sync and process frames */
-    int offset = 0;
-    while (offset <= processed_len - FRAME_SIZE_BITS) {
-      /* Find sync word */
-      int sync_found = -1;
-      for (int i = offset; i <= processed_len - FRAME_SIZE_BITS; i++) {
-        int match = 1;
-        for (int j = 0; j < SYNC_BITS && match; j++) {
-          if (processed_bits[i + j] != sync_pattern[j]) {
-            match = 0;
-          }
-        }
-        if (match) {
-          sync_found = i;
-          break;
-        }
-      }
-
-      if (sync_found < 0) {
-        printf("No more sync words found.\n");
-        break;
-      }
-
-      frame_count++;
-      printf("Frame %d: Sync at bit %d", frame_count, sync_found);
-
-      /* Check if we have enough bits for a full frame */
-      if (sync_found + FRAME_SIZE_BITS > processed_len) {
-        printf(" - Incomplete frame, skipping.\n");
-        break;
-      }
-
-      /* Pack bits to bytes (1279 bytes = 10232 bits) */
-      unsigned char frame_bytes[FRAME_SIZE_BYTES];
-      bitsToBytes(&processed_bits[sync_found], frame_bytes, FRAME_SIZE_BITS);
-
-      /* Create working buffer for RS decode */
-      unsigned char tempBuffer[FRAME_SIZE_BYTES];
-      memcpy(tempBuffer, frame_bytes, FRAME_SIZE_BYTES);
-
-      /* Descramble (skip first 4 bytes - sync word) */
-#ifdef __cplusplus
-      Scrambler s;
-      s.Scramble(&tempBuffer[4]);
-#endif
-
-      /* Reed-Solomon decode */
-      int msgSize = FRAME_SIZE_BYTES;
-      int error_counter_rs = ccsds_decode_rs(tempBuffer, msgSize);
-
-      if (error_counter_rs == last_error_counter_rs) {
-        /* RS decode successful */
-        msgSize -= 4; /* Remove sync word (4 bytes) */
-
-        unsigned char TM_Frame_buffer[FRAME_SIZE_BYTES];
-        memmove(TM_Frame_buffer, tempBuffer + 4, msgSize);
-
-        msgSize -=
-            160; /* Remove RS parity bytes (160 bytes for interleave=5) */
-
-        printf(" - RS OK, TM size = %d bytes\n", msgSize);
-
-        /* Print the entire TM frame in hex */
-        printf("================== TM FRAME %d ==================\n",
-               tm_ok_count + 1);
-        for (int i = 0; i < msgSize; i++) {
-          printf("%02X ", TM_Frame_buffer[i]);
-          if ((i + 1) % 32 == 0) {
-            printf("\n");
-          }
-        }
-        if (msgSize % 32 != 0) {
-          printf("\n");
-        }
-        printf("================================================\n\n");
-
-        tm_ok_count++;
-      } else {
-        last_error_counter_rs = error_counter_rs;
-        printf(" - RS FAILED (errors=%d)\n", error_counter_rs);
-        tm_bad_count++;
-      }
-
-      /* Move to next potential frame */
-      offset = sync_found + FRAME_SIZE_BITS;
-    }
-
-    printf("\n--- FRAME PROCESSING SUMMARY ---\n");
-    printf("Frames found:  %d\n", frame_count);
-    printf("TM OK:         %d\n", tm_ok_count);
-    printf("TM BAD:        %d\n", tm_bad_count);
-    printf("Success rate:  %.1f%%\n",
-           frame_count > 0 ? (100.0f * tm_ok_count / frame_count) : 0.0f);
+    FrameSync fsync;
+    frame_sync_init(&fsync);
+    frame_sync_scan(&fsync, processed_bits, (size_t)processed_len, 0, 1);
+    frame_sync_summary(&fsync);
   }
 
   /* =========================================================================
@@ -2125,70 +6461,11 @@ int main(int argc, char** argv) {
     }
     size_t evm_n = nsyms - start;
 
-
-
-       float evm = cfg.modulation == MOD_BPSK
+    float evm = cfg.modulation == MOD_BPSK
                     ? evm_decision_directed_bpsk(syms_bpsk + start, evm_n)
                     : evm_decision_directed_qpsk(syms_qpsk + start, evm_n);
 
-    printf("\n=== EVM (%s) ===\n",
-           cfg.modulation == MOD_BPSK ? "BPSK" : "OQPSK");
-    printf("EVM: %.4f%% (%.2f dB)\n", evm * 100.0f,
-           20.0f * log10f(evm + 1e-30f));
-    printf("SNR(rough): ~%.2f dB\n", -20.0f * log10f(evm + 1e-30f));
-
-    // ================= ENERGY / NOISE REPORT =================
-    {
-      const double bits_per_sym = (cfg.modulation == MOD_BPSK) ? 1.0 : 2.0;
-
-      // Bu kod tabanında cfg.rb pratikte "bit rate" gibi kullanılıyor (RRC'de
-      // rb/2 yapılmış).
-      const double Rb = (double)cfg.rb;     // bit/s
-      const double Rs = Rb / bits_per_sym;  // sym/s
-
-      const double alpha = (cfg.rrc_enable ? (double)cfg.rrc_alpha : 0.0);
-      const double Bocc =
-          Rs * (1.0 + alpha);  // Hz (two-sided, sizin eski çıktınızla uyumlu)
-
-      // EVM -> Es/N0 varsayımı (AWGN + iyi lock + iyi eşitleme varsayımı)
-      const double evm2 = (double)evm * (double)evm + 1e-30;
-      const double EsN0 = 1.0 / evm2;
-      const double EbN0 = EsN0 / bits_per_sym;
-
-      // Eb/N0 ile in-band SNR ilişkisi: SNR = (Eb/N0) * (Rb / Bocc)
-      const double SNR_lin = EbN0 * (Rb / (Bocc + 1e-30));
-
-      // Ölçtüğünüz toplam güçten (post) Psig ve Pn'i ayır (yaklaşık)
-      const double Ptot = pwr_post_w;
-      const double Psig = Ptot * (SNR_lin / (1.0 + SNR_lin));
-      const double Pn_inband = Ptot * (1.0 / (1.0 + SNR_lin));
-
-      // Enerjiler
-      const double Eb = Psig / (Rb + 1e-30);  // J/bit
-      const double Es = Psig / (Rs + 1e-30);  // J/sym
-
-      // Noise spectral density
-      const double N0 = Pn_inband / (Bocc + 1e-30);  // W/Hz (== J)
-
-      printf("\n=== ENERGY / NOISE (est.) ===\n");
-      printf("Rb            : %.3e bit/s\n", Rb);
-      printf("Rs            : %.3e sym/s\n", Rs);
-      printf("Bocc (est)    : %.3e Hz  (alpha=%.2f)\n", Bocc, alpha);
-
-      printf("Psig_post (est): %.6e W (%.2f dBm)\n", Psig, watt_to_dbm(Psig));
-      printf("Pn_inband (est): %.6e W (%.2f dBm)\n", Pn_inband,
-             watt_to_dbm(Pn_inband));
-      printf("N0 (est)      : %.6e W/Hz (%.2f dBm/Hz)\n", N0,
-             w_per_hz_to_dbm_per_hz(N0));
-
-      printf("Eb            : %.6e J/bit\n", Eb);
-      printf("Es            : %.6e J/sym\n", Es);
-
-      printf("Es/N0         : %.2f dB\n", 10.0 * log10(EsN0 + 1e-30));
-      printf("Eb/N0         : %.2f dB\n", 10.0 * log10(EbN0 + 1e-30));
-      printf("SNR_inband    : %.2f dB\n", 10.0 * log10(SNR_lin + 1e-30));
-    }
-
+    report_evm(&cfg, evm, pwr_post_w);
   }
 
   /* =========================================================================
@@ -2198,10 +6475,8 @@ int main(int argc, char** argv) {
   free(demod_bits);
   free(processed_bits);
   free(sig);
-  free(costas);
   if (syms_qpsk) free(syms_qpsk);
   if (syms_bpsk) free(syms_bpsk);
-  if (freq_log) free(freq_log);
   if (sps_log) free(sps_log);
 
   return 0;
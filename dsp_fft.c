@@ -0,0 +1,515 @@
+/*
+ * dsp_fft.c
+ *
+ *  Built-in FFT and overlap-save fast convolution.
+ *
+ *  The forward transform is decimation-in-frequency (natural order in,
+ *  bit-reversed out) and the inverse is decimation-in-time (bit-reversed
+ *  in, natural out), so a convolution never needs a bit-reversal pass: the
+ *  filter spectrum is simply kept in bit-reversed order too. Only the
+ *  stand-alone spectrum transform reorders its output.
+ */
+
+#include "dsp_fft.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dsp_simd.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* =============================================================================
+ * PLATFORM DETECTION
+ * =============================================================================
+ */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define DSP_X86 1
+#include <immintrin.h>
+#else
+#define DSP_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DSP_TARGET_SSE2 __attribute__((target("sse2")))
+#define DSP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DSP_TARGET_SSE2
+#define DSP_TARGET_AVX2
+#endif
+
+/* =============================================================================
+ * COST MODEL
+ * -----------------------------------------------------------------------------
+ * Relative cost of one direct-form tap per output (plain and folded
+ * symmetric kernels), and of one complex radix-2 butterfly, per SIMD level
+ * (scalar, SSE2, AVX2, AVX-512). Measured on the kernels of this file and
+ * dsp_simd.c; only the ratios matter.
+ * =============================================================================
+ */
+static const float k_cost_tap[4] = {1.00f, 0.30f, 0.15f, 0.11f};
+static const float k_cost_tap_sym[4] = {0.66f, 0.20f, 0.15f, 0.11f};
+static const float k_cost_bfly[4] = {4.00f, 2.00f, 1.60f, 1.55f};
+
+static int g_conv_mode = DSP_CONV_AUTO;
+
+/* *****************************************************************************
+ *
+ *                         FFT STAGES - SCALAR
+ *
+ * *****************************************************************************/
+
+/*
+ * One radix-2 stage over split arrays: n points in blocks of 2*h, twiddle
+ * w[j] = exp(-i*pi*j/h) applied to the second half of each block. The
+ * h == 1 stage has w = 1 and skips the multiply (same result).
+ */
+
+/**
+ * Decimation-in-frequency stage: a' = a + b, b' = (a - b) * w
+ */
+static void dif_stage_scalar(float* re, float* im, size_t n, size_t h,
+                             const float* wr, const float* wi) {
+  for (size_t b = 0; b < n; b += 2 * h) {
+    float* ar = re + b;
+    float* ai = im + b;
+    float* cr = ar + h;
+    float* ci = ai + h;
+    for (size_t j = 0; j < h; j++) {
+      float dr = ar[j] - cr[j];
+      float di = ai[j] - ci[j];
+      ar[j] = ar[j] + cr[j];
+      ai[j] = ai[j] + ci[j];
+      if (h == 1) {
+        cr[j] = dr;
+        ci[j] = di;
+      } else {
+        cr[j] = dr * wr[j] - di * wi[j];
+        ci[j] = dr * wi[j] + di * wr[j];
+      }
+    }
+  }
+}
+
+/**
+ * Decimation-in-time stage: t = b * w, a' = a + t, b' = a - t
+ */
+static void dit_stage_scalar(float* re, float* im, size_t n, size_t h,
+                             const float* wr, const float* wi) {
+  for (size_t b = 0; b < n; b += 2 * h) {
+    float* ar = re + b;
+    float* ai = im + b;
+    float* cr = ar + h;
+    float* ci = ai + h;
+    for (size_t j = 0; j < h; j++) {
+      float tr = cr[j];
+      float ti = ci[j];
+      if (h != 1) {
+        tr = cr[j] * wr[j] - ci[j] * wi[j];
+        ti = cr[j] * wi[j] + ci[j] * wr[j];
+      }
+      cr[j] = ar[j] - tr;
+      ci[j] = ai[j] - ti;
+      ar[j] = ar[j] + tr;
+      ai[j] = ai[j] + ti;
+    }
+  }
+}
+
+/* *****************************************************************************
+ *
+ *                         FFT STAGES - SSE2 / AVX2
+ *
+ * *****************************************************************************/
+
+/*
+ * Vector stages run the j loop four (SSE2) or eight (AVX2) butterflies at
+ * a time, with the same operations as the scalar stage, so every level
+ * produces the same samples. Stages narrower than a vector use the scalar
+ * code. AVX-512 machines use the AVX2 stages: the butterflies are bound by
+ * the loads and stores, not by the vector width.
+ */
+#if DSP_X86
+
+DSP_TARGET_SSE2
+static void dif_stage_sse2(float* re, float* im, size_t n, size_t h,
+                           const float* wr, const float* wi) {
+  if (h < 4) {
+    dif_stage_scalar(re, im, n, h, wr, wi);
+    return;
+  }
+  for (size_t b = 0; b < n; b += 2 * h) {
+    float* ar = re + b;
+    float* ai = im + b;
+    float* cr = ar + h;
+    float* ci = ai + h;
+    for (size_t j = 0; j < h; j += 4) {
+      __m128 xr = _mm_loadu_ps(ar + j), xi = _mm_loadu_ps(ai + j);
+      __m128 yr = _mm_loadu_ps(cr + j), yi = _mm_loadu_ps(ci + j);
+      __m128 tr = _mm_loadu_ps(wr + j), ti = _mm_loadu_ps(wi + j);
+      __m128 dr = _mm_sub_ps(xr, yr), di = _mm_sub_ps(xi, yi);
+      _mm_storeu_ps(ar + j, _mm_add_ps(xr, yr));
+      _mm_storeu_ps(ai + j, _mm_add_ps(xi, yi));
+      _mm_storeu_ps(cr + j,
+                    _mm_sub_ps(_mm_mul_ps(dr, tr), _mm_mul_ps(di, ti)));
+      _mm_storeu_ps(ci + j,
+                    _mm_add_ps(_mm_mul_ps(dr, ti), _mm_mul_ps(di, tr)));
+    }
+  }
+}
+
+DSP_TARGET_SSE2
+static void dit_stage_sse2(float* re, float* im, size_t n, size_t h,
+                           const float* wr, const float* wi) {
+  if (h < 4) {
+    dit_stage_scalar(re, im, n, h, wr, wi);
+    return;
+  }
+  for (size_t b = 0; b < n; b += 2 * h) {
+    float* ar = re + b;
+    float* ai = im + b;
+    float* cr = ar + h;
+    float* ci = ai + h;
+    for (size_t j = 0; j < h; j += 4) {
+      __m128 xr = _mm_loadu_ps(ar + j), xi = _mm_loadu_ps(ai + j);
+      __m128 yr = _mm_loadu_ps(cr + j), yi = _mm_loadu_ps(ci + j);
+      __m128 wvr = _mm_loadu_ps(wr + j), wvi = _mm_loadu_ps(wi + j);
+      __m128 tr = _mm_sub_ps(_mm_mul_ps(yr, wvr), _mm_mul_ps(yi, wvi));
+      __m128 ti = _mm_add_ps(_mm_mul_ps(yr, wvi), _mm_mul_ps(yi, wvr));
+      _mm_storeu_ps(cr + j, _mm_sub_ps(xr, tr));
+      _mm_storeu_ps(ci + j, _mm_sub_ps(xi, ti));
+      _mm_storeu_ps(ar + j, _mm_add_ps(xr, tr));
+      _mm_storeu_ps(ai + j, _mm_add_ps(xi, ti));
+    }
+  }
+}
+
+DSP_TARGET_AVX2
+static void dif_stage_avx2(float* re, float* im, size_t n, size_t h,
+                           const float* wr, const float* wi) {
+  if (h < 8) {
+    dif_stage_sse2(re, im, n, h, wr, wi);
+    return;
+  }
+  for (size_t b = 0; b < n; b += 2 * h) {
+    float* ar = re + b;
+    float* ai = im + b;
+    float* cr = ar + h;
+    float* ci = ai + h;
+    for (size_t j = 0; j < h; j += 8) {
+      __m256 xr = _mm256_loadu_ps(ar + j), xi = _mm256_loadu_ps(ai + j);
+      __m256 yr = _mm256_loadu_ps(cr + j), yi = _mm256_loadu_ps(ci + j);
+      __m256 tr = _mm256_loadu_ps(wr + j), ti = _mm256_loadu_ps(wi + j);
+      __m256 dr = _mm256_sub_ps(xr, yr), di = _mm256_sub_ps(xi, yi);
+      _mm256_storeu_ps(ar + j, _mm256_add_ps(xr, yr));
+      _mm256_storeu_ps(ai + j, _mm256_add_ps(xi, yi));
+      _mm256_storeu_ps(
+          cr + j, _mm256_sub_ps(_mm256_mul_ps(dr, tr), _mm256_mul_ps(di, ti)));
+      _mm256_storeu_ps(
+          ci + j, _mm256_add_ps(_mm256_mul_ps(dr, ti), _mm256_mul_ps(di, tr)));
+    }
+  }
+}
+
+DSP_TARGET_AVX2
+static void dit_stage_avx2(float* re, float* im, size_t n, size_t h,
+                           const float* wr, const float* wi) {
+  if (h < 8) {
+    dit_stage_sse2(re, im, n, h, wr, wi);
+    return;
+  }
+  for (size_t b = 0; b < n; b += 2 * h) {
+    float* ar = re + b;
+    float* ai = im + b;
+    float* cr = ar + h;
+    float* ci = ai + h;
+    for (size_t j = 0; j < h; j += 8) {
+      __m256 xr = _mm256_loadu_ps(ar + j), xi = _mm256_loadu_ps(ai + j);
+      __m256 yr = _mm256_loadu_ps(cr + j), yi = _mm256_loadu_ps(ci + j);
+      __m256 wvr = _mm256_loadu_ps(wr + j), wvi = _mm256_loadu_ps(wi + j);
+      __m256 tr =
+          _mm256_sub_ps(_mm256_mul_ps(yr, wvr), _mm256_mul_ps(yi, wvi));
+      __m256 ti =
+          _mm256_add_ps(_mm256_mul_ps(yr, wvi), _mm256_mul_ps(yi, wvr));
+      _mm256_storeu_ps(cr + j, _mm256_sub_ps(xr, tr));
+      _mm256_storeu_ps(ci + j, _mm256_sub_ps(xi, ti));
+      _mm256_storeu_ps(ar + j, _mm256_add_ps(xr, tr));
+      _mm256_storeu_ps(ai + j, _mm256_add_ps(xi, ti));
+    }
+  }
+}
+
+#endif /* DSP_X86 */
+
+/* *****************************************************************************
+ *
+ *                         FFT DRIVER
+ *
+ * *****************************************************************************/
+
+typedef void (*FftStage)(float* re, float* im, size_t n, size_t h,
+                         const float* wr, const float* wi);
+
+/**
+ * Pick the widest stage kernels the dispatcher allows
+ */
+static void fft_stages(FftStage* dif, FftStage* dit) {
+  *dif = dif_stage_scalar;
+  *dit = dit_stage_scalar;
+#if DSP_X86
+  int f = dsp_cpu_features();
+  if (f & (DSP_CPU_AVX2 | DSP_CPU_AVX512)) {
+    *dif = dif_stage_avx2;
+    *dit = dit_stage_avx2;
+  } else if (f & DSP_CPU_SSE2) {
+    *dif = dif_stage_sse2;
+    *dit = dit_stage_sse2;
+  }
+#endif
+}
+
+/**
+ * Fill the twiddle table: the stage of half-size h uses entries h-1 ...
+ * 2h-2, so the whole table holds n-1 factors
+ */
+static void fft_twiddles(float* wr, float* wi, size_t n) {
+  for (size_t h = 1; h < n; h *= 2) {
+    for (size_t j = 0; j < h; j++) {
+      double a = -M_PI * (double)j / (double)h;
+      wr[h - 1 + j] = (float)cos(a);
+      wi[h - 1 + j] = (float)sin(a);
+    }
+  }
+}
+
+/**
+ * Forward transform, natural order in, bit-reversed order out
+ */
+static void fft_forward(FftStage dif, float* re, float* im, size_t n,
+                        const float* wr, const float* wi) {
+  for (size_t h = n / 2; h >= 1; h /= 2) {
+    dif(re, im, n, h, wr + h - 1, wi + h - 1);
+  }
+}
+
+/**
+ * Forward-sign transform, bit-reversed order in, natural order out
+ *
+ * Called with re and im swapped this is the inverse transform (times n):
+ * swapping the parts of x is i*conj(x), and the DFT of i*conj(x) is
+ * i*conj(n * IDFT(x)).
+ */
+static void fft_forward_dit(FftStage dit, float* re, float* im, size_t n,
+                            const float* wr, const float* wi) {
+  for (size_t h = 1; h < n; h *= 2) {
+    dit(re, im, n, h, wr + h - 1, wi + h - 1);
+  }
+}
+
+/* *****************************************************************************
+ *
+ *                         OVERLAP-SAVE FIR
+ *
+ * *****************************************************************************/
+
+struct DspFastFir {
+  size_t nfft;     /* FFT length                                  */
+  size_t ntaps;    /* Number of taps                              */
+  float* hr;       /* Filter spectrum / nfft, bit-reversed order  */
+  float* hi;
+  float* wr;       /* Twiddle table (nfft - 1 entries)            */
+  float* wi;
+  float* re;       /* Segment work arrays                         */
+  float* im;
+};
+
+/**
+ * log2 of a power of two
+ */
+static int ilog2(size_t n) {
+  int k = 0;
+  while (((size_t)1 << k) < n) k++;
+  return k;
+}
+
+/**
+ * Relative cost of one overlap-save output at a given FFT length
+ */
+static float fft_cost_per_output(size_t nfft, size_t ntaps, int level) {
+  size_t seg = nfft - ntaps + 1;
+  /* Two transforms of (n/2) log2 n butterflies, plus the spectrum product
+   * and the segment load/store (about one butterfly per point) */
+  float bfly = (float)nfft * (float)ilog2(nfft) + 1.5f * (float)nfft;
+  return bfly * k_cost_bfly[level] / (float)seg;
+}
+
+/**
+ * Active SIMD level as an index into the cost tables
+ */
+static int simd_level_index(void) {
+  int f = dsp_cpu_features();
+  if (f & DSP_CPU_AVX512) return 3;
+  if (f & DSP_CPU_AVX2) return 2;
+  if (f & DSP_CPU_SSE2) return 1;
+  return 0;
+}
+
+/**
+ * FFT length with the lowest cost per output for ntaps
+ * @return Length, 0 if ntaps is too long for DSP_FFT_MAX_LEN
+ */
+static size_t fft_best_len(size_t ntaps, int level) {
+  size_t best = 0;
+  float best_cost = 0.0f;
+  for (size_t n = DSP_FFT_MIN_LEN; n <= DSP_FFT_MAX_LEN; n *= 2) {
+    if (n < 2 * ntaps) continue;
+    float c = fft_cost_per_output(n, ntaps, level);
+    if (!best || c < best_cost) {
+      best = n;
+      best_cost = c;
+    }
+  }
+  return best;
+}
+
+void dsp_conv_mode(int mode) { g_conv_mode = mode; }
+
+int dsp_conv_use_fft(const float* taps, int ntaps, size_t n, int decim) {
+  if (g_conv_mode == DSP_CONV_DIRECT || ntaps < 2) return 0;
+  int level = simd_level_index();
+  size_t nfft = fft_best_len((size_t)ntaps, level);
+  if (!nfft) return 0;
+  if (g_conv_mode == DSP_CONV_FFT) return 1;
+
+  /* Short calls pay for whole segments */
+  size_t seg = nfft - (size_t)ntaps + 1;
+  float per_out = fft_cost_per_output(nfft, (size_t)ntaps, level);
+  if (n) per_out *= (float)((n + seg - 1) / seg * seg) / (float)n;
+
+  float direct = (float)ntaps * (dsp_fir_symmetric(taps, ntaps)
+                                     ? k_cost_tap_sym[level]
+                                     : k_cost_tap[level]);
+  return per_out * (float)(decim > 1 ? decim : 1) < direct;
+}
+
+struct DspFastFir* dsp_fastfir_create(const float* taps, int ntaps) {
+  if (ntaps < 1) return NULL;
+  size_t nfft = fft_best_len((size_t)ntaps, simd_level_index());
+  if (!nfft) return NULL;
+
+  struct DspFastFir* ff =
+      (struct DspFastFir*)calloc(1, sizeof(struct DspFastFir));
+  if (!ff) return NULL;
+  ff->nfft = nfft;
+  ff->ntaps = (size_t)ntaps;
+  float* mem = (float*)calloc(6 * nfft, sizeof(float));
+  if (!mem) {
+    free(ff);
+    return NULL;
+  }
+  ff->hr = mem;
+  ff->hi = mem + nfft;
+  ff->wr = mem + 2 * nfft;
+  ff->wi = mem + 3 * nfft;
+  ff->re = mem + 4 * nfft;
+  ff->im = mem + 5 * nfft;
+  fft_twiddles(ff->wr, ff->wi, nfft);
+
+  /* out[j] = sum taps[k] x[j+k] is a convolution with the reversed taps;
+   * the 1/nfft of the inverse transform is folded into the spectrum */
+  float scale = 1.0f / (float)nfft;
+  for (int k = 0; k < ntaps; k++) ff->hr[ntaps - 1 - k] = taps[k] * scale;
+  FftStage dif, dit;
+  fft_stages(&dif, &dit);
+  fft_forward(dif, ff->hr, ff->hi, nfft, ff->wr, ff->wi);
+  return ff;
+}
+
+size_t dsp_fastfir_len(const struct DspFastFir* ff) { return ff->nfft; }
+
+void dsp_fastfir_cf32(struct DspFastFir* ff, const float* x, size_t n,
+                      float* out) {
+  size_t nfft = ff->nfft;
+  size_t delay = ff->ntaps - 1;
+  size_t seg = nfft - delay;
+  float* re = ff->re;
+  float* im = ff->im;
+  FftStage dif, dit;
+  fft_stages(&dif, &dit);
+
+  for (size_t s = 0; s < n; s += seg) {
+    size_t cnt = n - s < seg ? n - s : seg;
+
+    /* Segment input: the outputs' inputs, zero-padded at the end */
+    const float* src = x + 2 * s;
+    size_t nin = cnt + delay;
+    for (size_t i = 0; i < nin; i++) {
+      re[i] = src[2 * i];
+      im[i] = src[2 * i + 1];
+    }
+    for (size_t i = nin; i < nfft; i++) {
+      re[i] = 0.0f;
+      im[i] = 0.0f;
+    }
+
+    fft_forward(dif, re, im, nfft, ff->wr, ff->wi);
+    for (size_t i = 0; i < nfft; i++) {
+      float xr = re[i], xi = im[i];
+      re[i] = xr * ff->hr[i] - xi * ff->hi[i];
+      im[i] = xr * ff->hi[i] + xi * ff->hr[i];
+    }
+    fft_forward_dit(dit, im, re, nfft, ff->wr, ff->wi);
+
+    /* Circular wrap-around spoils the first ntaps-1 points */
+    float* dst = out + 2 * s;
+    for (size_t i = 0; i < cnt; i++) {
+      dst[2 * i] = re[delay + i];
+      dst[2 * i + 1] = im[delay + i];
+    }
+  }
+}
+
+void dsp_fastfir_free(struct DspFastFir* ff) {
+  if (!ff) return;
+  free(ff->hr);
+  free(ff);
+}
+
+/* *****************************************************************************
+ *
+ *                         SPECTRUM FFT
+ *
+ * *****************************************************************************/
+
+int dsp_fft_cf32(float* re, float* im, size_t n) {
+  if (n == 0 || (n & (n - 1)) != 0) return -1;
+  if (n == 1) return 0;
+
+  float* w = (float*)malloc(2 * (n - 1) * sizeof(float));
+  if (!w) return -1;
+  fft_twiddles(w, w + n - 1, n);
+  FftStage dif, dit;
+  fft_stages(&dif, &dit);
+  fft_forward(dif, re, im, n, w, w + n - 1);
+  free(w);
+
+  /* Bit-reversed -> natural order */
+  int bits = ilog2(n);
+  for (size_t i = 0; i < n; i++) {
+    size_t r = 0;
+    for (int b = 0; b < bits; b++) r |= ((i >> b) & 1) << (bits - 1 - b);
+    if (r > i) {
+      float t = re[i];
+      re[i] = re[r];
+      re[r] = t;
+      t = im[i];
+      im[i] = im[r];
+      im[r] = t;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * dsp_fft.h
+ *
+ *  Built-in FFT and overlap-save fast convolution.
+ *
+ *  A radix-2 complex FFT (power-of-two lengths, split real/imaginary
+ *  arrays) drives an overlap-save FIR engine with the same contract as
+ *  dsp_fir_cf32(). Its cost per output grows with log(ntaps) instead of
+ *  ntaps, so long filters (sharp low-pass, wide RRC spans) stay cheap. The
+ *  engine is selected automatically when it is cheaper than the direct
+ *  form kernels, or forced either way. The transform itself is also
+ *  available in natural order for spectral estimates.
+ */
+
+#ifndef DSP_FFT_H_
+#define DSP_FFT_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* =============================================================================
+ * FAST CONVOLUTION PARAMETERS
+ * =============================================================================
+ */
+#define DSP_FFT_MIN_LEN 64         /* Smallest overlap-save FFT length */
+#define DSP_FFT_MAX_LEN (1u << 16) /* Largest overlap-save FFT length  */
+
+/* Convolution method selection */
+#define DSP_CONV_AUTO 0   /* Cheaper of direct and FFT (cost model) */
+#define DSP_CONV_DIRECT 1 /* Always direct form                      */
+#define DSP_CONV_FFT 2    /* FFT whenever a block fills a segment    */
+
+/**
+ * Set how FIR stages choose between direct and FFT convolution
+ * @param mode  DSP_CONV_AUTO, DSP_CONV_DIRECT or DSP_CONV_FFT
+ */
+void dsp_conv_mode(int mode);
+
+/**
+ * Decide whether a FIR is cheaper with FFT convolution
+ *
+ * Compares the direct kernels (at the active SIMD level, folded for
+ * symmetric taps) against overlap-save at its best FFT length, for the
+ * given amount of work.
+ *
+ * @param taps   Filter coefficients
+ * @param ntaps  Number of taps
+ * @param n      Full-rate outputs per call (0 = long continuous stream)
+ * @param decim  Decimation factor (direct form computes only 1/decim)
+ * @return 1 to use dsp_fastfir_cf32(), 0 for the direct kernels
+ */
+int dsp_conv_use_fft(const float* taps, int ntaps, size_t n, int decim);
+
+/* =============================================================================
+ * OVERLAP-SAVE FIR
+ * -----------------------------------------------------------------------------
+ * Same result as dsp_fir_cf32() (up to float rounding):
+ *   out[j] = sum_{k=0}^{ntaps-1} taps[k] * x[j + k]
+ * computed one FFT segment at a time: each segment of nfft inputs yields
+ * nfft - ntaps + 1 outputs.
+ * =============================================================================
+ */
+struct DspFastFir; /* Engine state (private to dsp_fft.c) */
+
+/**
+ * Create an overlap-save engine for a set of taps
+ *
+ * @param taps   Filter coefficients (copied into the engine)
+ * @param ntaps  Number of taps
+ * @return Engine, NULL on error or if ntaps does not fit DSP_FFT_MAX_LEN
+ */
+struct DspFastFir* dsp_fastfir_create(const float* taps, int ntaps);
+
+/**
+ * FFT length chosen by the engine
+ * @param ff  Engine
+ * @return FFT length (outputs per segment = length - ntaps + 1)
+ */
+size_t dsp_fastfir_len(const struct DspFastFir* ff);
+
+/**
+ * Filter interleaved complex samples with the engine's taps
+ *
+ * @param ff   Engine
+ * @param x    Interleaved float I/Q input (n + ntaps - 1 samples)
+ * @param n    Number of output samples
+ * @param out  Output: interleaved float I/Q (2*n floats, not x)
+ */
+void dsp_fastfir_cf32(struct DspFastFir* ff, const float* x, size_t n,
+                      float* out);
+
+/**
+ * Release an engine
+ * @param ff  Engine (may be NULL)
+ */
+void dsp_fastfir_free(struct DspFastFir* ff);
+
+/* =============================================================================
+ * SPECTRUM FFT
+ * -----------------------------------------------------------------------------
+ *   X[k] = sum_{j=0}^{n-1} x[j] * exp(-2*pi*i*j*k/n)
+ * in place over split arrays, natural order in and out, unscaled
+ * =============================================================================
+ */
+
+/**
+ * Forward FFT of a power-of-two length
+ *
+ * Uses the same stages (and SIMD dispatch) as the convolution engine,
+ * followed by a bit-reversal pass. The twiddle table is built per call, so
+ * this suits occasional transforms rather than a stream of them.
+ *
+ * @param re  Real parts (n values, replaced by the spectrum)
+ * @param im  Imaginary parts (n values, replaced by the spectrum)
+ * @param n   Transform length (power of two)
+ * @return 0 on success, -1 if n is not a power of two or on allocation error
+ */
+int dsp_fft_cf32(float* re, float* im, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSP_FFT_H_ */
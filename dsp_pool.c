@@ -0,0 +1,135 @@
+/*
+ * dsp_pool.c
+ *
+ *  Worker threads for splitting DSP work into independent tasks.
+ */
+
+#include "dsp_pool.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Workers claim the next task index with an atomic fetch-and-add, so a
+ * slow task never holds up the others.
+ */
+#ifdef _WIN32
+#define POOL_FETCH_ADD(p) \
+  ((uint64_t)InterlockedExchangeAdd64((volatile LONG64*)(p), 1))
+#else
+#define POOL_FETCH_ADD(p) __atomic_fetch_add((p), 1, __ATOMIC_RELAXED)
+#endif
+
+typedef struct {
+  DspTaskFn fn;    /* Task callback                     */
+  void* ctx;       /* Caller context                    */
+  uint64_t ntasks; /* Number of tasks                   */
+  uint64_t next;   /* Next task index to hand out       */
+} PoolJob;
+
+typedef struct {
+  PoolJob* job; /* Shared job                        */
+  int worker;   /* Worker index                      */
+} PoolWorker;
+
+/**
+ * Run tasks until none are left
+ */
+static void pool_run(PoolJob* job, int worker) {
+  for (;;) {
+    uint64_t t = POOL_FETCH_ADD(&job->next);
+    if (t >= job->ntasks) break;
+    job->fn(job->ctx, (size_t)t, worker);
+  }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI pool_main(LPVOID arg) {
+#else
+static void* pool_main(void* arg) {
+#endif
+  PoolWorker* w = (PoolWorker*)arg;
+  pool_run(w->job, w->worker);
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+int dsp_pool_cpu_count(void) {
+#ifdef _WIN32
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  int n = (int)si.dwNumberOfProcessors;
+#else
+  int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  if (n < 1) n = 1;
+  if (n > DSP_POOL_MAX_THREADS) n = DSP_POOL_MAX_THREADS;
+  return n;
+}
+
+void dsp_parallel_for(int nthreads, size_t ntasks, DspTaskFn fn, void* ctx) {
+  PoolJob job;
+  job.fn = fn;
+  job.ctx = ctx;
+  job.ntasks = ntasks;
+  job.next = 0;
+
+  if (nthreads > DSP_POOL_MAX_THREADS) nthreads = DSP_POOL_MAX_THREADS;
+  if ((size_t)nthreads > ntasks) nthreads = (int)ntasks;
+  if (nthreads <= 1) {
+    pool_run(&job, 0);
+    return;
+  }
+
+  PoolWorker* workers =
+      (PoolWorker*)malloc((size_t)nthreads * sizeof(PoolWorker));
+#ifdef _WIN32
+  HANDLE* threads = (HANDLE*)malloc((size_t)nthreads * sizeof(HANDLE));
+#else
+  pthread_t* threads = (pthread_t*)malloc((size_t)nthreads * sizeof(pthread_t));
+#endif
+  if (!workers || !threads) {
+    free(workers);
+    free(threads);
+    pool_run(&job, 0);
+    return;
+  }
+
+  /* Worker 0 is the caller */
+  int started = 1;
+  for (int i = 1; i < nthreads; i++) {
+    workers[i].job = &job;
+    workers[i].worker = i;
+#ifdef _WIN32
+    threads[i] = CreateThread(NULL, 0, pool_main, &workers[i], 0, NULL);
+    if (!threads[i]) break;
+#else
+    if (pthread_create(&threads[i], NULL, pool_main, &workers[i]) != 0) break;
+#endif
+    started++;
+  }
+
+  pool_run(&job, 0);
+
+  for (int i = 1; i < started; i++) {
+#ifdef _WIN32
+    WaitForSingleObject(threads[i], INFINITE);
+    CloseHandle(threads[i]);
+#else
+    pthread_join(threads[i], NULL);
+#endif
+  }
+  free(workers);
+  free(threads);
+}
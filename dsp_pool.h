@@ -0,0 +1,61 @@
+/*
+ * dsp_pool.h
+ *
+ *  Worker threads for splitting DSP work into independent tasks.
+ *
+ *  A parallel loop hands out task indices to a team of threads (the
+ *  calling thread included) until all are done. Tasks are fixed slices of
+ *  the work, so results never depend on how many threads ran them.
+ */
+
+#ifndef DSP_POOL_H_
+#define DSP_POOL_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* =============================================================================
+ * POOL PARAMETERS
+ * =============================================================================
+ */
+#define DSP_POOL_MAX_THREADS 256 /* Upper bound on worker threads */
+
+/**
+ * Task callback
+ *
+ * @param ctx     Caller context
+ * @param task    Task index (0 .. ntasks-1)
+ * @param worker  Index of the thread running it (0 .. nthreads-1), for
+ *                per-thread scratch state
+ */
+typedef void (*DspTaskFn)(void* ctx, size_t task, int worker);
+
+/**
+ * Number of logical processors available to the process
+ * @return Processor count (at least 1)
+ */
+int dsp_pool_cpu_count(void);
+
+/**
+ * Run tasks 0 .. ntasks-1 on up to nthreads threads
+ *
+ * The caller is worker 0; the call returns when every task has finished.
+ * With nthreads <= 1 (or a single task) everything runs on the caller.
+ * If threads cannot be started the remaining tasks still run on the
+ * caller.
+ *
+ * @param nthreads  Threads to use (clamped to ntasks and the maximum)
+ * @param ntasks    Number of tasks
+ * @param fn        Task callback
+ * @param ctx       Caller context passed to fn
+ */
+void dsp_parallel_for(int nthreads, size_t ntasks, DspTaskFn fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSP_POOL_H_ */
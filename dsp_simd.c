@@ -0,0 +1,1474 @@
+/*
+ * dsp_simd.c
+ *
+ *  SIMD signal processing kernels with runtime CPU dispatch.
+ */
+
+#include "dsp_simd.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* =============================================================================
+ * PLATFORM DETECTION
+ * =============================================================================
+ */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define DSP_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define DSP_X86 0
+#endif
+
+#define DSP_FIR_STACK_TAPS 256 /* Tap offsets kept on the stack up to this */
+
+/* GCC/Clang compile each kernel for its own instruction set; MSVC does not
+ * need (or support) per-function target attributes */
+#if defined(__GNUC__) || defined(__clang__)
+#define DSP_TARGET_SSE2 __attribute__((target("sse2")))
+#define DSP_TARGET_AVX2 __attribute__((target("avx2")))
+#define DSP_TARGET_AVX512 __attribute__((target("avx512f")))
+#define DSP_INLINE inline __attribute__((always_inline))
+#else
+#define DSP_TARGET_SSE2
+#define DSP_TARGET_AVX2
+#define DSP_TARGET_AVX512
+#define DSP_INLINE __forceinline
+#endif
+
+/* *****************************************************************************
+ *
+ *                         CPU FEATURE DETECTION
+ *
+ * *****************************************************************************/
+
+static int g_features = -1; /* Detected features (-1 = not yet)    */
+static int g_allowed = ~0;  /* Features the dispatcher may use     */
+
+/**
+ * Query CPUID for the supported instruction sets
+ * @return Bitmask of DSP_CPU_* flags
+ */
+static int cpu_detect(void) {
+  int f = 0;
+#if DSP_X86
+#if defined(_MSC_VER)
+  int r[4];
+  __cpuid(r, 0);
+  int max_leaf = r[0];
+  __cpuid(r, 1);
+  if (r[3] & (1 << 26)) f |= DSP_CPU_SSE2;
+  int osxsave = (r[2] >> 27) & 1;
+  int avx = (r[2] >> 28) & 1;
+  if (max_leaf >= 7 && osxsave && avx) {
+    /* OS must save the YMM state */
+    unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 6) == 6) {
+      __cpuidex(r, 7, 0);
+      if (r[1] & (1 << 5)) f |= DSP_CPU_AVX2;
+      /* ...and the opmask and ZMM state for AVX-512 */
+      if ((r[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6) f |= DSP_CPU_AVX512;
+    }
+  }
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) f |= DSP_CPU_SSE2;
+  if (__builtin_cpu_supports("avx2")) f |= DSP_CPU_AVX2;
+  if (__builtin_cpu_supports("avx512f")) f |= DSP_CPU_AVX512;
+#endif
+#endif
+  return f;
+}
+
+int dsp_cpu_features(void) {
+  if (g_features < 0) g_features = cpu_detect();
+  return g_features & g_allowed;
+}
+
+void dsp_simd_limit(int max_level) {
+  g_allowed = 0;
+  if (max_level >= 1) g_allowed |= DSP_CPU_SSE2;
+  if (max_level >= 2) g_allowed |= DSP_CPU_AVX2;
+  if (max_level >= 3) g_allowed |= DSP_CPU_AVX512;
+}
+
+const char* dsp_simd_level(void) {
+  int f = dsp_cpu_features();
+  if (f & DSP_CPU_AVX512) return "AVX-512";
+  if (f & DSP_CPU_AVX2) return "AVX2";
+  if (f & DSP_CPU_SSE2) return "SSE2";
+  return "scalar";
+}
+
+/* *****************************************************************************
+ *
+ *                         IQ CONVERSION - SCALAR
+ *
+ * *****************************************************************************/
+
+/* Generic scalar loop body shared by every input type */
+#define DSP_CONVERT_SCALAR(raw, n, i_dc, q_dc, scale, out, pwr_acc)         \
+  do {                                                                      \
+    double acc_ = 0.0;                                                      \
+    for (size_t k_ = 0; k_ < (n); k_++) {                                   \
+      float re_ = ((float)(raw)[2 * k_] - (i_dc)) * (scale);                \
+      float im_ = ((float)(raw)[2 * k_ + 1] - (q_dc)) * (scale);            \
+      (out)[2 * k_] = re_;                                                  \
+      (out)[2 * k_ + 1] = im_;                                              \
+      acc_ += (double)re_ * (double)re_ + (double)im_ * (double)im_;        \
+    }                                                                       \
+    if (pwr_acc) *(pwr_acc) += acc_;                                        \
+  } while (0)
+
+static void iq8_to_cf32_scalar(const int8_t* raw, size_t n, float i_dc,
+                               float q_dc, float scale, float* out,
+                               double* pwr_acc) {
+  DSP_CONVERT_SCALAR(raw, n, i_dc, q_dc, scale, out, pwr_acc);
+}
+
+static void iq16_to_cf32_scalar(const int16_t* raw, size_t n, float i_dc,
+                                float q_dc, float scale, float* out,
+                                double* pwr_acc) {
+  DSP_CONVERT_SCALAR(raw, n, i_dc, q_dc, scale, out, pwr_acc);
+}
+
+static void iq32_to_cf32_scalar(const int32_t* raw, size_t n, float i_dc,
+                                float q_dc, float scale, float* out,
+                                double* pwr_acc) {
+  DSP_CONVERT_SCALAR(raw, n, i_dc, q_dc, scale, out, pwr_acc);
+}
+
+static void cf32_to_cf32_scalar(const float* raw, size_t n, float i_dc,
+                                float q_dc, float scale, float* out,
+                                double* pwr_acc) {
+  DSP_CONVERT_SCALAR(raw, n, i_dc, q_dc, scale, out, pwr_acc);
+}
+
+static void cf32_stats_scalar(const float* x, size_t n, double* sum_i,
+                              double* sum_q, double* sum_pwr) {
+  double si = 0.0, sq = 0.0, sp = 0.0;
+  for (size_t k = 0; k < n; k++) {
+    double re = (double)x[2 * k];
+    double im = (double)x[2 * k + 1];
+    si += re;
+    sq += im;
+    sp += re * re + im * im;
+  }
+  *sum_i += si;
+  *sum_q += sq;
+  *sum_pwr += sp;
+}
+
+/* *****************************************************************************
+ *
+ *                         FIR FILTERING - SCALAR
+ *
+ * *****************************************************************************/
+
+/*
+ * Each FIR kernel body is instantiated twice: with koff == NULL for a plain
+ * FIR (tap k reads sample k, so the loads are at fixed offsets), and with a
+ * tap offset table for polyphase inputs.
+ */
+#define FIR_OFF(k) (koff ? koff[k] : 2 * (size_t)(k))
+
+static DSP_INLINE void fir_scalar_body(const float* x, const size_t* koff,
+                                       size_t n, const float* taps,
+                                       int ntaps, float* out) {
+  for (size_t j = 0; j < n; j++) {
+    const float* xj = x + 2 * j;
+    float re = 0.0f, im = 0.0f;
+    for (int k = 0; k < ntaps; k++) {
+      re += xj[FIR_OFF(k)] * taps[k];
+      im += xj[FIR_OFF(k) + 1] * taps[k];
+    }
+    out[2 * j] = re;
+    out[2 * j + 1] = im;
+  }
+}
+
+static void fir_cf32_scalar(const float* x, size_t n, const float* taps,
+                            int ntaps, float* out) {
+  fir_scalar_body(x, NULL, n, taps, ntaps, out);
+}
+
+static void fir_poly_cf32_scalar(const float* x, const size_t* koff,
+                                 size_t n, const float* taps, int ntaps,
+                                 float* out) {
+  fir_scalar_body(x, koff, n, taps, ntaps, out);
+}
+
+/*
+ * Symmetric taps (taps[k] == taps[ntaps-1-k]): the two inputs sharing a
+ * tap are added first, then multiplied once, so ntaps/2 (+1 for the
+ * centre tap of an odd length) multiplies per output instead of ntaps.
+ */
+static DSP_INLINE void fir_sym_scalar_body(const float* x, const size_t* koff,
+                                           size_t n, const float* taps,
+                                           int ntaps, float* out) {
+  int half = ntaps / 2;
+  for (size_t j = 0; j < n; j++) {
+    const float* xj = x + 2 * j;
+    float re = 0.0f, im = 0.0f;
+    for (int k = 0; k < half; k++) {
+      const float* p = xj + FIR_OFF(k);
+      const float* q = xj + FIR_OFF(ntaps - 1 - k);
+      re += (p[0] + q[0]) * taps[k];
+      im += (p[1] + q[1]) * taps[k];
+    }
+    if (ntaps & 1) {
+      re += xj[FIR_OFF(half)] * taps[half];
+      im += xj[FIR_OFF(half) + 1] * taps[half];
+    }
+    out[2 * j] = re;
+    out[2 * j + 1] = im;
+  }
+}
+
+static void fir_sym_cf32_scalar(const float* x, size_t n, const float* taps,
+                                int ntaps, float* out) {
+  fir_sym_scalar_body(x, NULL, n, taps, ntaps, out);
+}
+
+static void fir_poly_sym_cf32_scalar(const float* x, const size_t* koff,
+                                     size_t n, const float* taps, int ntaps,
+                                     float* out) {
+  fir_sym_scalar_body(x, koff, n, taps, ntaps, out);
+}
+
+/* *****************************************************************************
+ *
+ *                         Q15 FIXED POINT - SCALAR
+ *
+ * *****************************************************************************/
+
+/**
+ * Round a Q30 sum to Q15 and saturate to int16
+ */
+static inline int16_t q15_round(int32_t acc) {
+  int32_t v = (acc + (1 << 14)) >> 15;
+  return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+static inline int16_t q15_sat(int32_t v) {
+  return (int16_t)(v > 32767 ? 32767 : (v < -32767 ? -32767 : v));
+}
+
+static void iq16_to_q15_scalar(const int16_t* raw, size_t n, int16_t i_dc,
+                               int16_t q_dc, int16_t* out_i, int16_t* out_q,
+                               uint64_t* pwr_acc) {
+  uint64_t acc = 0;
+  for (size_t k = 0; k < n; k++) {
+    int32_t re = q15_sat((int32_t)raw[2 * k] - i_dc);
+    int32_t im = q15_sat((int32_t)raw[2 * k + 1] - q_dc);
+    out_i[k] = (int16_t)re;
+    out_q[k] = (int16_t)im;
+    acc += (uint64_t)(re * re + im * im);
+  }
+  if (pwr_acc) *pwr_acc += acc;
+}
+
+/*
+ * Input q * decim + p of the polyphase conversion goes to sample q of
+ * phase p; the SIMD kernels read each phase at a stride of decim samples.
+ */
+static void iq16_to_q15_poly_scalar(const int16_t* raw, size_t n, int decim,
+                                    int16_t i_dc, int16_t q_dc,
+                                    size_t stride, int16_t* out_i,
+                                    int16_t* out_q) {
+  for (int p = 0; p < decim; p++) {
+    const int16_t* s = raw + 2 * (size_t)p;
+    size_t step = 2 * (size_t)decim;
+    for (size_t q = 0; q < n; q++) {
+      out_i[(size_t)p * stride + q] = q15_sat((int32_t)s[q * step] - i_dc);
+      out_q[(size_t)p * stride + q] =
+          q15_sat((int32_t)s[q * step + 1] - q_dc);
+    }
+  }
+}
+
+/*
+ * Taps are applied in pairs that read neighbouring samples of one phase
+ * stream (taps k and k + decim), the unit of the 16-bit multiply-add
+ * instructions. Pair k reads x[j + poff[k]] and x[j + poff[k] + 1] with
+ * the two taps packed in ptap[k] (first tap in the low half).
+ */
+static void fir_q15_scalar(const int16_t* x_i, const int16_t* x_q,
+                           const size_t* poff, const int32_t* ptap,
+                           int npairs, size_t n, int16_t* out_i,
+                           int16_t* out_q) {
+  for (size_t j = 0; j < n; j++) {
+    int32_t acc_i = 0, acc_q = 0;
+    for (int k = 0; k < npairs; k++) {
+      int32_t ta = (int16_t)(ptap[k] & 0xFFFF);
+      int32_t tb = (int16_t)((uint32_t)ptap[k] >> 16);
+      const int16_t* pi = x_i + j + poff[k];
+      const int16_t* pq = x_q + j + poff[k];
+      acc_i += pi[0] * ta + pi[1] * tb;
+      acc_q += pq[0] * ta + pq[1] * tb;
+    }
+    out_i[j] = q15_round(acc_i);
+    out_q[j] = q15_round(acc_q);
+  }
+}
+
+static void q15_to_cf32_scalar(const int16_t* x_i, const int16_t* x_q,
+                               size_t n, float scale, float* out) {
+  for (size_t k = 0; k < n; k++) {
+    out[2 * k] = (float)x_i[k] * scale;
+    out[2 * k + 1] = (float)x_q[k] * scale;
+  }
+}
+
+#if DSP_X86
+
+/* *****************************************************************************
+ *
+ *                         IQ CONVERSION - SSE2
+ *
+ * *****************************************************************************/
+
+/**
+ * Remove DC, scale, store two complex samples and accumulate their power
+ */
+DSP_TARGET_SSE2
+static inline void sse2_finish(__m128 f, __m128 dc, __m128 sc, float* out,
+                               __m128d* acc) {
+  __m128 v = _mm_mul_ps(_mm_sub_ps(f, dc), sc);
+  _mm_storeu_ps(out, v);
+  __m128d lo = _mm_cvtps_pd(v);
+  __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+  *acc = _mm_add_pd(*acc, _mm_add_pd(_mm_mul_pd(lo, lo), _mm_mul_pd(hi, hi)));
+}
+
+DSP_TARGET_SSE2
+static double sse2_hsum_pd(__m128d v) {
+  double lanes[2];
+  _mm_storeu_pd(lanes, v);
+  return lanes[0] + lanes[1];
+}
+
+DSP_TARGET_SSE2
+static void iq8_to_cf32_sse2(const int8_t* raw, size_t n, float i_dc,
+                             float q_dc, float scale, float* out,
+                             double* pwr_acc) {
+  const __m128 dc = _mm_setr_ps(i_dc, q_dc, i_dc, q_dc);
+  const __m128 sc = _mm_set1_ps(scale);
+  __m128d acc = _mm_setzero_pd();
+  size_t k = 0;
+
+  /* 8 complex samples (16 x int8) per iteration */
+  for (; k + 8 <= n; k += 8) {
+    __m128i r = _mm_loadu_si128((const __m128i*)(raw + 2 * k));
+    __m128i w0 = _mm_srai_epi16(_mm_unpacklo_epi8(r, r), 8);
+    __m128i w1 = _mm_srai_epi16(_mm_unpackhi_epi8(r, r), 8);
+    __m128i d0 = _mm_srai_epi32(_mm_unpacklo_epi16(w0, w0), 16);
+    __m128i d1 = _mm_srai_epi32(_mm_unpackhi_epi16(w0, w0), 16);
+    __m128i d2 = _mm_srai_epi32(_mm_unpacklo_epi16(w1, w1), 16);
+    __m128i d3 = _mm_srai_epi32(_mm_unpackhi_epi16(w1, w1), 16);
+    sse2_finish(_mm_cvtepi32_ps(d0), dc, sc, out + 2 * k, &acc);
+    sse2_finish(_mm_cvtepi32_ps(d1), dc, sc, out + 2 * k + 4, &acc);
+    sse2_finish(_mm_cvtepi32_ps(d2), dc, sc, out + 2 * k + 8, &acc);
+    sse2_finish(_mm_cvtepi32_ps(d3), dc, sc, out + 2 * k + 12, &acc);
+  }
+
+  if (pwr_acc) *pwr_acc += sse2_hsum_pd(acc);
+  iq8_to_cf32_scalar(raw + 2 * k, n - k, i_dc, q_dc, scale, out + 2 * k,
+                     pwr_acc);
+}
+
+DSP_TARGET_SSE2
+static void iq16_to_cf32_sse2(const int16_t* raw, size_t n, float i_dc,
+                              float q_dc, float scale, float* out,
+                              double* pwr_acc) {
+  const __m128 dc = _mm_setr_ps(i_dc, q_dc, i_dc, q_dc);
+  const __m128 sc = _mm_set1_ps(scale);
+  __m128d acc = _mm_setzero_pd();
+  size_t k = 0;
+
+  /* 4 complex samples (8 x int16) per iteration */
+  for (; k + 4 <= n; k += 4) {
+    __m128i r = _mm_loadu_si128((const __m128i*)(raw + 2 * k));
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(r, r), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(r, r), 16);
+    sse2_finish(_mm_cvtepi32_ps(lo), dc, sc, out + 2 * k, &acc);
+    sse2_finish(_mm_cvtepi32_ps(hi), dc, sc, out + 2 * k + 4, &acc);
+  }
+
+  if (pwr_acc) *pwr_acc += sse2_hsum_pd(acc);
+  iq16_to_cf32_scalar(raw + 2 * k, n - k, i_dc, q_dc, scale, out + 2 * k,
+                      pwr_acc);
+}
+
+DSP_TARGET_SSE2
+static void iq32_to_cf32_sse2(const int32_t* raw, size_t n, float i_dc,
+                              float q_dc, float scale, float* out,
+                              double* pwr_acc) {
+  const __m128 dc = _mm_setr_ps(i_dc, q_dc, i_dc, q_dc);
+  const __m128 sc = _mm_set1_ps(scale);
+  __m128d acc = _mm_setzero_pd();
+  size_t k = 0;
+
+  /* 2 complex samples (4 x int32) per iteration */
+  for (; k + 2 <= n; k += 2) {
+    __m128i r = _mm_loadu_si128((const __m128i*)(raw + 2 * k));
+    sse2_finish(_mm_cvtepi32_ps(r), dc, sc, out + 2 * k, &acc);
+  }
+
+  if (pwr_acc) *pwr_acc += sse2_hsum_pd(acc);
+  iq32_to_cf32_scalar(raw + 2 * k, n - k, i_dc, q_dc, scale, out + 2 * k,
+                      pwr_acc);
+}
+
+DSP_TARGET_SSE2
+static void cf32_to_cf32_sse2(const float* raw, size_t n, float i_dc,
+                              float q_dc, float scale, float* out,
+                              double* pwr_acc) {
+  const __m128 dc = _mm_setr_ps(i_dc, q_dc, i_dc, q_dc);
+  const __m128 sc = _mm_set1_ps(scale);
+  __m128d acc = _mm_setzero_pd();
+  size_t k = 0;
+
+  /* 2 complex samples per iteration */
+  for (; k + 2 <= n; k += 2) {
+    sse2_finish(_mm_loadu_ps(raw + 2 * k), dc, sc, out + 2 * k, &acc);
+  }
+
+  if (pwr_acc) *pwr_acc += sse2_hsum_pd(acc);
+  cf32_to_cf32_scalar(raw + 2 * k, n - k, i_dc, q_dc, scale, out + 2 * k,
+                      pwr_acc);
+}
+
+/* *****************************************************************************
+ *
+ *                         IQ CONVERSION - AVX2
+ *
+ * *****************************************************************************/
+
+/**
+ * Remove DC, scale, store four complex samples and accumulate their power
+ */
+DSP_TARGET_AVX2
+static inline void avx2_finish(__m256 f, __m256 dc, __m256 sc, float* out,
+                               __m256d* acc) {
+  __m256 v = _mm256_mul_ps(_mm256_sub_ps(f, dc), sc);
+  _mm256_storeu_ps(out, v);
+  __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+  __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+  *acc = _mm256_add_pd(
+      *acc, _mm256_add_pd(_mm256_mul_pd(lo, lo), _mm256_mul_pd(hi, hi)));
+}
+
+DSP_TARGET_AVX2
+static double avx2_hsum_pd(__m256d v) {
+  double lanes[4];
+  _mm256_storeu_pd(lanes, v);
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+DSP_TARGET_AVX2
+static void iq8_to_cf32_avx2(const int8_t* raw, size_t n, float i_dc,
+                             float q_dc, float scale, float* out,
+                             double* pwr_acc) {
+  const __m256 dc =
+      _mm256_setr_ps(i_dc, q_dc, i_dc, q_dc, i_dc, q_dc, i_dc, q_dc);
+  const __m256 sc = _mm256_set1_ps(scale);
+  __m256d acc = _mm256_setzero_pd();
+  size_t k = 0;
+
+  /* 8 complex samples (16 x int8) per iteration */
+  for (; k + 8 <= n; k += 8) {
+    __m128i r = _mm_loadu_si128((const __m128i*)(raw + 2 * k));
+    __m256i lo = _mm256_cvtepi8_epi32(r);
+    __m256i hi = _mm256_cvtepi8_epi32(_mm_srli_si128(r, 8));
+    avx2_finish(_mm256_cvtepi32_ps(lo), dc, sc, out + 2 * k, &acc);
+    avx2_finish(_mm256_cvtepi32_ps(hi), dc, sc, out + 2 * k + 8, &acc);
+  }
+
+  if (pwr_acc) *pwr_acc += avx2_hsum_pd(acc);
+  iq8_to_cf32_scalar(raw + 2 * k, n - k, i_dc, q_dc, scale, out + 2 * k,
+                     pwr_acc);
+}
+
+DSP_TARGET_AVX2
+static void iq16_to_cf32_avx2(const int16_t* raw, size_t n, float i_dc,
+                              float q_dc, float scale, float* out,
+                              double* pwr_acc) {
+  const __m256 dc =
+      _mm256_setr_ps(i_dc, q_dc, i_dc, q_dc, i_dc, q_dc, i_dc, q_dc);
+  const __m256 sc = _mm256_set1_ps(scale);
+  __m256d acc = _mm256_setzero_pd();
+  size_t k = 0;
+
+  /* 8 complex samples (16 x int16) per iteration */
+  for (; k + 8 <= n; k += 8) {
+    __m256i r = _mm256_loadu_si256((const __m256i*)(raw + 2 * k));
+    __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(r));
+    __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(r, 1));
+    avx2_finish(_mm256_cvtepi32_ps(lo), dc, sc, out + 2 * k, &acc);
+    avx2_finish(_mm256_cvtepi32_ps(hi), dc, sc, out + 2 * k + 8, &acc);
+  }
+
+  if (pwr_acc) *pwr_acc += avx2_hsum_pd(acc);
+  iq16_to_cf32_scalar(raw + 2 * k, n - k, i_dc, q_dc, scale, out + 2 * k,
+                      pwr_acc);
+}
+
+DSP_TARGET_AVX2
+static void iq32_to_cf32_avx2(const int32_t* raw, size_t n, float i_dc,
+                              float q_dc, float scale, float* out,
+                              double* pwr_acc) {
+  const __m256 dc =
+      _mm256_setr_ps(i_dc, q_dc, i_dc, q_dc, i_dc, q_dc, i_dc, q_dc);
+  const __m256 sc = _mm256_set1_ps(scale);
+  __m256d acc = _mm256_setzero_pd();
+  size_t k = 0;
+
+  /* 4 complex samples (8 x int32) per iteration */
+  for (; k + 4 <= n; k += 4) {
+    __m256i r = _mm256_loadu_si256((const __m256i*)(raw + 2 * k));
+    avx2_finish(_mm256_cvtepi32_ps(r), dc, sc, out + 2 * k, &acc);
+  }
+
+  if (pwr_acc) *pwr_acc += avx2_hsum_pd(acc);
+  iq32_to_cf32_scalar(raw + 2 * k, n - k, i_dc, q_dc, scale, out + 2 * k,
+                      pwr_acc);
+}
+
+DSP_TARGET_AVX2
+static void cf32_to_cf32_avx2(const float* raw, size_t n, float i_dc,
+                              float q_dc, float scale, float* out,
+                              double* pwr_acc) {
+  const __m256 dc =
+      _mm256_setr_ps(i_dc, q_dc, i_dc, q_dc, i_dc, q_dc, i_dc, q_dc);
+  const __m256 sc = _mm256_set1_ps(scale);
+  __m256d acc = _mm256_setzero_pd();
+  size_t k = 0;
+
+  /* 4 complex samples per iteration */
+  for (; k + 4 <= n; k += 4) {
+    avx2_finish(_mm256_loadu_ps(raw + 2 * k), dc, sc, out + 2 * k, &acc);
+  }
+
+  if (pwr_acc) *pwr_acc += avx2_hsum_pd(acc);
+  cf32_to_cf32_scalar(raw + 2 * k, n - k, i_dc, q_dc, scale, out + 2 * k,
+                      pwr_acc);
+}
+
+DSP_TARGET_AVX2
+static void cf32_stats_avx2(const float* x, size_t n, double* sum_i,
+                            double* sum_q, double* sum_pwr) {
+  /* Lanes alternate I, Q, I, Q */
+  __m256d s = _mm256_setzero_pd();
+  __m256d p = _mm256_setzero_pd();
+  size_t k = 0;
+
+  for (; k + 2 <= n; k += 2) {
+    __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(x + 2 * k));
+    s = _mm256_add_pd(s, v);
+    p = _mm256_add_pd(p, _mm256_mul_pd(v, v));
+  }
+
+  double ls[4];
+  _mm256_storeu_pd(ls, s);
+  *sum_i += ls[0] + ls[2];
+  *sum_q += ls[1] + ls[3];
+  *sum_pwr += avx2_hsum_pd(p);
+  cf32_stats_scalar(x + 2 * k, n - k, sum_i, sum_q, sum_pwr);
+}
+
+/* *****************************************************************************
+ *
+ *                         FIR FILTERING - SSE2 / AVX2 / AVX-512
+ *
+ * *****************************************************************************/
+
+/*
+ * One vector holds consecutive complex outputs (2 for SSE2, 4 for AVX2, 8
+ * for AVX-512) and four vectors are kept in flight to hide the add latency.
+ * For tap k every lane adds its input at koff[k] times taps[k], i.e. the
+ * scalar recurrence, so no horizontal sums are needed and the results
+ * match the scalar loop. Consecutive outputs always read consecutive
+ * samples: of the signal for a plain FIR, of one phase stream for a
+ * polyphase decimator.
+ */
+
+DSP_TARGET_SSE2
+static DSP_INLINE void fir_sse2_body(const float* x, const size_t* koff,
+                                     size_t n, const float* taps,
+                                     int ntaps, float* out) {
+  size_t j = 0;
+  for (; j + 8 <= n; j += 8) {
+    const float* xj = x + 2 * j;
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    __m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+    for (int k = 0; k < ntaps; k++) {
+      __m128 t = _mm_set1_ps(taps[k]);
+      const float* p = xj + FIR_OFF(k);
+      a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(p), t));
+      a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(p + 4), t));
+      a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_loadu_ps(p + 8), t));
+      a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_loadu_ps(p + 12), t));
+    }
+    _mm_storeu_ps(out + 2 * j, a0);
+    _mm_storeu_ps(out + 2 * j + 4, a1);
+    _mm_storeu_ps(out + 2 * j + 8, a2);
+    _mm_storeu_ps(out + 2 * j + 12, a3);
+  }
+  for (; j + 2 <= n; j += 2) {
+    __m128 a = _mm_setzero_ps();
+    for (int k = 0; k < ntaps; k++) {
+      a = _mm_add_ps(
+          a, _mm_mul_ps(_mm_loadu_ps(x + 2 * j + FIR_OFF(k)), _mm_set1_ps(taps[k])));
+    }
+    _mm_storeu_ps(out + 2 * j, a);
+  }
+  fir_scalar_body(x + 2 * j, koff, n - j, taps, ntaps, out + 2 * j);
+}
+
+DSP_TARGET_SSE2
+static void fir_cf32_sse2(const float* x, size_t n, const float* taps,
+                          int ntaps, float* out) {
+  fir_sse2_body(x, NULL, n, taps, ntaps, out);
+}
+
+DSP_TARGET_SSE2
+static void fir_poly_cf32_sse2(const float* x, const size_t* koff,
+                               size_t n, const float* taps, int ntaps,
+                               float* out) {
+  fir_sse2_body(x, koff, n, taps, ntaps, out);
+}
+
+DSP_TARGET_SSE2
+static DSP_INLINE void fir_sym_sse2_body(const float* x, const size_t* koff,
+                                         size_t n, const float* taps,
+                                         int ntaps, float* out) {
+  int half = ntaps / 2;
+  size_t j = 0;
+  for (; j + 8 <= n; j += 8) {
+    const float* xj = x + 2 * j;
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    __m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+    for (int k = 0; k < half; k++) {
+      __m128 t = _mm_set1_ps(taps[k]);
+      const float* p = xj + FIR_OFF(k);
+      const float* q = xj + FIR_OFF(ntaps - 1 - k);
+      a0 = _mm_add_ps(
+          a0, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(p), _mm_loadu_ps(q)), t));
+      a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(p + 4),
+                                                _mm_loadu_ps(q + 4)),
+                                     t));
+      a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(p + 8),
+                                                _mm_loadu_ps(q + 8)),
+                                     t));
+      a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(p + 12),
+                                                _mm_loadu_ps(q + 12)),
+                                     t));
+    }
+    if (ntaps & 1) {
+      __m128 t = _mm_set1_ps(taps[half]);
+      const float* p = xj + FIR_OFF(half);
+      a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(p), t));
+      a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(p + 4), t));
+      a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_loadu_ps(p + 8), t));
+      a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_loadu_ps(p + 12), t));
+    }
+    _mm_storeu_ps(out + 2 * j, a0);
+    _mm_storeu_ps(out + 2 * j + 4, a1);
+    _mm_storeu_ps(out + 2 * j + 8, a2);
+    _mm_storeu_ps(out + 2 * j + 12, a3);
+  }
+  fir_sym_scalar_body(x + 2 * j, koff, n - j, taps, ntaps, out + 2 * j);
+}
+
+DSP_TARGET_SSE2
+static void fir_sym_cf32_sse2(const float* x, size_t n, const float* taps,
+                              int ntaps, float* out) {
+  fir_sym_sse2_body(x, NULL, n, taps, ntaps, out);
+}
+
+DSP_TARGET_SSE2
+static void fir_poly_sym_cf32_sse2(const float* x, const size_t* koff,
+                                   size_t n, const float* taps, int ntaps,
+                                   float* out) {
+  fir_sym_sse2_body(x, koff, n, taps, ntaps, out);
+}
+
+DSP_TARGET_AVX2
+static DSP_INLINE void fir_avx2_body(const float* x, const size_t* koff,
+                                     size_t n, const float* taps,
+                                     int ntaps, float* out) {
+  size_t j = 0;
+  for (; j + 16 <= n; j += 16) {
+    const float* xj = x + 2 * j;
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+    for (int k = 0; k < ntaps; k++) {
+      __m256 t = _mm256_broadcast_ss(taps + k);
+      const float* p = xj + FIR_OFF(k);
+      a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(p), t));
+      a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(p + 8), t));
+      a2 = _mm256_add_ps(a2, _mm256_mul_ps(_mm256_loadu_ps(p + 16), t));
+      a3 = _mm256_add_ps(a3, _mm256_mul_ps(_mm256_loadu_ps(p + 24), t));
+    }
+    _mm256_storeu_ps(out + 2 * j, a0);
+    _mm256_storeu_ps(out + 2 * j + 8, a1);
+    _mm256_storeu_ps(out + 2 * j + 16, a2);
+    _mm256_storeu_ps(out + 2 * j + 24, a3);
+  }
+  for (; j + 4 <= n; j += 4) {
+    __m256 a = _mm256_setzero_ps();
+    for (int k = 0; k < ntaps; k++) {
+      a = _mm256_add_ps(a, _mm256_mul_ps(_mm256_loadu_ps(x + 2 * j + FIR_OFF(k)),
+                                         _mm256_broadcast_ss(taps + k)));
+    }
+    _mm256_storeu_ps(out + 2 * j, a);
+  }
+  fir_scalar_body(x + 2 * j, koff, n - j, taps, ntaps, out + 2 * j);
+}
+
+DSP_TARGET_AVX2
+static void fir_cf32_avx2(const float* x, size_t n, const float* taps,
+                          int ntaps, float* out) {
+  fir_avx2_body(x, NULL, n, taps, ntaps, out);
+}
+
+DSP_TARGET_AVX2
+static void fir_poly_cf32_avx2(const float* x, const size_t* koff,
+                               size_t n, const float* taps, int ntaps,
+                               float* out) {
+  fir_avx2_body(x, koff, n, taps, ntaps, out);
+}
+
+DSP_TARGET_AVX2
+static DSP_INLINE void fir_sym_avx2_body(const float* x, const size_t* koff,
+                                         size_t n, const float* taps,
+                                         int ntaps, float* out) {
+  int half = ntaps / 2;
+  size_t j = 0;
+  for (; j + 16 <= n; j += 16) {
+    const float* xj = x + 2 * j;
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+    for (int k = 0; k < half; k++) {
+      __m256 t = _mm256_broadcast_ss(taps + k);
+      const float* p = xj + FIR_OFF(k);
+      const float* q = xj + FIR_OFF(ntaps - 1 - k);
+      a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(p),
+                                                         _mm256_loadu_ps(q)),
+                                           t));
+      a1 = _mm256_add_ps(a1,
+                         _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(p + 8),
+                                                     _mm256_loadu_ps(q + 8)),
+                                       t));
+      a2 = _mm256_add_ps(a2,
+                         _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(p + 16),
+                                                     _mm256_loadu_ps(q + 16)),
+                                       t));
+      a3 = _mm256_add_ps(a3,
+                         _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(p + 24),
+                                                     _mm256_loadu_ps(q + 24)),
+                                       t));
+    }
+    if (ntaps & 1) {
+      __m256 t = _mm256_broadcast_ss(taps + half);
+      const float* p = xj + FIR_OFF(half);
+      a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(p), t));
+      a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(p + 8), t));
+      a2 = _mm256_add_ps(a2, _mm256_mul_ps(_mm256_loadu_ps(p + 16), t));
+      a3 = _mm256_add_ps(a3, _mm256_mul_ps(_mm256_loadu_ps(p + 24), t));
+    }
+    _mm256_storeu_ps(out + 2 * j, a0);
+    _mm256_storeu_ps(out + 2 * j + 8, a1);
+    _mm256_storeu_ps(out + 2 * j + 16, a2);
+    _mm256_storeu_ps(out + 2 * j + 24, a3);
+  }
+  fir_sym_sse2_body(x + 2 * j, koff, n - j, taps, ntaps, out + 2 * j);
+}
+
+DSP_TARGET_AVX2
+static void fir_sym_cf32_avx2(const float* x, size_t n, const float* taps,
+                              int ntaps, float* out) {
+  fir_sym_avx2_body(x, NULL, n, taps, ntaps, out);
+}
+
+DSP_TARGET_AVX2
+static void fir_poly_sym_cf32_avx2(const float* x, const size_t* koff,
+                                   size_t n, const float* taps, int ntaps,
+                                   float* out) {
+  fir_sym_avx2_body(x, koff, n, taps, ntaps, out);
+}
+
+/* AVX-512F implies FMA, and compilers may fuse a plain mul + add into one
+ * rounding step. The explicit-rounding forms keep two roundings per tap,
+ * like the scalar loop. */
+#define AVX512_RN (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define AVX512_ADD(a, b) _mm512_add_round_ps((a), (b), AVX512_RN)
+#define AVX512_MUL(a, b) _mm512_mul_round_ps((a), (b), AVX512_RN)
+
+DSP_TARGET_AVX512
+static DSP_INLINE void fir_avx512_body(const float* x, const size_t* koff,
+                                       size_t n, const float* taps,
+                                       int ntaps, float* out) {
+  size_t j = 0;
+  for (; j + 32 <= n; j += 32) {
+    const float* xj = x + 2 * j;
+    __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+    __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+    for (int k = 0; k < ntaps; k++) {
+      __m512 t = _mm512_set1_ps(taps[k]);
+      const float* p = xj + FIR_OFF(k);
+      a0 = AVX512_ADD(a0, AVX512_MUL(_mm512_loadu_ps(p), t));
+      a1 = AVX512_ADD(a1, AVX512_MUL(_mm512_loadu_ps(p + 16), t));
+      a2 = AVX512_ADD(a2, AVX512_MUL(_mm512_loadu_ps(p + 32), t));
+      a3 = AVX512_ADD(a3, AVX512_MUL(_mm512_loadu_ps(p + 48), t));
+    }
+    _mm512_storeu_ps(out + 2 * j, a0);
+    _mm512_storeu_ps(out + 2 * j + 16, a1);
+    _mm512_storeu_ps(out + 2 * j + 32, a2);
+    _mm512_storeu_ps(out + 2 * j + 48, a3);
+  }
+  for (; j + 8 <= n; j += 8) {
+    __m512 a = _mm512_setzero_ps();
+    for (int k = 0; k < ntaps; k++) {
+      a = AVX512_ADD(a, AVX512_MUL(_mm512_loadu_ps(x + 2 * j + FIR_OFF(k)),
+                                   _mm512_set1_ps(taps[k])));
+    }
+    _mm512_storeu_ps(out + 2 * j, a);
+  }
+  fir_scalar_body(x + 2 * j, koff, n - j, taps, ntaps, out + 2 * j);
+}
+
+DSP_TARGET_AVX512
+static void fir_cf32_avx512(const float* x, size_t n, const float* taps,
+                            int ntaps, float* out) {
+  fir_avx512_body(x, NULL, n, taps, ntaps, out);
+}
+
+DSP_TARGET_AVX512
+static void fir_poly_cf32_avx512(const float* x, const size_t* koff,
+                                 size_t n, const float* taps, int ntaps,
+                                 float* out) {
+  fir_avx512_body(x, koff, n, taps, ntaps, out);
+}
+
+DSP_TARGET_AVX512
+static DSP_INLINE void fir_sym_avx512_body(const float* x,
+                                           const size_t* koff, size_t n,
+                                           const float* taps, int ntaps,
+                                           float* out) {
+  int half = ntaps / 2;
+  size_t j = 0;
+  for (; j + 32 <= n; j += 32) {
+    const float* xj = x + 2 * j;
+    __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+    __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+    for (int k = 0; k < half; k++) {
+      __m512 t = _mm512_set1_ps(taps[k]);
+      const float* p = xj + FIR_OFF(k);
+      const float* q = xj + FIR_OFF(ntaps - 1 - k);
+      a0 = AVX512_ADD(a0, AVX512_MUL(AVX512_ADD(_mm512_loadu_ps(p),
+                                                _mm512_loadu_ps(q)),
+                                     t));
+      a1 = AVX512_ADD(a1, AVX512_MUL(AVX512_ADD(_mm512_loadu_ps(p + 16),
+                                                _mm512_loadu_ps(q + 16)),
+                                     t));
+      a2 = AVX512_ADD(a2, AVX512_MUL(AVX512_ADD(_mm512_loadu_ps(p + 32),
+                                                _mm512_loadu_ps(q + 32)),
+                                     t));
+      a3 = AVX512_ADD(a3, AVX512_MUL(AVX512_ADD(_mm512_loadu_ps(p + 48),
+                                                _mm512_loadu_ps(q + 48)),
+                                     t));
+    }
+    if (ntaps & 1) {
+      __m512 t = _mm512_set1_ps(taps[half]);
+      const float* p = xj + FIR_OFF(half);
+      a0 = AVX512_ADD(a0, AVX512_MUL(_mm512_loadu_ps(p), t));
+      a1 = AVX512_ADD(a1, AVX512_MUL(_mm512_loadu_ps(p + 16), t));
+      a2 = AVX512_ADD(a2, AVX512_MUL(_mm512_loadu_ps(p + 32), t));
+      a3 = AVX512_ADD(a3, AVX512_MUL(_mm512_loadu_ps(p + 48), t));
+    }
+    _mm512_storeu_ps(out + 2 * j, a0);
+    _mm512_storeu_ps(out + 2 * j + 16, a1);
+    _mm512_storeu_ps(out + 2 * j + 32, a2);
+    _mm512_storeu_ps(out + 2 * j + 48, a3);
+  }
+  fir_sym_avx2_body(x + 2 * j, koff, n - j, taps, ntaps, out + 2 * j);
+}
+
+DSP_TARGET_AVX512
+static void fir_sym_cf32_avx512(const float* x, size_t n, const float* taps,
+                                int ntaps, float* out) {
+  fir_sym_avx512_body(x, NULL, n, taps, ntaps, out);
+}
+
+DSP_TARGET_AVX512
+static void fir_poly_sym_cf32_avx512(const float* x, const size_t* koff,
+                                     size_t n, const float* taps, int ntaps,
+                                     float* out) {
+  fir_sym_avx512_body(x, koff, n, taps, ntaps, out);
+}
+
+/* *****************************************************************************
+ *
+ *                         Q15 FIXED POINT - SSE2 / AVX2
+ *
+ * *****************************************************************************/
+
+DSP_TARGET_SSE2
+static void iq16_to_q15_sse2(const int16_t* raw, size_t n, int16_t i_dc,
+                             int16_t q_dc, int16_t* out_i, int16_t* out_q,
+                             uint64_t* pwr_acc) {
+  const __m128i dc = _mm_set1_epi32((int)((uint16_t)i_dc |
+                                          ((uint32_t)(uint16_t)q_dc << 16)));
+  const __m128i lim = _mm_set1_epi16(-32767);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i acc = _mm_setzero_si128();
+  size_t k = 0;
+
+  /* 8 complex samples per iteration */
+  for (; k + 8 <= n; k += 8) {
+    __m128i d0 = _mm_max_epi16(
+        _mm_subs_epi16(_mm_loadu_si128((const __m128i*)(raw + 2 * k)), dc),
+        lim);
+    __m128i d1 = _mm_max_epi16(
+        _mm_subs_epi16(_mm_loadu_si128((const __m128i*)(raw + 2 * k + 8)),
+                       dc),
+        lim);
+    __m128i p0 = _mm_madd_epi16(d0, d0);
+    __m128i p1 = _mm_madd_epi16(d1, d1);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(p0, zero));
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(p0, zero));
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(p1, zero));
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(p1, zero));
+    __m128i i0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+    __m128i i1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+    __m128i q0 = _mm_srai_epi32(d0, 16);
+    __m128i q1 = _mm_srai_epi32(d1, 16);
+    _mm_storeu_si128((__m128i*)(out_i + k), _mm_packs_epi32(i0, i1));
+    _mm_storeu_si128((__m128i*)(out_q + k), _mm_packs_epi32(q0, q1));
+  }
+
+  if (pwr_acc) {
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    *pwr_acc += lanes[0] + lanes[1];
+  }
+  iq16_to_q15_scalar(raw + 2 * k, n - k, i_dc, q_dc, out_i + k, out_q + k,
+                     pwr_acc);
+}
+
+/**
+ * Load 4 I/Q pairs that lie step int16 values apart
+ */
+DSP_TARGET_SSE2
+static DSP_INLINE __m128i sse2_load_iq16_strided(const int16_t* s,
+                                                 size_t step) {
+  int32_t v0, v1, v2, v3;
+  memcpy(&v0, s, 4);
+  memcpy(&v1, s + step, 4);
+  memcpy(&v2, s + 2 * step, 4);
+  memcpy(&v3, s + 3 * step, 4);
+  return _mm_unpacklo_epi64(
+      _mm_unpacklo_epi32(_mm_cvtsi32_si128(v0), _mm_cvtsi32_si128(v1)),
+      _mm_unpacklo_epi32(_mm_cvtsi32_si128(v2), _mm_cvtsi32_si128(v3)));
+}
+
+DSP_TARGET_SSE2
+static void iq16_to_q15_poly_sse2(const int16_t* raw, size_t n, int decim,
+                                  int16_t i_dc, int16_t q_dc, size_t stride,
+                                  int16_t* out_i, int16_t* out_q) {
+  const __m128i dc = _mm_set1_epi32((int)((uint16_t)i_dc |
+                                          ((uint32_t)(uint16_t)q_dc << 16)));
+  const __m128i lim = _mm_set1_epi16(-32767);
+  const size_t step = 2 * (size_t)decim;
+
+  for (int p = 0; p < decim; p++) {
+    const int16_t* s = raw + 2 * (size_t)p;
+    int16_t* oi = out_i + (size_t)p * stride;
+    int16_t* oq = out_q + (size_t)p * stride;
+    size_t q = 0;
+
+    /* 8 samples of the phase per iteration */
+    for (; q + 8 <= n; q += 8) {
+      __m128i d0 = _mm_max_epi16(
+          _mm_subs_epi16(sse2_load_iq16_strided(s + q * step, step), dc),
+          lim);
+      __m128i d1 = _mm_max_epi16(
+          _mm_subs_epi16(sse2_load_iq16_strided(s + (q + 4) * step, step),
+                         dc),
+          lim);
+      __m128i i0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+      __m128i i1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+      __m128i q0 = _mm_srai_epi32(d0, 16);
+      __m128i q1 = _mm_srai_epi32(d1, 16);
+      _mm_storeu_si128((__m128i*)(oi + q), _mm_packs_epi32(i0, i1));
+      _mm_storeu_si128((__m128i*)(oq + q), _mm_packs_epi32(q0, q1));
+    }
+    for (; q < n; q++) {
+      oi[q] = q15_sat((int32_t)s[q * step] - i_dc);
+      oq[q] = q15_sat((int32_t)s[q * step + 1] - q_dc);
+    }
+  }
+}
+
+/**
+ * Round even/odd Q30 sums to Q15 and interleave them back into order
+ */
+DSP_TARGET_SSE2
+static inline __m128i sse2_q15_finish(__m128i ae, __m128i ao) {
+  const __m128i rnd = _mm_set1_epi32(1 << 14);
+  __m128i e = _mm_srai_epi32(_mm_add_epi32(ae, rnd), 15);
+  __m128i o = _mm_srai_epi32(_mm_add_epi32(ao, rnd), 15);
+  return _mm_unpacklo_epi16(_mm_packs_epi32(e, e), _mm_packs_epi32(o, o));
+}
+
+/*
+ * A multiply-add of 8 samples starting at j + poff[k] against the packed
+ * tap pair gives the pair's terms of outputs j, j+2, j+4, j+6; the same
+ * one sample later gives the odd outputs. Both planes share the pair's
+ * offset and taps, so one broadcast serves four multiply-adds.
+ */
+DSP_TARGET_SSE2
+static void fir_q15_sse2(const int16_t* x_i, const int16_t* x_q,
+                         const size_t* poff, const int32_t* ptap, int npairs,
+                         size_t n, int16_t* out_i, int16_t* out_q) {
+  size_t j = 0;
+  for (; j + 16 <= n; j += 16) {
+    __m128i ei0 = _mm_setzero_si128(), oi0 = _mm_setzero_si128();
+    __m128i ei1 = _mm_setzero_si128(), oi1 = _mm_setzero_si128();
+    __m128i eq0 = _mm_setzero_si128(), oq0 = _mm_setzero_si128();
+    __m128i eq1 = _mm_setzero_si128(), oq1 = _mm_setzero_si128();
+    for (int k = 0; k < npairs; k++) {
+      __m128i t = _mm_set1_epi32(ptap[k]);
+      const int16_t* pi = x_i + j + poff[k];
+      const int16_t* pq = x_q + j + poff[k];
+#define Q15_MADD(acc, p) \
+  acc = _mm_add_epi32(     \
+      acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(p)), t))
+      Q15_MADD(ei0, pi);
+      Q15_MADD(oi0, pi + 1);
+      Q15_MADD(ei1, pi + 8);
+      Q15_MADD(oi1, pi + 9);
+      Q15_MADD(eq0, pq);
+      Q15_MADD(oq0, pq + 1);
+      Q15_MADD(eq1, pq + 8);
+      Q15_MADD(oq1, pq + 9);
+#undef Q15_MADD
+    }
+    _mm_storeu_si128((__m128i*)(out_i + j), sse2_q15_finish(ei0, oi0));
+    _mm_storeu_si128((__m128i*)(out_i + j + 8), sse2_q15_finish(ei1, oi1));
+    _mm_storeu_si128((__m128i*)(out_q + j), sse2_q15_finish(eq0, oq0));
+    _mm_storeu_si128((__m128i*)(out_q + j + 8), sse2_q15_finish(eq1, oq1));
+  }
+  fir_q15_scalar(x_i + j, x_q + j, poff, ptap, npairs, n - j, out_i + j,
+                 out_q + j);
+}
+
+DSP_TARGET_SSE2
+static void q15_to_cf32_sse2(const int16_t* x_i, const int16_t* x_q,
+                             size_t n, float scale, float* out) {
+  const __m128 sc = _mm_set1_ps(scale);
+  size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    __m128i i = _mm_loadu_si128((const __m128i*)(x_i + k));
+    __m128i q = _mm_loadu_si128((const __m128i*)(x_q + k));
+    __m128i lo = _mm_unpacklo_epi16(i, q);
+    __m128i hi = _mm_unpackhi_epi16(i, q);
+    __m128i d0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16);
+    __m128i d1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16);
+    __m128i d2 = _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16);
+    __m128i d3 = _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16);
+    _mm_storeu_ps(out + 2 * k, _mm_mul_ps(_mm_cvtepi32_ps(d0), sc));
+    _mm_storeu_ps(out + 2 * k + 4, _mm_mul_ps(_mm_cvtepi32_ps(d1), sc));
+    _mm_storeu_ps(out + 2 * k + 8, _mm_mul_ps(_mm_cvtepi32_ps(d2), sc));
+    _mm_storeu_ps(out + 2 * k + 12, _mm_mul_ps(_mm_cvtepi32_ps(d3), sc));
+  }
+  q15_to_cf32_scalar(x_i + k, x_q + k, n - k, scale, out + 2 * k);
+}
+
+DSP_TARGET_AVX2
+static void iq16_to_q15_avx2(const int16_t* raw, size_t n, int16_t i_dc,
+                             int16_t q_dc, int16_t* out_i, int16_t* out_q,
+                             uint64_t* pwr_acc) {
+  const __m256i dc = _mm256_set1_epi32(
+      (int)((uint16_t)i_dc | ((uint32_t)(uint16_t)q_dc << 16)));
+  const __m256i lim = _mm256_set1_epi16(-32767);
+  __m256i acc = _mm256_setzero_si256();
+  size_t k = 0;
+
+  /* 16 complex samples per iteration */
+  for (; k + 16 <= n; k += 16) {
+    __m256i d0 = _mm256_max_epi16(
+        _mm256_subs_epi16(
+            _mm256_loadu_si256((const __m256i*)(raw + 2 * k)), dc),
+        lim);
+    __m256i d1 = _mm256_max_epi16(
+        _mm256_subs_epi16(
+            _mm256_loadu_si256((const __m256i*)(raw + 2 * k + 16)), dc),
+        lim);
+    __m256i p0 = _mm256_madd_epi16(d0, d0);
+    __m256i p1 = _mm256_madd_epi16(d1, d1);
+    acc = _mm256_add_epi64(
+        acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(p0)));
+    acc = _mm256_add_epi64(
+        acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(p0, 1)));
+    acc = _mm256_add_epi64(
+        acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(p1)));
+    acc = _mm256_add_epi64(
+        acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(p1, 1)));
+    __m256i i0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+    __m256i i1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+    __m256i q0 = _mm256_srai_epi32(d0, 16);
+    __m256i q1 = _mm256_srai_epi32(d1, 16);
+    /* packs works per 128-bit lane: restore sample order */
+    _mm256_storeu_si256(
+        (__m256i*)(out_i + k),
+        _mm256_permute4x64_epi64(_mm256_packs_epi32(i0, i1), 0xD8));
+    _mm256_storeu_si256(
+        (__m256i*)(out_q + k),
+        _mm256_permute4x64_epi64(_mm256_packs_epi32(q0, q1), 0xD8));
+  }
+
+  if (pwr_acc) {
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    *pwr_acc += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  }
+  iq16_to_q15_scalar(raw + 2 * k, n - k, i_dc, q_dc, out_i + k, out_q + k,
+                     pwr_acc);
+}
+
+DSP_TARGET_AVX2
+static void iq16_to_q15_poly_avx2(const int16_t* raw, size_t n, int decim,
+                                  int16_t i_dc, int16_t q_dc, size_t stride,
+                                  int16_t* out_i, int16_t* out_q) {
+  const __m256i dc = _mm256_set1_epi32(
+      (int)((uint16_t)i_dc | ((uint32_t)(uint16_t)q_dc << 16)));
+  const __m256i lim = _mm256_set1_epi16(-32767);
+  /* One I/Q pair (32 bits) per lane, decim pairs apart */
+  const __m256i idx = _mm256_mullo_epi32(
+      _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(decim));
+  const size_t step = 2 * (size_t)decim;
+
+  for (int p = 0; p < decim; p++) {
+    const int16_t* s = raw + 2 * (size_t)p;
+    int16_t* oi = out_i + (size_t)p * stride;
+    int16_t* oq = out_q + (size_t)p * stride;
+    size_t q = 0;
+
+    /* 16 samples of the phase per iteration */
+    for (; q + 16 <= n; q += 16) {
+      __m256i d0 = _mm256_max_epi16(
+          _mm256_subs_epi16(
+              _mm256_i32gather_epi32((const int*)(s + q * step), idx, 4),
+              dc),
+          lim);
+      __m256i d1 = _mm256_max_epi16(
+          _mm256_subs_epi16(_mm256_i32gather_epi32(
+                                (const int*)(s + (q + 8) * step), idx, 4),
+                            dc),
+          lim);
+      __m256i i0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+      __m256i i1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+      __m256i q0 = _mm256_srai_epi32(d0, 16);
+      __m256i q1 = _mm256_srai_epi32(d1, 16);
+      /* packs works per 128-bit lane: restore sample order */
+      _mm256_storeu_si256(
+          (__m256i*)(oi + q),
+          _mm256_permute4x64_epi64(_mm256_packs_epi32(i0, i1), 0xD8));
+      _mm256_storeu_si256(
+          (__m256i*)(oq + q),
+          _mm256_permute4x64_epi64(_mm256_packs_epi32(q0, q1), 0xD8));
+    }
+    for (; q < n; q++) {
+      oi[q] = q15_sat((int32_t)s[q * step] - i_dc);
+      oq[q] = q15_sat((int32_t)s[q * step + 1] - q_dc);
+    }
+  }
+}
+
+DSP_TARGET_AVX2
+static inline __m256i avx2_q15_finish(__m256i ae, __m256i ao) {
+  const __m256i rnd = _mm256_set1_epi32(1 << 14);
+  const __m256i order =
+      _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+                       0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+  __m256i e = _mm256_srai_epi32(_mm256_add_epi32(ae, rnd), 15);
+  __m256i o = _mm256_srai_epi32(_mm256_add_epi32(ao, rnd), 15);
+  /* Per lane: e0 e2 e4 e6 o1 o3 o5 o7 -> 0 1 2 3 4 5 6 7 */
+  return _mm256_shuffle_epi8(_mm256_packs_epi32(e, o), order);
+}
+
+DSP_TARGET_AVX2
+static void fir_q15_avx2(const int16_t* x_i, const int16_t* x_q,
+                         const size_t* poff, const int32_t* ptap, int npairs,
+                         size_t n, int16_t* out_i, int16_t* out_q) {
+  size_t j = 0;
+  for (; j + 32 <= n; j += 32) {
+    __m256i ei0 = _mm256_setzero_si256(), oi0 = _mm256_setzero_si256();
+    __m256i ei1 = _mm256_setzero_si256(), oi1 = _mm256_setzero_si256();
+    __m256i eq0 = _mm256_setzero_si256(), oq0 = _mm256_setzero_si256();
+    __m256i eq1 = _mm256_setzero_si256(), oq1 = _mm256_setzero_si256();
+    for (int k = 0; k < npairs; k++) {
+      __m256i t = _mm256_set1_epi32(ptap[k]);
+      const int16_t* pi = x_i + j + poff[k];
+      const int16_t* pq = x_q + j + poff[k];
+#define Q15_MADD(acc, p) \
+  acc = _mm256_add_epi32(  \
+      acc, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(p)), t))
+      Q15_MADD(ei0, pi);
+      Q15_MADD(oi0, pi + 1);
+      Q15_MADD(ei1, pi + 16);
+      Q15_MADD(oi1, pi + 17);
+      Q15_MADD(eq0, pq);
+      Q15_MADD(oq0, pq + 1);
+      Q15_MADD(eq1, pq + 16);
+      Q15_MADD(oq1, pq + 17);
+#undef Q15_MADD
+    }
+    _mm256_storeu_si256((__m256i*)(out_i + j), avx2_q15_finish(ei0, oi0));
+    _mm256_storeu_si256((__m256i*)(out_i + j + 16),
+                        avx2_q15_finish(ei1, oi1));
+    _mm256_storeu_si256((__m256i*)(out_q + j), avx2_q15_finish(eq0, oq0));
+    _mm256_storeu_si256((__m256i*)(out_q + j + 16),
+                        avx2_q15_finish(eq1, oq1));
+  }
+  fir_q15_sse2(x_i + j, x_q + j, poff, ptap, npairs, n - j, out_i + j,
+               out_q + j);
+}
+
+DSP_TARGET_AVX2
+static void q15_to_cf32_avx2(const int16_t* x_i, const int16_t* x_q,
+                             size_t n, float scale, float* out) {
+  const __m256 sc = _mm256_set1_ps(scale);
+  size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    __m128i i = _mm_loadu_si128((const __m128i*)(x_i + k));
+    __m128i q = _mm_loadu_si128((const __m128i*)(x_q + k));
+    __m256i lo = _mm256_cvtepi16_epi32(_mm_unpacklo_epi16(i, q));
+    __m256i hi = _mm256_cvtepi16_epi32(_mm_unpackhi_epi16(i, q));
+    _mm256_storeu_ps(out + 2 * k, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), sc));
+    _mm256_storeu_ps(out + 2 * k + 8,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(hi), sc));
+  }
+  q15_to_cf32_scalar(x_i + k, x_q + k, n - k, scale, out + 2 * k);
+}
+
+#endif /* DSP_X86 */
+
+/* *****************************************************************************
+ *
+ *                         DISPATCH
+ *
+ * *****************************************************************************/
+
+#if DSP_X86
+#define DSP_DISPATCH(name, ...)                  \
+  do {                                           \
+    int f_ = dsp_cpu_features();                 \
+    if (f_ & DSP_CPU_AVX2) {                     \
+      name##_avx2(__VA_ARGS__);                  \
+      return;                                    \
+    }                                            \
+    if (f_ & DSP_CPU_SSE2) {                     \
+      name##_sse2(__VA_ARGS__);                  \
+      return;                                    \
+    }                                            \
+    name##_scalar(__VA_ARGS__);                  \
+  } while (0)
+#else
+#define DSP_DISPATCH(name, ...) name##_scalar(__VA_ARGS__)
+#endif
+
+void dsp_iq8_to_cf32(const int8_t* raw, size_t n, float i_dc, float q_dc,
+                     float scale, float* out, double* pwr_acc) {
+  DSP_DISPATCH(iq8_to_cf32, raw, n, i_dc, q_dc, scale, out, pwr_acc);
+}
+
+void dsp_iq16_to_cf32(const int16_t* raw, size_t n, float i_dc, float q_dc,
+                      float scale, float* out, double* pwr_acc) {
+  DSP_DISPATCH(iq16_to_cf32, raw, n, i_dc, q_dc, scale, out, pwr_acc);
+}
+
+void dsp_iq32_to_cf32(const int32_t* raw, size_t n, float i_dc, float q_dc,
+                      float scale, float* out, double* pwr_acc) {
+  DSP_DISPATCH(iq32_to_cf32, raw, n, i_dc, q_dc, scale, out, pwr_acc);
+}
+
+void dsp_cf32_to_cf32(const float* raw, size_t n, float i_dc, float q_dc,
+                      float scale, float* out, double* pwr_acc) {
+  DSP_DISPATCH(cf32_to_cf32, raw, n, i_dc, q_dc, scale, out, pwr_acc);
+}
+
+void dsp_cf32_stats(const float* x, size_t n, double* sum_i, double* sum_q,
+                    double* sum_pwr) {
+#if DSP_X86
+  if (dsp_cpu_features() & DSP_CPU_AVX2) {
+    cf32_stats_avx2(x, n, sum_i, sum_q, sum_pwr);
+    return;
+  }
+#endif
+  cf32_stats_scalar(x, n, sum_i, sum_q, sum_pwr);
+}
+
+/**
+ * Float offsets of every tap's input relative to output 0
+ *
+ * Phase stream p of a polyphase input starts at p * stride samples; tap k
+ * reads phase k % decim, k / decim samples in. decim = 1 is a plain FIR.
+ */
+static void fir_tap_offsets(size_t* koff, int ntaps, int decim,
+                            size_t stride) {
+  int ph = 0;
+  size_t off = 0;
+  for (int k = 0; k < ntaps; k++) {
+    koff[k] = 2 * ((size_t)ph * stride + off);
+    if (++ph == decim) {
+      ph = 0;
+      off++;
+    }
+  }
+}
+
+#if DSP_X86
+#define DSP_DISPATCH_FIR(name, ...)              \
+  do {                                           \
+    int f_ = dsp_cpu_features();                 \
+    if (f_ & DSP_CPU_AVX512) {                   \
+      name##_avx512(__VA_ARGS__);                \
+    } else if (f_ & DSP_CPU_AVX2) {              \
+      name##_avx2(__VA_ARGS__);                  \
+    } else if (f_ & DSP_CPU_SSE2) {              \
+      name##_sse2(__VA_ARGS__);                  \
+    } else {                                     \
+      name##_scalar(__VA_ARGS__);                \
+    }                                            \
+  } while (0)
+#else
+#define DSP_DISPATCH_FIR(name, ...) name##_scalar(__VA_ARGS__)
+#endif
+
+int dsp_fir_symmetric(const float* taps, int ntaps) {
+  if (ntaps < 2) return 0;
+  for (int k = 0; k < ntaps / 2; k++) {
+    if (taps[k] != taps[ntaps - 1 - k]) return 0;
+  }
+  return 1;
+}
+
+void dsp_fir_cf32(const float* x, size_t n, const float* taps, int ntaps,
+                  float* out) {
+  if (dsp_fir_symmetric(taps, ntaps)) {
+    DSP_DISPATCH_FIR(fir_sym_cf32, x, n, taps, ntaps, out);
+  } else {
+    DSP_DISPATCH_FIR(fir_cf32, x, n, taps, ntaps, out);
+  }
+}
+
+void dsp_fir_poly_cf32(const float* x, size_t stride, int decim, size_t n,
+                       const float* taps, int ntaps, float* out) {
+  size_t stack[DSP_FIR_STACK_TAPS];
+  size_t* koff = ntaps <= DSP_FIR_STACK_TAPS
+                     ? stack
+                     : (size_t*)malloc((size_t)ntaps * sizeof(size_t));
+  if (!koff) return;
+  fir_tap_offsets(koff, ntaps, decim, stride);
+
+  if (dsp_fir_symmetric(taps, ntaps)) {
+    DSP_DISPATCH_FIR(fir_poly_sym_cf32, x, koff, n, taps, ntaps, out);
+  } else {
+    DSP_DISPATCH_FIR(fir_poly_cf32, x, koff, n, taps, ntaps, out);
+  }
+
+  if (koff != stack) free(koff);
+}
+
+/**
+ * Pair up the taps of a polyphase Q15 filter
+ *
+ * Within phase p the taps p, p + decim, p + 2*decim, ... read consecutive
+ * samples of the phase stream; they are paired in that order, a lone last
+ * tap with a zero. Returns the number of pairs (at most ntaps).
+ */
+static int fir_q15_pairs(const int16_t* taps, int ntaps, int decim,
+                         size_t stride, size_t* poff, int32_t* ptap) {
+  int np = 0;
+  for (int p = 0; p < decim && p < ntaps; p++) {
+    for (int k = p; k < ntaps; k += 2 * decim) {
+      int16_t ta = taps[k];
+      int16_t tb = k + decim < ntaps ? taps[k + decim] : 0;
+      poff[np] = (size_t)p * stride + (size_t)(k / decim);
+      ptap[np] = (int32_t)((uint32_t)(uint16_t)ta |
+                           ((uint32_t)(uint16_t)tb << 16));
+      np++;
+    }
+  }
+  return np;
+}
+
+static void fir_q15_run(const int16_t* x_i, const int16_t* x_q,
+                        const size_t* poff, const int32_t* ptap, int npairs,
+                        size_t n, int16_t* out_i, int16_t* out_q) {
+  DSP_DISPATCH(fir_q15, x_i, x_q, poff, ptap, npairs, n, out_i, out_q);
+}
+
+float dsp_q15_taps(const float* taps, int ntaps, int16_t* out) {
+  double sum = 0.0;
+  for (int k = 0; k < ntaps; k++) sum += fabs((double)taps[k]);
+  if (!(sum > 0.0)) {
+    memset(out, 0, (size_t)ntaps * sizeof(int16_t));
+    return 0.0f;
+  }
+  /* Leave room for rounding up: sum(|out|) stays within 32767 */
+  double full = 32767.0 - 0.5 * ntaps;
+  if (full < 1.0) full = 1.0;
+  double q = full / sum;
+  for (int k = 0; k < ntaps; k++) {
+    out[k] = (int16_t)floor((double)taps[k] * q + 0.5);
+  }
+  return (float)(32768.0 / q);
+}
+
+void dsp_iq16_to_q15(const int16_t* raw, size_t n, int16_t i_dc, int16_t q_dc,
+                     int16_t* out_i, int16_t* out_q, uint64_t* pwr_acc) {
+  DSP_DISPATCH(iq16_to_q15, raw, n, i_dc, q_dc, out_i, out_q, pwr_acc);
+}
+
+void dsp_iq16_to_q15_poly(const int16_t* raw, size_t n, int decim,
+                          int16_t i_dc, int16_t q_dc, size_t stride,
+                          int16_t* out_i, int16_t* out_q) {
+  DSP_DISPATCH(iq16_to_q15_poly, raw, n, decim, i_dc, q_dc, stride, out_i,
+               out_q);
+}
+
+void dsp_fir_poly_q15(const int16_t* x_i, const int16_t* x_q, size_t stride,
+                      int decim, size_t n, const int16_t* taps, int ntaps,
+                      int16_t* out_i, int16_t* out_q) {
+  size_t off_stack[DSP_FIR_STACK_TAPS];
+  int32_t tap_stack[DSP_FIR_STACK_TAPS];
+  int big = ntaps > DSP_FIR_STACK_TAPS;
+  size_t* poff =
+      big ? (size_t*)malloc((size_t)ntaps * sizeof(size_t)) : off_stack;
+  int32_t* ptap =
+      big ? (int32_t*)malloc((size_t)ntaps * sizeof(int32_t)) : tap_stack;
+  if (poff && ptap) {
+    if (decim < 1) decim = 1;
+    int np = fir_q15_pairs(taps, ntaps, decim, stride, poff, ptap);
+    fir_q15_run(x_i, x_q, poff, ptap, np, n, out_i, out_q);
+  }
+  if (big) {
+    free(poff);
+    free(ptap);
+  }
+}
+
+void dsp_q15_to_cf32(const int16_t* x_i, const int16_t* x_q, size_t n,
+                     float scale, float* out) {
+  DSP_DISPATCH(q15_to_cf32, x_i, x_q, n, scale, out);
+}
@@ -0,0 +1,286 @@
+/*
+ * dsp_simd.h
+ *
+ *  SIMD signal processing kernels with runtime CPU dispatch.
+ *
+ *  Complex samples are passed as interleaved float arrays (re, im, re, im,
+ *  ...), which is layout compatible with the demodulator's cplxf type.
+ *  Every kernel has a scalar reference; all dispatch paths produce the same
+ *  samples (accumulated sums may differ in the last bits of rounding).
+ */
+
+#ifndef DSP_SIMD_H_
+#define DSP_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* =============================================================================
+ * CPU FEATURES
+ * =============================================================================
+ */
+#define DSP_CPU_SSE2 0x01   /* SSE2 available                        */
+#define DSP_CPU_AVX2 0x02   /* AVX2 available (and enabled by OS)    */
+#define DSP_CPU_AVX512 0x04 /* AVX-512F available (and enabled by OS) */
+
+/**
+ * Detect the SIMD instruction sets usable on this machine
+ * @return Bitmask of DSP_CPU_* flags
+ */
+int dsp_cpu_features(void);
+
+/**
+ * Cap the instruction sets the kernels may dispatch to
+ * @param max_level  0 = scalar, 1 = up to SSE2, 2 = up to AVX2,
+ *                   3 = up to AVX-512
+ */
+void dsp_simd_limit(int max_level);
+
+/**
+ * Name of the widest instruction set the kernels dispatch to
+ * @return "AVX-512", "AVX2", "SSE2" or "scalar"
+ */
+const char* dsp_simd_level(void);
+
+/* =============================================================================
+ * IQ CONVERSION
+ * -----------------------------------------------------------------------------
+ * Fused int -> complex float conversion: one pass converts, removes DC,
+ * scales to volts and accumulates sum(|v|^2) for the power estimate.
+ *   out[k] = ((float)raw[k] - dc) * scale
+ * =============================================================================
+ */
+
+/**
+ * Convert interleaved int8 I/Q samples (cs8)
+ *
+ * @param raw      Interleaved int8 I/Q samples
+ * @param n        Number of complex samples
+ * @param i_dc     DC offset of I (counts)
+ * @param q_dc     DC offset of Q (counts)
+ * @param scale    Volts per count
+ * @param out      Output: interleaved float I/Q (2*n floats)
+ * @param pwr_acc  In/out: running sum of |out|^2 (NULL to skip)
+ */
+void dsp_iq8_to_cf32(const int8_t* raw, size_t n, float i_dc, float q_dc,
+                     float scale, float* out, double* pwr_acc);
+
+/**
+ * Convert interleaved int16 I/Q samples
+ *
+ * @param raw      Interleaved int16 I/Q samples
+ * @param n        Number of complex samples
+ * @param i_dc     DC offset of I (counts)
+ * @param q_dc     DC offset of Q (counts)
+ * @param scale    Volts per count
+ * @param out      Output: interleaved float I/Q (2*n floats)
+ * @param pwr_acc  In/out: running sum of |out|^2 (NULL to skip)
+ */
+void dsp_iq16_to_cf32(const int16_t* raw, size_t n, float i_dc, float q_dc,
+                      float scale, float* out, double* pwr_acc);
+
+/**
+ * Convert interleaved int32 I/Q samples
+ *
+ * @param raw      Interleaved int32 I/Q samples
+ * @param n        Number of complex samples
+ * @param i_dc     DC offset of I (counts)
+ * @param q_dc     DC offset of Q (counts)
+ * @param scale    Volts per count
+ * @param out      Output: interleaved float I/Q (2*n floats)
+ * @param pwr_acc  In/out: running sum of |out|^2 (NULL to skip)
+ */
+void dsp_iq32_to_cf32(const int32_t* raw, size_t n, float i_dc, float q_dc,
+                      float scale, float* out, double* pwr_acc);
+
+/**
+ * Remove DC from and scale interleaved float I/Q samples (cf32)
+ *
+ * @param raw      Interleaved float I/Q samples
+ * @param n        Number of complex samples
+ * @param i_dc     DC offset of I
+ * @param q_dc     DC offset of Q
+ * @param scale    Volts per unit
+ * @param out      Output: interleaved float I/Q (2*n floats, may be raw)
+ * @param pwr_acc  In/out: running sum of |out|^2 (NULL to skip)
+ */
+void dsp_cf32_to_cf32(const float* raw, size_t n, float i_dc, float q_dc,
+                      float scale, float* out, double* pwr_acc);
+
+/**
+ * Accumulate the I/Q sums and the power sum of float I/Q samples
+ *
+ * Read-only statistics pass for captures that are used in place.
+ *
+ * @param x        Interleaved float I/Q samples
+ * @param n        Number of complex samples
+ * @param sum_i    In/out: running sum of I
+ * @param sum_q    In/out: running sum of Q
+ * @param sum_pwr  In/out: running sum of |x|^2
+ */
+void dsp_cf32_stats(const float* x, size_t n, double* sum_i, double* sum_q,
+                    double* sum_pwr);
+
+/* =============================================================================
+ * FIR FILTERING
+ * -----------------------------------------------------------------------------
+ * Complex-by-real FIR over fully overlapping inputs only (no edge checks):
+ *   out[j] = sum_{k=0}^{ntaps-1} taps[k] * x[j + k]
+ * optionally decimating, computing only the outputs that are kept.
+ * Vector paths compute neighbouring outputs in separate lanes and add the
+ * taps in the same order as the scalar loop, so every path produces the
+ * same samples bit for bit.
+ *
+ * Symmetric (linear-phase) taps are detected and run through folded
+ * kernels that add the two inputs sharing a tap before the multiply,
+ * halving the multiplies. All paths still agree with each other bit for
+ * bit; the sums differ from the unfolded kernels in rounding only.
+ * =============================================================================
+ */
+
+/**
+ * Check whether taps are exactly symmetric (taps[k] == taps[ntaps-1-k])
+ *
+ * @param taps   Filter coefficients
+ * @param ntaps  Number of taps
+ * @return 1 if the folded kernels apply, 0 otherwise
+ */
+int dsp_fir_symmetric(const float* taps, int ntaps);
+
+/**
+ * Filter interleaved complex samples with real taps
+ *
+ * @param x      Interleaved float I/Q input (n + ntaps - 1 samples)
+ * @param n      Number of output samples
+ * @param taps   Filter coefficients
+ * @param ntaps  Number of taps
+ * @param out    Output: interleaved float I/Q (2*n floats, not x)
+ */
+void dsp_fir_cf32(const float* x, size_t n, const float* taps, int ntaps,
+                  float* out);
+
+/**
+ * Decimating FIR over a polyphase (deinterleaved) input
+ *
+ * Computes only the kept outputs of a FIR followed by decimation:
+ *   out[j] = sum_k taps[k] * s[j * decim + k]
+ * with s split into decim phase streams, phase p holding s[q * decim + p]
+ * at x + 2 * (p * stride + q). Bit-identical to dsp_fir_cf32() on s
+ * followed by taking every decim-th output.
+ *
+ * @param x       Phase streams, interleaved float I/Q
+ * @param stride  Samples between the starts of two phase streams
+ * @param decim   Decimation factor (number of phase streams)
+ * @param n       Number of output samples
+ * @param taps    Filter coefficients
+ * @param ntaps   Number of taps
+ * @param out     Output: interleaved float I/Q (2*n floats)
+ */
+void dsp_fir_poly_cf32(const float* x, size_t stride, int decim, size_t n,
+                       const float* taps, int ntaps, float* out);
+
+/* =============================================================================
+ * Q15 FIXED POINT
+ * -----------------------------------------------------------------------------
+ * int16 front-end for int16 captures. Signals are kept as separate I and Q
+ * planes of int16 and filtered with Q15 taps scaled so that sum(|taps|) is
+ * at most 1, which keeps every sum inside int32 and every output inside
+ * int16:
+ *   out[j] = (sum_k taps[k] * s[j * decim + k] + 2^14) >> 15
+ * The vector paths multiply and add pairs of 16-bit values in one step
+ * (twice the lanes of a float kernel). Integer sums are exact, so every
+ * path produces the same samples bit for bit.
+ * =============================================================================
+ */
+
+/**
+ * Quantize float taps to Q15
+ *
+ * @param taps   Filter coefficients
+ * @param ntaps  Number of taps
+ * @param out    Output: Q15 taps (ntaps values)
+ * @return Gain g such that taps[k] ~= out[k] * g / 32768; a Q15 filter
+ *         output times g is the float filter output
+ */
+float dsp_q15_taps(const float* taps, int ntaps, int16_t* out);
+
+/**
+ * Remove DC from interleaved int16 I/Q samples into I and Q planes
+ *
+ *   out_i[k] = sat16(raw[2k] - i_dc), out_q[k] = sat16(raw[2k+1] - q_dc)
+ * (saturated to +-32767)
+ *
+ * @param raw      Interleaved int16 I/Q samples
+ * @param n        Number of complex samples
+ * @param i_dc     DC offset of I (counts)
+ * @param q_dc     DC offset of Q (counts)
+ * @param out_i    Output: I plane (n values)
+ * @param out_q    Output: Q plane (n values)
+ * @param pwr_acc  In/out: running sum of |out|^2 in counts^2 (NULL to skip)
+ */
+void dsp_iq16_to_q15(const int16_t* raw, size_t n, int16_t i_dc, int16_t q_dc,
+                     int16_t* out_i, int16_t* out_q, uint64_t* pwr_acc);
+
+/**
+ * Remove DC from interleaved int16 I/Q samples into polyphase I and Q planes
+ *
+ * Input q * decim + p goes to out_i[p * stride + q] and
+ * out_q[p * stride + q], saturated as in dsp_iq16_to_q15(): the layout
+ * dsp_fir_poly_q15() reads, without a separate split pass.
+ *
+ * @param raw     Interleaved int16 I/Q samples (n * decim read)
+ * @param n       Number of samples per phase
+ * @param decim   Number of phase streams
+ * @param i_dc    DC offset of I (counts)
+ * @param q_dc    DC offset of Q (counts)
+ * @param stride  Samples between the starts of two phase streams
+ * @param out_i   Output: phase streams of the I plane
+ * @param out_q   Output: phase streams of the Q plane (same layout)
+ */
+void dsp_iq16_to_q15_poly(const int16_t* raw, size_t n, int decim,
+                          int16_t i_dc, int16_t q_dc, size_t stride,
+                          int16_t* out_i, int16_t* out_q);
+
+/**
+ * Decimating Q15 FIR over polyphase I and Q planes
+ *
+ * Same layout as dsp_fir_poly_cf32(), per plane: phase p holds
+ * s[q * decim + p] at x + p * stride + q. Each phase stream must hold
+ * n + ceil(ntaps / decim) samples (taps are read in pairs). decim = 1 is
+ * a plain FIR over the planes.
+ *
+ * @param x_i     Phase streams of the I plane
+ * @param x_q     Phase streams of the Q plane (same layout)
+ * @param stride  Samples between the starts of two phase streams
+ * @param decim   Decimation factor (number of phase streams)
+ * @param n       Number of output samples
+ * @param taps    Q15 filter coefficients (sum of |taps| <= 32767)
+ * @param ntaps   Number of taps
+ * @param out_i   Output: I plane (n samples)
+ * @param out_q   Output: Q plane (n samples)
+ */
+void dsp_fir_poly_q15(const int16_t* x_i, const int16_t* x_q, size_t stride,
+                      int decim, size_t n, const int16_t* taps, int ntaps,
+                      int16_t* out_i, int16_t* out_q);
+
+/**
+ * Interleave and scale I and Q planes to complex float
+ *
+ * @param x_i    I plane
+ * @param x_q    Q plane
+ * @param n      Number of complex samples
+ * @param scale  Float units per count
+ * @param out    Output: interleaved float I/Q (2*n floats)
+ */
+void dsp_q15_to_cf32(const int16_t* x_i, const int16_t* x_q, size_t n,
+                     float scale, float* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSP_SIMD_H_ */
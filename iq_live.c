@@ -0,0 +1,509 @@
+/*
+ * iq_live.c
+ *
+ *  Live IQ input from a pipe or a UDP stream.
+ */
+
+#include "iq_live.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <Windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+/* *****************************************************************************
+ *
+ *                         PLATFORM HELPERS
+ *
+ * *****************************************************************************/
+
+#ifdef _WIN32
+typedef SOCKET live_socket;
+#define LIVE_NO_SOCKET INVALID_SOCKET
+#define live_close_socket closesocket
+#define LIVE_SOCKET_ERROR() WSAGetLastError()
+#else
+typedef int live_socket;
+#define LIVE_NO_SOCKET (-1)
+#define live_close_socket close
+#define LIVE_SOCKET_ERROR() errno
+#endif
+
+/*
+ * Ring positions are shared between exactly one producer and one consumer.
+ * Each side only writes its own position, so an acquire load of the other
+ * side's position and a release store of its own are all the ring needs.
+ */
+#ifdef _WIN32
+#define LIVE_LOAD(p) \
+  ((uint64_t)InterlockedCompareExchange64((volatile LONG64*)(p), 0, 0))
+#define LIVE_STORE(p, v) \
+  InterlockedExchange64((volatile LONG64*)(p), (LONG64)(v))
+#else
+#define LIVE_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define LIVE_STORE(p, v) __atomic_store_n((p), (uint64_t)(v), __ATOMIC_RELEASE)
+#endif
+
+#define LIVE_PIPE 0 /* stdin or named pipe          */
+#define LIVE_UDP 1  /* UDP datagrams                */
+
+#define LIVE_CACHE_LINE 64
+
+typedef struct IqLive {
+  /* Producer side */
+  uint64_t head; /* Bytes written into the ring            */
+  unsigned char pad_head[LIVE_CACHE_LINE - sizeof(uint64_t)];
+
+  /* Consumer side */
+  uint64_t tail; /* Bytes consumed from the ring           */
+  size_t held;   /* Bytes handed out by the last next()    */
+  unsigned char pad_tail[LIVE_CACHE_LINE - sizeof(uint64_t) - sizeof(size_t)];
+
+  uint64_t stop;     /* Receiver asked to exit                 */
+  uint64_t eof;      /* Receiver reached end of stream         */
+  IqLiveStats stats; /* Written by the receiver only           */
+
+  unsigned char* ring; /* Ring storage                         */
+  size_t cap;          /* Ring capacity (whole samples)        */
+  size_t sample_bytes; /* Bytes per complex sample             */
+
+  int kind;           /* LIVE_PIPE or LIVE_UDP                 */
+  int fd;             /* Pipe file descriptor                  */
+  live_socket sock;   /* UDP socket                            */
+  unsigned char* pkt; /* Datagram receive buffer               */
+
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+  int running; /* Receiver thread started                       */
+} IqLive;
+
+/**
+ * Sleep for a number of microseconds
+ */
+static void live_sleep_us(unsigned int us) {
+#ifdef _WIN32
+  Sleep(us >= 1000 ? us / 1000 : 1);
+#else
+  usleep(us);
+#endif
+}
+
+/**
+ * Add to a receiver counter (only the receiver writes counters)
+ */
+static void live_count(uint64_t* counter, uint64_t add) {
+  LIVE_STORE(counter, *counter + add);
+}
+
+/* *****************************************************************************
+ *
+ *                         UDP RECEIVER SETUP
+ *
+ * *****************************************************************************/
+
+/**
+ * Split "udp:[host:]port" into host and port
+ *
+ * @return 0 on success, -1 if the port is missing or invalid
+ */
+static int live_parse_udp(const char* name, char* host, size_t cap,
+                          unsigned short* port) {
+  const char* p = name + strlen(IQ_LIVE_UDP);
+  const char* colon = strrchr(p, ':');
+  const char* port_str = colon ? colon + 1 : p;
+
+  if (colon) {
+    size_t len = (size_t)(colon - p);
+    if (len + 1 > cap) return -1;
+    memcpy(host, p, len);
+    host[len] = '\0';
+  } else {
+    snprintf(host, cap, "%s", "0.0.0.0");
+  }
+
+  char* end;
+  long v = strtol(port_str, &end, 10);
+  if (end == port_str || *end != '\0' || v <= 0 || v > 65535) return -1;
+  *port = (unsigned short)v;
+  return 0;
+}
+
+/**
+ * Create a UDP socket bound to host:port
+ *
+ * Same steps as createUdpReceiver() in socket_comm.c, plus a large receive
+ * buffer for sample streams and a receive timeout so the thread can be
+ * stopped.
+ *
+ * @return Bound socket, LIVE_NO_SOCKET on error
+ */
+static live_socket live_udp_receiver(const char* host, unsigned short port) {
+  /* 1. Create a UDP socket */
+  live_socket sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock == LIVE_NO_SOCKET) {
+    fprintf(stderr, "[LIVE] Socket creation failed with error: %d\n",
+            LIVE_SOCKET_ERROR());
+    return LIVE_NO_SOCKET;
+  }
+
+  /* 2. Set socket options (SO_REUSEADDR, receive buffer, timeout) */
+  int opt = 1;
+  if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) <
+      0) {
+    fprintf(stderr, "[LIVE] setsockopt failed with error: %d\n",
+            LIVE_SOCKET_ERROR());
+    live_close_socket(sock);
+    return LIVE_NO_SOCKET;
+  }
+
+  int rcvbuf = (int)IQ_LIVE_UDP_RCVBUF;
+  setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (char*)&rcvbuf, sizeof(rcvbuf));
+
+#ifdef _WIN32
+  DWORD timeout = IQ_LIVE_TIMEOUT_MS;
+#else
+  struct timeval timeout;
+  timeout.tv_sec = IQ_LIVE_TIMEOUT_MS / 1000;
+  timeout.tv_usec = (IQ_LIVE_TIMEOUT_MS % 1000) * 1000;
+#endif
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
+
+  /* 3. Initialize the source structure */
+  struct sockaddr_in source;
+  memset(&source, 0, sizeof(source));
+  source.sin_family = AF_INET;
+  source.sin_port = htons(port);
+
+  /* 4. Convert IP address from text to binary form */
+  if (inet_pton(AF_INET, host, &source.sin_addr) <= 0) {
+    fprintf(stderr, "[LIVE] Invalid IP address: %s\n", host);
+    live_close_socket(sock);
+    return LIVE_NO_SOCKET;
+  }
+
+  /* 5. Bind the socket to the specified address and port */
+  if (bind(sock, (struct sockaddr*)&source, sizeof(source)) != 0) {
+    fprintf(stderr, "[LIVE] Bind failed with error: %d\n",
+            LIVE_SOCKET_ERROR());
+    live_close_socket(sock);
+    return LIVE_NO_SOCKET;
+  }
+
+  return sock;
+}
+
+/* *****************************************************************************
+ *
+ *                         RECEIVER THREAD
+ *
+ * *****************************************************************************/
+
+/**
+ * Wait until the pipe has data or the timeout expires
+ *
+ * @return 1 if a read will not block, 0 on timeout
+ */
+static int live_pipe_ready(IqLive* l) {
+#ifdef _WIN32
+  (void)l;
+  return 1; /* Blocking read, cancelled by iq_live_close() */
+#else
+  struct pollfd pfd;
+  pfd.fd = l->fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  return poll(&pfd, 1, IQ_LIVE_TIMEOUT_MS) != 0;
+#endif
+}
+
+/**
+ * Pipe receiver: read straight into the free part of the ring
+ *
+ * A pipe has flow control, so a full ring just delays the next read.
+ */
+static void live_pipe_loop(IqLive* l) {
+  int waiting = 0;
+
+  while (!LIVE_LOAD(&l->stop)) {
+    uint64_t head = l->head;
+    size_t space = l->cap - (size_t)(head - LIVE_LOAD(&l->tail));
+    if (space == 0) {
+      if (!waiting) live_count(&l->stats.full_waits, 1);
+      waiting = 1;
+      live_sleep_us(IQ_LIVE_POLL_US);
+      continue;
+    }
+    waiting = 0;
+    if (!live_pipe_ready(l)) continue;
+
+    size_t idx = (size_t)(head % l->cap);
+    size_t chunk = l->cap - idx < space ? l->cap - idx : space;
+#ifdef _WIN32
+    int got = _read(l->fd, l->ring + idx,
+                    (unsigned int)(chunk > 0x40000000u ? 0x40000000u : chunk));
+#else
+    ssize_t got = read(l->fd, l->ring + idx, chunk);
+    if (got < 0 && errno == EINTR) continue;
+#endif
+    if (got <= 0) break;
+
+    live_count(&l->stats.packets, 1);
+    live_count(&l->stats.bytes, (uint64_t)got);
+    LIVE_STORE(&l->head, head + (uint64_t)got);
+  }
+}
+
+/**
+ * UDP receiver: copy whole datagrams into the ring, dropping on overflow
+ *
+ * Datagrams are truncated to whole samples so that a dropped datagram
+ * never shifts the I/Q alignment of the ones after it. Datagrams too large
+ * for the receive buffer are dropped and counted the same way.
+ */
+static void live_udp_loop(IqLive* l) {
+  while (!LIVE_LOAD(&l->stop)) {
+    int got = (int)recv(l->sock, (char*)l->pkt, IQ_LIVE_UDP_MAX_PAYLOAD, 0);
+    if (got < 0) {
+#ifdef _WIN32
+      int err = WSAGetLastError();
+      if (err == WSAETIMEDOUT) continue;
+      if (err == WSAEMSGSIZE) {
+        /* Larger than the buffer: the truncated rest is lost, so the
+         * datagram is dropped (its size is at least the buffer's) */
+        live_count(&l->stats.packets, 1);
+        live_count(&l->stats.dropped_packets, 1);
+        live_count(&l->stats.dropped_bytes, IQ_LIVE_UDP_MAX_PAYLOAD);
+        continue;
+      }
+#else
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) continue;
+#endif
+      fprintf(stderr, "[LIVE] recv failed with error: %d\n",
+              LIVE_SOCKET_ERROR());
+      break;
+    }
+    if (got == 0) break; /* Empty datagram: end of stream */
+
+    size_t len = (size_t)got - (size_t)got % l->sample_bytes;
+    live_count(&l->stats.packets, 1);
+
+    uint64_t head = l->head;
+    size_t space = l->cap - (size_t)(head - LIVE_LOAD(&l->tail));
+    if (len > space) {
+      live_count(&l->stats.dropped_packets, 1);
+      live_count(&l->stats.dropped_bytes, (uint64_t)got);
+      continue;
+    }
+
+    size_t idx = (size_t)(head % l->cap);
+    size_t first = l->cap - idx < len ? l->cap - idx : len;
+    memcpy(l->ring + idx, l->pkt, first);
+    memcpy(l->ring, l->pkt + first, len - first);
+
+    live_count(&l->stats.bytes, (uint64_t)len);
+    LIVE_STORE(&l->head, head + len);
+  }
+}
+
+/**
+ * Receiver thread entry point
+ */
+#ifdef _WIN32
+static DWORD WINAPI live_main(LPVOID arg) {
+#else
+static void* live_main(void* arg) {
+#endif
+  IqLive* l = (IqLive*)arg;
+
+  if (l->kind == LIVE_UDP) {
+    live_udp_loop(l);
+  } else {
+    live_pipe_loop(l);
+  }
+  LIVE_STORE(&l->eof, 1);
+
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+/* *****************************************************************************
+ *
+ *                         PUBLIC API
+ *
+ * *****************************************************************************/
+
+int iq_live_is_spec(const char* name) {
+  if (strcmp(name, IQ_LIVE_STDIN) == 0) return 1;
+  if (strncmp(name, IQ_LIVE_UDP, strlen(IQ_LIVE_UDP)) == 0) return 1;
+#ifndef _WIN32
+  struct stat st;
+  if (stat(name, &st) == 0 && S_ISFIFO(st.st_mode)) return 1;
+#endif
+  return 0;
+}
+
+struct IqLive* iq_live_open(const char* name, size_t sample_bytes,
+                            size_t ring_bytes) {
+  ring_bytes -= ring_bytes % sample_bytes;
+  if (ring_bytes < IQ_LIVE_UDP_MAX_PAYLOAD) return NULL;
+
+  IqLive* l = (IqLive*)calloc(1, sizeof(IqLive));
+  if (!l) return NULL;
+  l->sample_bytes = sample_bytes;
+  l->cap = ring_bytes;
+  l->fd = -1;
+  l->sock = LIVE_NO_SOCKET;
+
+  l->ring = (unsigned char*)malloc(l->cap);
+  if (!l->ring) {
+    iq_live_close(l);
+    return NULL;
+  }
+
+  if (strncmp(name, IQ_LIVE_UDP, strlen(IQ_LIVE_UDP)) == 0) {
+    char host[64];
+    unsigned short port;
+    if (live_parse_udp(name, host, sizeof(host), &port) != 0) {
+      fprintf(stderr, "[LIVE] Expected udp:[host:]port, got: %s\n", name);
+      iq_live_close(l);
+      return NULL;
+    }
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+      fprintf(stderr, "[LIVE] WSAStartup failed\n");
+      iq_live_close(l);
+      return NULL;
+    }
+#endif
+    l->kind = LIVE_UDP;
+    l->pkt = (unsigned char*)malloc(IQ_LIVE_UDP_MAX_PAYLOAD);
+    l->sock = l->pkt ? live_udp_receiver(host, port) : LIVE_NO_SOCKET;
+    if (l->sock == LIVE_NO_SOCKET) {
+      iq_live_close(l);
+      return NULL;
+    }
+  } else if (strcmp(name, IQ_LIVE_STDIN) == 0) {
+    l->kind = LIVE_PIPE;
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    l->fd = _fileno(stdin);
+#else
+    l->fd = STDIN_FILENO;
+#endif
+  } else {
+    l->kind = LIVE_PIPE;
+#ifdef _WIN32
+    l->fd = _open(name, _O_RDONLY | _O_BINARY);
+#else
+    l->fd = open(name, O_RDONLY);
+#endif
+    if (l->fd < 0) {
+      iq_live_close(l);
+      return NULL;
+    }
+  }
+
+#ifdef _WIN32
+  l->thread = CreateThread(NULL, 0, live_main, l, 0, NULL);
+  l->running = l->thread != NULL;
+#else
+  l->running = pthread_create(&l->thread, NULL, live_main, l) == 0;
+#endif
+  if (!l->running) {
+    fprintf(stderr, "[LIVE] Cannot start receiver thread\n");
+    iq_live_close(l);
+    return NULL;
+  }
+  return l;
+}
+
+size_t iq_live_next(struct IqLive* l, size_t max_samples, const void** raw) {
+  /* Give the previous block back to the receiver */
+  if (l->held) {
+    l->tail += l->held;
+    l->held = 0;
+    LIVE_STORE(&l->tail, l->tail);
+  }
+  if (max_samples == 0) return 0;
+
+  uint64_t avail;
+  for (;;) {
+    /* Check eof first so data written just before it is not missed */
+    int done = LIVE_LOAD(&l->eof) != 0;
+    avail = LIVE_LOAD(&l->head) - l->tail;
+    if (avail >= l->sample_bytes) break;
+    if (done) return 0;
+    live_sleep_us(IQ_LIVE_POLL_US);
+  }
+
+  size_t idx = (size_t)(l->tail % l->cap);
+  size_t contig = l->cap - idx;
+  if ((uint64_t)contig > avail) contig = (size_t)avail;
+  size_t count = contig / l->sample_bytes;
+  if (count > max_samples) count = max_samples;
+
+  *raw = l->ring + idx;
+  l->held = count * l->sample_bytes;
+  return count;
+}
+
+void iq_live_stats(const struct IqLive* l, IqLiveStats* stats) {
+  stats->packets = LIVE_LOAD(&l->stats.packets);
+  stats->bytes = LIVE_LOAD(&l->stats.bytes);
+  stats->dropped_packets = LIVE_LOAD(&l->stats.dropped_packets);
+  stats->dropped_bytes = LIVE_LOAD(&l->stats.dropped_bytes);
+  stats->full_waits = LIVE_LOAD(&l->stats.full_waits);
+}
+
+void iq_live_close(struct IqLive* l) {
+  if (!l) return;
+
+  if (l->running) {
+    LIVE_STORE(&l->stop, 1);
+#ifdef _WIN32
+    if (l->kind == LIVE_PIPE) CancelSynchronousIo(l->thread);
+    WaitForSingleObject(l->thread, INFINITE);
+    CloseHandle(l->thread);
+#else
+    pthread_join(l->thread, NULL);
+#endif
+  }
+
+  if (l->sock != LIVE_NO_SOCKET) live_close_socket(l->sock);
+#ifdef _WIN32
+  if (l->kind == LIVE_UDP) WSACleanup();
+  if (l->fd >= 0 && l->fd != _fileno(stdin)) _close(l->fd);
+#else
+  if (l->fd >= 0 && l->fd != STDIN_FILENO) close(l->fd);
+#endif
+
+  free(l->pkt);
+  free(l->ring);
+  free(l);
+}
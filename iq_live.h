@@ -0,0 +1,101 @@
+/*
+ * iq_live.h
+ *
+ *  Live IQ input from a pipe or a UDP stream.
+ *
+ *  A receiver thread reads raw interleaved I/Q samples from stdin, a named
+ *  pipe or UDP datagrams into a lock-free single-producer/single-consumer
+ *  ring buffer. The DSP takes samples straight out of the ring, so a slow
+ *  block never blocks reception; when the ring is full, UDP datagrams are
+ *  dropped and counted instead. An empty datagram ends a UDP stream.
+ */
+
+#ifndef IQ_LIVE_H_
+#define IQ_LIVE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* =============================================================================
+ * LIVE INPUT PARAMETERS
+ * =============================================================================
+ */
+#define IQ_LIVE_RING_BYTES (64u << 20) /* Ring buffer capacity              */
+#define IQ_LIVE_UDP_MAX_PAYLOAD 65536  /* Largest datagram accepted         */
+#define IQ_LIVE_UDP_RCVBUF (8u << 20)  /* Socket receive buffer requested   */
+#define IQ_LIVE_TIMEOUT_MS 100         /* Receive timeout to check for stop */
+#define IQ_LIVE_POLL_US 1000           /* Consumer wait when ring is empty  */
+
+#define IQ_LIVE_STDIN "-"   /* Input name for standard input           */
+#define IQ_LIVE_UDP "udp:"  /* Input prefix: udp:[host:]port           */
+
+/* =============================================================================
+ * LIVE STATISTICS
+ * =============================================================================
+ */
+typedef struct {
+  uint64_t packets;         /* Datagrams (or pipe reads) received      */
+  uint64_t bytes;           /* Bytes put into the ring                 */
+  uint64_t dropped_packets; /* Datagrams dropped (full ring/oversized) */
+  uint64_t dropped_bytes;   /* Bytes of the dropped datagrams (at least
+                               IQ_LIVE_UDP_MAX_PAYLOAD for oversized) */
+  uint64_t full_waits;      /* Pipe reads delayed by a full ring       */
+} IqLiveStats;
+
+struct IqLive; /* Receiver state (private to iq_live.c) */
+
+/**
+ * Check whether an input name selects live input
+ *
+ * @param name  Input name given by the user
+ * @return 1 for "-", "udp:[host:]port" or a named pipe, 0 otherwise
+ */
+int iq_live_is_spec(const char* name);
+
+/**
+ * Open a live input and start its receiver thread
+ *
+ * @param name          "-" (stdin), "udp:[host:]port" or a named pipe path
+ * @param sample_bytes  Bytes per complex sample (e.g. 4 for IQ16)
+ * @param ring_bytes    Ring capacity (rounded down to whole samples)
+ * @return Receiver handle, NULL on error
+ */
+struct IqLive* iq_live_open(const char* name, size_t sample_bytes,
+                            size_t ring_bytes);
+
+/**
+ * Get the next block of raw samples, waiting until some are available
+ *
+ * The block is returned in place from the ring and stays valid until the
+ * next call to iq_live_next() or iq_live_close().
+ *
+ * @param live         Receiver
+ * @param max_samples  Maximum samples to return
+ * @param raw          Output: pointer to interleaved raw samples
+ * @return Number of samples in the block, 0 at end of stream
+ */
+size_t iq_live_next(struct IqLive* live, size_t max_samples, const void** raw);
+
+/**
+ * Read the reception counters
+ *
+ * @param live   Receiver
+ * @param stats  Output: counters so far
+ */
+void iq_live_stats(const struct IqLive* live, IqLiveStats* stats);
+
+/**
+ * Stop the receiver thread and release the ring
+ * @param live  Receiver (may be NULL)
+ */
+void iq_live_close(struct IqLive* live);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQ_LIVE_H_ */
@@ -0,0 +1,1003 @@
+/*
+ * iq_source.c
+ *
+ *  Memory-mapped IQ capture reader.
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include "iq_source.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <glob.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* *****************************************************************************
+ *
+ *                         WINDOW MANAGEMENT
+ *
+ * *****************************************************************************/
+
+/**
+ * Unmap the current window, if any
+ * @param src  Source
+ */
+static void iq_source_unmap(IqSource* src) {
+  if (!src->win) return;
+#ifdef _WIN32
+  UnmapViewOfFile((LPCVOID)src->win);
+#else
+  munmap((void*)src->win, src->win_len);
+#endif
+  src->win = NULL;
+  src->win_len = 0;
+}
+
+/**
+ * Map the window that holds the byte at the given file offset
+ *
+ * @param src      Source
+ * @param offset   File offset that must be covered by the window
+ * @param max_len  Maximum window length in bytes
+ * @return 0 on success, -1 on error
+ */
+static int iq_source_map(IqSource* src, uint64_t offset, uint64_t max_len) {
+  uint64_t start = offset - (offset % src->granularity);
+  uint64_t len = src->file_bytes - start;
+  if (len > max_len) len = max_len;
+
+  iq_source_unmap(src);
+
+#ifdef _WIN32
+  void* p = MapViewOfFile((HANDLE)src->mapping, FILE_MAP_READ,
+                          (DWORD)(start >> 32), (DWORD)(start & 0xFFFFFFFFu),
+                          (SIZE_T)len);
+  if (!p) {
+    fprintf(stderr, "[IQ] MapViewOfFile failed with error: %lu\n",
+            GetLastError());
+    return -1;
+  }
+#else
+  void* p = mmap(NULL, (size_t)len, PROT_READ, MAP_SHARED, src->fd,
+                 (off_t)start);
+  if (p == MAP_FAILED) {
+    perror("[IQ] mmap failed");
+    return -1;
+  }
+  /* Capture is consumed front to back exactly once per pass */
+  madvise(p, (size_t)len, MADV_SEQUENTIAL);
+#endif
+
+  src->win = (const unsigned char*)p;
+  src->win_offset = start;
+  src->win_len = (size_t)len;
+  return 0;
+}
+
+/* *****************************************************************************
+ *
+ *                         READ-AHEAD THREAD
+ *
+ * *****************************************************************************/
+
+#define IQ_READER_MAX_BUFS 16
+
+#define SLOT_FREE 0 /* Reader may fill the slot            */
+#define SLOT_FULL 1 /* Slot holds data for the consumer    */
+
+typedef struct IqReader {
+  unsigned char* buf[IQ_READER_MAX_BUFS]; /* Aligned ring buffers        */
+  size_t len[IQ_READER_MAX_BUFS];         /* Bytes held by each slot     */
+  int state[IQ_READER_MAX_BUFS];          /* SLOT_FREE / SLOT_FULL       */
+  size_t nbufs;                           /* Slots in the ring           */
+  size_t buf_bytes;                       /* Capacity of each slot       */
+
+  uint64_t read_off; /* Next file offset the thread reads       */
+  uint64_t end_off;  /* End of the last complete sample         */
+  size_t head;       /* Next slot the thread fills              */
+  size_t tail;       /* Slot the consumer reads                 */
+  size_t tail_pos;   /* Bytes of the tail slot handed out       */
+  int holding;       /* Consumer holds the tail slot            */
+  int running;       /* Thread started                          */
+  int stop;          /* Thread asked to exit                    */
+  int eof;           /* Thread read everything (or failed)      */
+  int error;         /* Thread stopped on a failed read         */
+
+  IqSource* src;
+#ifdef _WIN32
+  HANDLE thread;
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE cond;
+#else
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+#endif
+} IqReader;
+
+#ifdef _WIN32
+#define READER_LOCK(r) EnterCriticalSection(&(r)->lock)
+#define READER_UNLOCK(r) LeaveCriticalSection(&(r)->lock)
+#define READER_WAIT(r) SleepConditionVariableCS(&(r)->cond, &(r)->lock, INFINITE)
+#define READER_SIGNAL(r) WakeAllConditionVariable(&(r)->cond)
+#else
+#define READER_LOCK(r) pthread_mutex_lock(&(r)->lock)
+#define READER_UNLOCK(r) pthread_mutex_unlock(&(r)->lock)
+#define READER_WAIT(r) pthread_cond_wait(&(r)->cond, &(r)->lock)
+#define READER_SIGNAL(r) pthread_cond_broadcast(&(r)->cond)
+#endif
+
+/**
+ * Read len bytes at a file offset, retrying short and interrupted reads
+ *
+ * @param got  Output: bytes read (less than len only at end of file or on
+ *             error)
+ * @return 0 on success or end of file, -1 on a read error
+ */
+static int iq_source_pread(IqSource* src, unsigned char* dst, size_t len,
+                           uint64_t offset, size_t* got) {
+  size_t done = 0;
+  int rc = 0;
+  while (done < len) {
+#ifdef _WIN32
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+    ov.Offset = (DWORD)((offset + done) & 0xFFFFFFFFu);
+    ov.OffsetHigh = (DWORD)((offset + done) >> 32);
+    DWORD chunk = (DWORD)((len - done) > 0x40000000u ? 0x40000000u
+                                                      : (len - done));
+    DWORD n = 0;
+    if (!ReadFile((HANDLE)src->file, dst + done, chunk, &n, &ov)) {
+      if (GetLastError() != ERROR_HANDLE_EOF) rc = -1;
+      break;
+    }
+    if (n == 0) break;
+#else
+    ssize_t n = pread(src->fd, dst + done, len - done,
+                      (off_t)(offset + done));
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) rc = -1;
+    if (n <= 0) break;
+#endif
+    done += (size_t)n;
+  }
+  *got = done;
+  return rc;
+}
+
+/**
+ * Reader thread: fill free slots in order until end of file
+ */
+#ifdef _WIN32
+static DWORD WINAPI iq_reader_main(LPVOID arg) {
+#else
+static void* iq_reader_main(void* arg) {
+#endif
+  IqReader* r = (IqReader*)arg;
+
+  READER_LOCK(r);
+  while (!r->stop) {
+    if (r->read_off >= r->end_off) break;
+    if (r->state[r->head] != SLOT_FREE) {
+      READER_WAIT(r);
+      continue;
+    }
+
+    size_t slot = r->head;
+    uint64_t off = r->read_off;
+    uint64_t left = r->end_off - off;
+    size_t want = left < r->buf_bytes ? (size_t)left : r->buf_bytes;
+    READER_UNLOCK(r);
+
+    size_t got;
+    int rc = iq_source_pread(r->src, r->buf[slot], want, off, &got);
+#ifdef _WIN32
+    unsigned long err = rc != 0 ? (unsigned long)GetLastError() : 0;
+#else
+    int err = errno;
+#endif
+    /* Keep whole samples only */
+    got -= got % r->src->sample_bytes;
+
+    READER_LOCK(r);
+    if (rc != 0 || got == 0) {
+      /* An error, or the file shrank below its size at open */
+#ifdef _WIN32
+      fprintf(stderr, "[IQ] Read failed at offset %llu (error %lu)\n",
+              (unsigned long long)(off + got), err);
+#else
+      fprintf(stderr, "[IQ] Read failed at offset %llu: %s\n",
+              (unsigned long long)(off + got),
+              rc != 0 ? strerror(err) : "file truncated");
+#endif
+      r->error = 1;
+      if (got == 0) break;
+    }
+    r->len[slot] = got;
+    r->state[slot] = SLOT_FULL;
+    r->head = (r->head + 1) % r->nbufs;
+    r->read_off += got;
+    READER_SIGNAL(r);
+    if (r->error) break;
+  }
+  r->eof = 1;
+  READER_SIGNAL(r);
+  READER_UNLOCK(r);
+
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+/**
+ * Start the reader thread at the current source position
+ * @return 0 on success, -1 on error
+ */
+static int iq_reader_start(IqReader* r) {
+  for (size_t i = 0; i < r->nbufs; i++) {
+    r->state[i] = SLOT_FREE;
+    r->len[i] = 0;
+  }
+  IqSource* src = r->src;
+  r->read_off = (src->first + src->pos) * src->sample_bytes;
+  r->end_off = (src->first + src->n_samples) * src->sample_bytes;
+  r->head = r->tail = r->tail_pos = 0;
+  r->holding = 0;
+  r->stop = 0;
+  r->eof = 0;
+  r->error = 0;
+
+#ifdef _WIN32
+  r->thread = CreateThread(NULL, 0, iq_reader_main, r, 0, NULL);
+  if (!r->thread) return -1;
+#else
+  if (pthread_create(&r->thread, NULL, iq_reader_main, r) != 0) return -1;
+#endif
+  r->running = 1;
+  return 0;
+}
+
+/**
+ * Stop the reader thread and wait for it to exit
+ */
+static void iq_reader_stop(IqReader* r) {
+  if (!r->running) return;
+  READER_LOCK(r);
+  r->stop = 1;
+  READER_SIGNAL(r);
+  READER_UNLOCK(r);
+#ifdef _WIN32
+  WaitForSingleObject(r->thread, INFINITE);
+  CloseHandle(r->thread);
+#else
+  pthread_join(r->thread, NULL);
+#endif
+  r->running = 0;
+}
+
+/**
+ * Hand out the next block from the read-ahead ring
+ */
+static size_t iq_reader_next(IqSource* src, size_t max_samples,
+                             const void** raw) {
+  IqReader* r = src->reader;
+
+  if (!r->running) {
+    if (src->pos >= src->n_samples) return 0;
+    if (iq_reader_start(r) != 0) {
+      fprintf(stderr, "[IQ] Cannot start read-ahead thread\n");
+      src->error = 1;
+      return 0;
+    }
+  }
+
+  /* Give the finished slot back to the reader */
+  if (r->holding && r->tail_pos >= r->len[r->tail]) {
+    READER_LOCK(r);
+    r->state[r->tail] = SLOT_FREE;
+    r->tail = (r->tail + 1) % r->nbufs;
+    r->holding = 0;
+    READER_SIGNAL(r);
+    READER_UNLOCK(r);
+  }
+
+  if (!r->holding) {
+    READER_LOCK(r);
+    while (r->state[r->tail] != SLOT_FULL && !r->eof) READER_WAIT(r);
+    int ready = r->state[r->tail] == SLOT_FULL;
+    if (!ready && r->error) src->error = 1;
+    READER_UNLOCK(r);
+    if (!ready) return 0;
+    r->holding = 1;
+    r->tail_pos = 0;
+  }
+
+  size_t avail = (r->len[r->tail] - r->tail_pos) / src->sample_bytes;
+  size_t count = max_samples < avail ? max_samples : avail;
+
+  *raw = r->buf[r->tail] + r->tail_pos;
+  r->tail_pos += count * src->sample_bytes;
+  src->pos += count;
+  return count;
+}
+
+/**
+ * Allocate one aligned ring buffer
+ */
+static unsigned char* iq_reader_alloc(size_t bytes) {
+#ifdef _WIN32
+  return (unsigned char*)_aligned_malloc(bytes, IQ_SOURCE_READAHEAD_ALIGN);
+#else
+  void* p = NULL;
+  if (posix_memalign(&p, IQ_SOURCE_READAHEAD_ALIGN, bytes) != 0) return NULL;
+  return (unsigned char*)p;
+#endif
+}
+
+/**
+ * Stop the thread and release the ring
+ */
+static void iq_reader_free(IqReader* r) {
+  iq_reader_stop(r);
+  for (size_t i = 0; i < r->nbufs; i++) {
+#ifdef _WIN32
+    _aligned_free(r->buf[i]);
+#else
+    free(r->buf[i]);
+#endif
+  }
+#ifdef _WIN32
+  DeleteCriticalSection(&r->lock);
+#else
+  pthread_mutex_destroy(&r->lock);
+  pthread_cond_destroy(&r->cond);
+#endif
+  free(r);
+}
+
+/* *****************************************************************************
+ *
+ *                         FILE SEQUENCE
+ *
+ * *****************************************************************************/
+
+typedef struct IqSequence {
+  IqSource* files; /* One source per file, in order              */
+  char** paths;    /* File paths                                 */
+  size_t nfiles;   /* Files in the sequence                      */
+  size_t cur;      /* File being read                            */
+  int entered;     /* Resources of the current file are set up   */
+
+  size_t ra_bufs;  /* Read-ahead ring per file (0 = mapped)      */
+  size_t ra_bytes; /* Bytes per read-ahead buffer                */
+
+  unsigned char* bounce; /* Block stitched across a file boundary */
+  size_t bounce_cap;     /* Bounce buffer capacity in bytes        */
+} IqSequence;
+
+/**
+ * Start reading a file ahead of time
+ *
+ * With read-ahead its reader thread is started now, so its ring is full
+ * when the previous file ends. Mapped reads ask the kernel to load the
+ * first window instead.
+ */
+static void iq_seq_prefetch(IqSequence* s, size_t k) {
+  if (k >= s->nfiles) return;
+  IqSource* f = &s->files[k];
+  if (f->n_samples == 0) return;
+
+  if (s->ra_bufs) {
+    if (!f->reader && iq_source_readahead(f, s->ra_bufs, s->ra_bytes) != 0) {
+      return;
+    }
+    if (!f->reader->running) iq_reader_start(f->reader);
+    return;
+  }
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+  posix_fadvise(f->fd, (off_t)(f->first * f->sample_bytes),
+                (off_t)IQ_SOURCE_WINDOW_BYTES, POSIX_FADV_WILLNEED);
+#endif
+}
+
+/**
+ * Make file k the current file and prefetch the one after it
+ */
+static void iq_seq_enter(IqSequence* s, size_t k) {
+  s->cur = k;
+  s->entered = 1;
+  iq_seq_prefetch(s, k);
+  iq_seq_prefetch(s, k + 1);
+}
+
+/**
+ * Release the read-ahead ring and window of a finished file
+ */
+static void iq_seq_leave(IqSequence* s, size_t k) {
+  IqSource* f = &s->files[k];
+  if (f->reader) iq_reader_free(f->reader);
+  f->reader = NULL;
+  iq_source_unmap(f);
+}
+
+/**
+ * Next block of the current file, moving on to later files at their end
+ */
+static size_t iq_seq_pull(IqSequence* s, size_t max_samples,
+                          const void** raw) {
+  if (!s->entered) iq_seq_enter(s, s->cur);
+  while (s->cur < s->nfiles) {
+    size_t got = iq_source_next(&s->files[s->cur], max_samples, raw);
+    if (got > 0) return got;
+    if (s->files[s->cur].error) break; /* Later files would leave a gap */
+    iq_seq_leave(s, s->cur);
+    if (s->cur + 1 == s->nfiles) break;
+    iq_seq_enter(s, s->cur + 1);
+  }
+  return 0;
+}
+
+/**
+ * Hand out the next block of a sequence
+ *
+ * A block cut short by the end of a file is completed from the following
+ * files in a bounce buffer, so the consumer sees the same blocks as for
+ * one concatenated file.
+ */
+static size_t iq_seq_next(IqSource* src, size_t max_samples,
+                          const void** raw) {
+  IqSequence* s = src->seq;
+  uint64_t left = src->n_samples - src->pos;
+  if ((uint64_t)max_samples > left) max_samples = (size_t)left;
+
+  size_t got = iq_seq_pull(s, max_samples, raw);
+  if (got == 0 || got == max_samples || s->cur >= s->nfiles) {
+    src->pos += got;
+    return got;
+  }
+  IqSource* f = &s->files[s->cur];
+  if (f->pos < f->n_samples || s->cur + 1 == s->nfiles) {
+    /* Short for another reason (window or buffer edge) */
+    src->pos += got;
+    return got;
+  }
+
+  size_t sb = src->sample_bytes;
+  if (max_samples * sb > s->bounce_cap) {
+    unsigned char* b = (unsigned char*)realloc(s->bounce, max_samples * sb);
+    if (!b) {
+      src->pos += got;
+      return got;
+    }
+    s->bounce = b;
+    s->bounce_cap = max_samples * sb;
+  }
+
+  memcpy(s->bounce, *raw, got * sb);
+  size_t have = got;
+  while (have < max_samples) {
+    const void* part;
+    size_t n = iq_seq_pull(s, max_samples - have, &part);
+    if (n == 0) break;
+    memcpy(s->bounce + have * sb, part, n * sb);
+    have += n;
+  }
+
+  *raw = s->bounce;
+  src->pos += have;
+  return have;
+}
+
+/**
+ * Stop all threads of a sequence and go back to its first file
+ */
+static void iq_seq_rewind(IqSequence* s) {
+  for (size_t k = 0; k < s->nfiles; k++) {
+    iq_seq_leave(s, k);
+    iq_source_rewind(&s->files[k]);
+  }
+  s->cur = 0;
+  s->entered = 0;
+}
+
+/**
+ * Restrict every file of a sequence to its share of a range
+ */
+static void iq_seq_set_range(IqSequence* s, uint64_t first, uint64_t count) {
+  uint64_t base = 0;
+  for (size_t k = 0; k < s->nfiles; k++) {
+    IqSource* f = &s->files[k];
+    uint64_t total = f->file_bytes / f->sample_bytes;
+    uint64_t lo = first > base ? first : base;
+    uint64_t hi = first + count < base + total ? first + count : base + total;
+
+    if (lo < hi) {
+      iq_source_set_range(f, lo - base, hi - lo);
+    } else {
+      iq_source_rewind(f);
+      f->first = 0;
+      f->n_samples = 0;
+    }
+    base += total;
+  }
+}
+
+/**
+ * Close every file of a sequence and free it
+ */
+static void iq_seq_free(IqSequence* s) {
+  for (size_t k = 0; k < s->nfiles; k++) {
+    if (s->files) iq_source_close(&s->files[k]);
+    free(s->paths[k]);
+  }
+  free(s->files);
+  free(s->paths);
+  free(s->bounce);
+  free(s);
+}
+
+/* *****************************************************************************
+ *
+ *                         FILE NAME EXPANSION
+ *
+ * *****************************************************************************/
+
+/**
+ * Append a copy of a path to a growing list
+ * @return 0 on success, -1 on allocation failure
+ */
+static int path_list_add(char*** list, size_t* n, size_t* cap,
+                         const char* path, size_t len) {
+  if (*n == *cap) {
+    size_t ncap = *cap ? *cap * 2 : 8;
+    char** l = (char**)realloc(*list, ncap * sizeof(char*));
+    if (!l) return -1;
+    *list = l;
+    *cap = ncap;
+  }
+  char* p = (char*)malloc(len + 1);
+  if (!p) return -1;
+  memcpy(p, path, len);
+  p[len] = '\0';
+  (*list)[(*n)++] = p;
+  return 0;
+}
+
+#ifdef _WIN32
+static int path_compare(const void* a, const void* b) {
+  return strcmp(*(char* const*)a, *(char* const*)b);
+}
+#endif
+
+/**
+ * Check whether a name is an existing file (not a directory)
+ * @return 1 if it exists, 0 otherwise
+ */
+static int path_is_file(const char* path) {
+#ifdef _WIN32
+  DWORD attr = GetFileAttributesA(path);
+  return attr != INVALID_FILE_ATTRIBUTES &&
+         !(attr & FILE_ATTRIBUTE_DIRECTORY);
+#else
+  struct stat st;
+  return stat(path, &st) == 0 && !S_ISDIR(st.st_mode);
+#endif
+}
+
+/**
+ * Expand one glob pattern into the list, in name order
+ * @return Number of matches added, -1 on error
+ */
+static int path_list_glob(char*** list, size_t* n, size_t* cap,
+                          const char* pattern) {
+  size_t start = *n;
+#ifdef _WIN32
+  /* FindFirstFile returns bare names: keep the directory of the pattern */
+  const char* slash = strrchr(pattern, '\\');
+  const char* fwd = strrchr(pattern, '/');
+  if (!slash || (fwd && fwd > slash)) slash = fwd;
+  size_t dir_len = slash ? (size_t)(slash - pattern) + 1 : 0;
+
+  WIN32_FIND_DATAA fd;
+  HANDLE h = FindFirstFileA(pattern, &fd);
+  if (h == INVALID_HANDLE_VALUE) return 0;
+  do {
+    if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+    char full[MAX_PATH * 2];
+    snprintf(full, sizeof(full), "%.*s%s", (int)dir_len, pattern, fd.cFileName);
+    if (path_list_add(list, n, cap, full, strlen(full)) != 0) {
+      FindClose(h);
+      return -1;
+    }
+  } while (FindNextFileA(h, &fd));
+  FindClose(h);
+  qsort(*list + start, *n - start, sizeof(char*), path_compare);
+#else
+  glob_t g;
+  int rc = glob(pattern, 0, NULL, &g); /* Sorted by name */
+  if (rc == GLOB_NOMATCH) return 0;
+  if (rc != 0) return -1;
+  for (size_t i = 0; i < g.gl_pathc; i++) {
+    if (path_list_add(list, n, cap, g.gl_pathv[i], strlen(g.gl_pathv[i])) !=
+        0) {
+      globfree(&g);
+      return -1;
+    }
+  }
+  globfree(&g);
+#endif
+  return (int)(*n - start);
+}
+
+/**
+ * Expand a comma separated list of paths and patterns
+ *
+ * Names of existing files are taken as they are: the whole specification
+ * first (so "rec,1.c16" or "rec[1].c16" open that file), then each list
+ * item. Only names that do not exist are split on ',' or globbed.
+ *
+ * @return 0 on success, -1 on error (list freed)
+ */
+static int path_list_expand(const char* spec, char*** list, size_t* n) {
+  size_t cap = 0;
+  *list = NULL;
+  *n = 0;
+
+  if (path_is_file(spec)) {
+    if (path_list_add(list, n, &cap, spec, strlen(spec)) != 0) {
+      free(*list);
+      *list = NULL;
+      *n = 0;
+      return -1;
+    }
+    return 0;
+  }
+
+  const char* p = spec;
+  for (;;) {
+    const char* comma = strchr(p, ',');
+    size_t len = comma ? (size_t)(comma - p) : strlen(p);
+    int rc = 0;
+
+    char* item = (char*)malloc(len + 1);
+    if (!item) {
+      rc = -1;
+    } else if (len > 0) {
+      memcpy(item, p, len);
+      item[len] = '\0';
+      if (strcspn(item, "*?[") < len && !path_is_file(item)) {
+        rc = path_list_glob(list, n, &cap, item);
+        if (rc == 0) {
+          fprintf(stderr, "[IQ] No files match: %s\n", item);
+          rc = -1;
+        }
+      } else {
+        rc = path_list_add(list, n, &cap, item, len);
+      }
+    }
+    free(item);
+
+    if (rc < 0) {
+      for (size_t k = 0; k < *n; k++) free((*list)[k]);
+      free(*list);
+      *list = NULL;
+      *n = 0;
+      return -1;
+    }
+    if (!comma) break;
+    p = comma + 1;
+  }
+  return *n > 0 ? 0 : -1;
+}
+
+/* *****************************************************************************
+ *
+ *                         PUBLIC API
+ *
+ * *****************************************************************************/
+
+int iq_source_open(IqSource* src, const char* path, size_t sample_bytes) {
+  memset(src, 0, sizeof(*src));
+  src->sample_bytes = sample_bytes;
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE) return -1;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    return -1;
+  }
+  src->file = file;
+  src->file_bytes = (uint64_t)size.QuadPart;
+
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  src->granularity = si.dwAllocationGranularity;
+
+  if (src->file_bytes > 0) {
+    src->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!src->mapping) {
+      CloseHandle(file);
+      return -1;
+    }
+  }
+#else
+  src->fd = open(path, O_RDONLY);
+  if (src->fd < 0) return -1;
+
+  struct stat st;
+  if (fstat(src->fd, &st) != 0) {
+    close(src->fd);
+    return -1;
+  }
+  src->file_bytes = (uint64_t)st.st_size;
+  src->granularity = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+
+  src->n_samples = src->file_bytes / sample_bytes;
+  return 0;
+}
+
+int iq_source_open_files(IqSource* src, const char* spec,
+                         size_t sample_bytes) {
+  char** paths;
+  size_t n;
+  if (path_list_expand(spec, &paths, &n) != 0) {
+    memset(src, 0, sizeof(*src));
+#ifndef _WIN32
+    src->fd = -1;
+#endif
+    return -1;
+  }
+
+  if (n == 1) {
+    int rc = iq_source_open(src, paths[0], sample_bytes);
+    free(paths[0]);
+    free(paths);
+    return rc;
+  }
+
+  memset(src, 0, sizeof(*src));
+  src->sample_bytes = sample_bytes;
+#ifndef _WIN32
+  src->fd = -1;
+#endif
+
+  IqSequence* s = (IqSequence*)calloc(1, sizeof(IqSequence));
+  IqSource* files = (IqSource*)calloc(n, sizeof(IqSource));
+  if (!s || !files) {
+    for (size_t k = 0; k < n; k++) free(paths[k]);
+    free(paths);
+    free(files);
+    free(s);
+    return -1;
+  }
+  s->paths = paths;
+  s->nfiles = n;
+
+  for (size_t k = 0; k < n; k++) {
+    if (iq_source_open(&files[k], paths[k], sample_bytes) != 0) {
+      fprintf(stderr, "[IQ] Cannot open sequence file: %s\n", paths[k]);
+      for (size_t j = 0; j < k; j++) iq_source_close(&files[j]);
+      free(files);
+      s->files = NULL;
+      iq_seq_free(s);
+      return -1;
+    }
+    src->file_bytes += files[k].file_bytes;
+    src->n_samples += files[k].n_samples;
+  }
+  s->files = files;
+  src->seq = s;
+  return 0;
+}
+
+size_t iq_source_file_info(const IqSource* src, size_t index,
+                           const char** path, uint64_t* n_samples) {
+  if (!src->seq) {
+    if (path) *path = NULL;
+    if (n_samples) *n_samples = src->file_bytes / src->sample_bytes;
+    return 1;
+  }
+  if (index < src->seq->nfiles) {
+    const IqSource* f = &src->seq->files[index];
+    if (path) *path = src->seq->paths[index];
+    if (n_samples) *n_samples = f->file_bytes / f->sample_bytes;
+  }
+  return src->seq->nfiles;
+}
+
+int iq_source_open_live(IqSource* src, const char* name, size_t sample_bytes) {
+  memset(src, 0, sizeof(*src));
+  src->sample_bytes = sample_bytes;
+#ifndef _WIN32
+  src->fd = -1;
+#endif
+
+  src->live = iq_live_open(name, sample_bytes, IQ_LIVE_RING_BYTES);
+  if (!src->live) return -1;
+  src->n_samples = UINT64_MAX;
+  return 0;
+}
+
+int iq_source_readahead(IqSource* src, size_t nbufs, size_t buf_bytes) {
+  if (src->live) return -1;
+  if (src->seq) {
+    /* Each file gets its own ring while it is current or next */
+    src->seq->ra_bufs = nbufs;
+    src->seq->ra_bytes = buf_bytes;
+    if (src->seq->entered) iq_seq_enter(src->seq, src->seq->cur);
+    return 0;
+  }
+  if (src->reader) return 0;
+  if (nbufs < 2) nbufs = 2;
+  if (nbufs > IQ_READER_MAX_BUFS) nbufs = IQ_READER_MAX_BUFS;
+  buf_bytes -= buf_bytes % src->sample_bytes;
+  if (buf_bytes == 0) return -1;
+
+  IqReader* r = (IqReader*)calloc(1, sizeof(IqReader));
+  if (!r) return -1;
+  r->src = src;
+  r->nbufs = nbufs;
+  r->buf_bytes = buf_bytes;
+#ifdef _WIN32
+  InitializeCriticalSection(&r->lock);
+  InitializeConditionVariable(&r->cond);
+#else
+  pthread_mutex_init(&r->lock, NULL);
+  pthread_cond_init(&r->cond, NULL);
+#endif
+
+  for (size_t i = 0; i < nbufs; i++) {
+    r->buf[i] = iq_reader_alloc(buf_bytes);
+    if (!r->buf[i]) {
+      iq_reader_free(r);
+      return -1;
+    }
+  }
+
+#if !defined(_WIN32) && defined(POSIX_FADV_SEQUENTIAL)
+  posix_fadvise(src->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  src->reader = r;
+  return 0;
+}
+
+size_t iq_source_next(IqSource* src, size_t max_samples, const void** raw) {
+  if (max_samples == 0) return 0;
+  if (src->pos >= src->n_samples) return 0;
+  if (src->live) {
+    uint64_t left = src->n_samples - src->pos;
+    if ((uint64_t)max_samples > left) max_samples = (size_t)left;
+    size_t count = iq_live_next(src->live, max_samples, raw);
+    src->pos += count;
+    return count;
+  }
+  if (src->seq) return iq_seq_next(src, max_samples, raw);
+  if (src->reader) return iq_reader_next(src, max_samples, raw);
+
+  uint64_t byte_pos = (src->first + src->pos) * src->sample_bytes;
+
+  /* Remap when the next sample is not entirely inside the window */
+  if (!src->win || byte_pos < src->win_offset ||
+      byte_pos + src->sample_bytes > src->win_offset + src->win_len) {
+    if (iq_source_map(src, byte_pos, IQ_SOURCE_WINDOW_BYTES) != 0) {
+      src->error = 1;
+      return 0;
+    }
+  }
+
+  size_t in_win = (size_t)((src->win_offset + src->win_len - byte_pos) /
+                           src->sample_bytes);
+  uint64_t left = src->n_samples - src->pos;
+  size_t count = max_samples;
+  if (count > in_win) count = in_win;
+  if ((uint64_t)count > left) count = (size_t)left;
+
+  *raw = src->win + (size_t)(byte_pos - src->win_offset);
+  src->pos += count;
+  return count;
+}
+
+int iq_source_set_range(IqSource* src, uint64_t first, uint64_t count) {
+  if (src->live) {
+    /* A stream cannot seek: drop everything before the range */
+    const void* raw;
+    for (uint64_t left = first; left > 0;) {
+      size_t want = left < IQ_LIVE_UDP_MAX_PAYLOAD ? (size_t)left
+                                                   : IQ_LIVE_UDP_MAX_PAYLOAD;
+      size_t got = iq_live_next(src->live, want, &raw);
+      if (got == 0) return -1;
+      left -= got;
+    }
+    src->first = first;
+    src->n_samples = count ? count : UINT64_MAX;
+    return 0;
+  }
+
+  uint64_t total = src->file_bytes / src->sample_bytes;
+  if (src->seq) {
+    total = 0;
+    for (size_t k = 0; k < src->seq->nfiles; k++) {
+      total += src->seq->files[k].file_bytes / src->sample_bytes;
+    }
+  }
+  if (first >= total) return -1;
+  if (count == 0 || count > total - first) count = total - first;
+
+  iq_source_rewind(src);
+  if (src->seq) iq_seq_set_range(src->seq, first, count);
+  src->first = first;
+  src->n_samples = count;
+  return 0;
+}
+
+const void* iq_source_map_all(IqSource* src) {
+  if (src->live || src->seq) return NULL;
+  uint64_t off = src->first * src->sample_bytes;
+  uint64_t bytes = src->n_samples * src->sample_bytes;
+  uint64_t lead = off % src->granularity;
+  if (bytes == 0 || bytes + lead > (uint64_t)(size_t)-1) return NULL;
+  if (iq_source_map(src, off, bytes + lead) != 0) return NULL;
+  src->pos = 0;
+  return src->win + lead;
+}
+
+int iq_source_error(const IqSource* src) {
+  if (src->error) return 1;
+  if (src->live) return 0;
+  if (src->seq) {
+    for (size_t k = 0; k < src->seq->nfiles; k++) {
+      if (src->seq->files && src->seq->files[k].error) return 1;
+    }
+  }
+  return 0;
+}
+
+void iq_source_rewind(IqSource* src) {
+  if (src->live) return; /* Streams cannot be replayed */
+  if (src->seq) iq_seq_rewind(src->seq);
+  if (src->reader) iq_reader_stop(src->reader);
+  iq_source_unmap(src);
+  src->pos = 0;
+  src->error = 0;
+}
+
+void iq_source_close(IqSource* src) {
+  if (src->reader) iq_reader_free(src->reader);
+  src->reader = NULL;
+  iq_live_close(src->live);
+  src->live = NULL;
+  if (src->seq) iq_seq_free(src->seq);
+  src->seq = NULL;
+  iq_source_unmap(src);
+#ifdef _WIN32
+  if (src->mapping) CloseHandle((HANDLE)src->mapping);
+  if (src->file) CloseHandle((HANDLE)src->file);
+  src->mapping = NULL;
+  src->file = NULL;
+#else
+  if (src->fd >= 0) close(src->fd);
+  src->fd = -1;
+#endif
+}
@@ -0,0 +1,220 @@
+/*
+ * iq_source.h
+ *
+ *  Memory-mapped IQ capture reader.
+ *
+ *  Maps the capture file in sliding windows and hands out blocks of raw
+ *  interleaved I/Q samples straight from the mapped pages, so callers can
+ *  convert into their own working buffers without an intermediate copy.
+ *
+ *  Optionally a read-ahead thread fills a ring of large aligned buffers
+ *  with pread() ahead of the consumer instead, so disk reads overlap with
+ *  the DSP working on earlier blocks.
+ *
+ *  Live sources (stdin, named pipe, UDP) hand out blocks from the lock-free
+ *  ring of an iq_live receiver through the same interface.
+ *
+ *  A sequence of capture files (e.g. a recorder rotating files) can be
+ *  opened as one continuous source; the next file is prefetched while the
+ *  current one is being processed.
+ */
+
+#ifndef IQ_SOURCE_H_
+#define IQ_SOURCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "iq_live.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* =============================================================================
+ * MAPPING PARAMETERS
+ * =============================================================================
+ */
+#define IQ_SOURCE_WINDOW_BYTES (64u << 20) /* Bytes mapped per window    */
+
+/* =============================================================================
+ * READ-AHEAD PARAMETERS
+ * =============================================================================
+ */
+#define IQ_SOURCE_READAHEAD_BUFS 4             /* Buffers in the ring     */
+#define IQ_SOURCE_READAHEAD_BYTES (8u << 20)   /* Bytes per buffer        */
+#define IQ_SOURCE_READAHEAD_ALIGN 4096         /* Buffer alignment        */
+
+/* =============================================================================
+ * IQ SOURCE
+ * -----------------------------------------------------------------------------
+ * Sequential reader over a read-only file mapping. Only one window of the
+ * file is mapped at a time; pages behind the read position are unmapped as
+ * the reader advances, which keeps resident memory bounded by the window.
+ * =============================================================================
+ */
+struct IqReader;   /* Read-ahead state (private to iq_source.c)    */
+struct IqSequence; /* File sequence state (private to iq_source.c) */
+
+typedef struct IqSource {
+  uint64_t file_bytes;      /* File size in bytes                     */
+  uint64_t n_samples;       /* I/Q samples in the selected range      */
+  uint64_t first;           /* File sample index of the range start   */
+  uint64_t pos;             /* Next range sample to hand out          */
+  size_t sample_bytes;      /* Bytes per complex sample (I + Q)       */
+
+  const unsigned char* win; /* Current mapped window                  */
+  uint64_t win_offset;      /* File offset of the window              */
+  size_t win_len;           /* Window length in bytes                 */
+  size_t granularity;       /* Mapping offset alignment               */
+
+  struct IqReader* reader;  /* Read-ahead thread (NULL = mapped)     */
+  struct IqLive* live;      /* Live receiver (NULL = file)           */
+  struct IqSequence* seq;   /* File sequence (NULL = one file)       */
+  int error;                /* A read failed (stream cut short)      */
+
+#ifdef _WIN32
+  void* file;    /* HANDLE of the open file                */
+  void* mapping; /* HANDLE of the file mapping object      */
+#else
+  int fd; /* File descriptor                        */
+#endif
+} IqSource;
+
+/**
+ * Open an IQ capture for mapped sequential reading
+ *
+ * @param src           Source to initialize
+ * @param path          Capture file path
+ * @param sample_bytes  Bytes per complex sample (e.g. 4 for IQ16)
+ * @return 0 on success, -1 on error
+ */
+int iq_source_open(IqSource* src, const char* path, size_t sample_bytes);
+
+/**
+ * Open one capture file or a sequence of files read as one stream
+ *
+ * The specification is a path, a glob pattern ("cap_*.c16", matches in
+ * name order) or a comma separated list of paths and patterns. Files are
+ * concatenated in order; a block that crosses a file boundary is handed
+ * out in one piece. A specification that names an existing file opens that
+ * file, even if it contains ',' or glob characters; the same holds for
+ * each list item.
+ *
+ * @param src           Source to initialize
+ * @param spec          Path, pattern or comma separated list
+ * @param sample_bytes  Bytes per complex sample (e.g. 4 for IQ16)
+ * @return 0 on success, -1 on error
+ */
+int iq_source_open_files(IqSource* src, const char* spec, size_t sample_bytes);
+
+/**
+ * Describe one file of an open source
+ *
+ * @param src        Open source
+ * @param index      File index (0 for a single file)
+ * @param path       Output: file path (NULL for a single file)
+ * @param n_samples  Output: complete samples in the file
+ * @return Number of files in the source
+ */
+size_t iq_source_file_info(const IqSource* src, size_t index,
+                           const char** path, uint64_t* n_samples);
+
+/**
+ * Open a live IQ stream (stdin, named pipe or UDP)
+ *
+ * The stream length is unknown: n_samples is UINT64_MAX until a range
+ * limits it, and iq_source_next() waits for data until the stream ends.
+ * Mapping, read-ahead and rewinding are not available.
+ *
+ * @param src           Source to initialize
+ * @param name          "-", "udp:[host:]port" or a named pipe path
+ * @param sample_bytes  Bytes per complex sample (e.g. 4 for IQ16)
+ * @return 0 on success, -1 on error
+ */
+int iq_source_open_live(IqSource* src, const char* name, size_t sample_bytes);
+
+/**
+ * Restrict reading to a range of samples
+ *
+ * Seeks straight to the first sample; nothing before it is read. Must be
+ * called before the first iq_source_next(). A live source discards the
+ * samples before the range as they arrive.
+ *
+ * @param src    Open source
+ * @param first  Index of the first sample in the file
+ * @param count  Number of samples (0 or past the end = up to end of file)
+ * @return 0 on success, -1 if first is beyond the end of the file
+ */
+int iq_source_set_range(IqSource* src, uint64_t first, uint64_t count);
+
+/**
+ * Switch an open source to threaded read-ahead
+ *
+ * A reader thread is started on the first iq_source_next() call and keeps
+ * up to nbufs buffers of buf_bytes filled ahead of the consumer. Blocks
+ * handed out never span two buffers, so they may be shorter than asked.
+ *
+ * @param src        Open source
+ * @param nbufs      Number of ring buffers (at least 2)
+ * @param buf_bytes  Bytes per buffer (rounded down to whole samples)
+ * @return 0 on success, -1 on error (source stays in mapped mode)
+ */
+int iq_source_readahead(IqSource* src, size_t nbufs, size_t buf_bytes);
+
+/**
+ * Get the next block of raw samples
+ *
+ * The returned pointer refers to mapped file pages (or to a read-ahead
+ * buffer) and stays valid until the next call to iq_source_next(),
+ * iq_source_rewind() or iq_source_close().
+ *
+ * @param src          Open source
+ * @param max_samples  Maximum samples to return
+ * @param raw          Output: pointer to interleaved raw samples
+ * @return Number of samples in the block, 0 at end of file or after a
+ *         read error (see iq_source_error())
+ */
+size_t iq_source_next(IqSource* src, size_t max_samples, const void** raw);
+
+/**
+ * Check whether reading stopped on an error rather than at the end
+ *
+ * A failed read (or a file that shrank while open) ends the stream early;
+ * callers should test this once iq_source_next() returns 0.
+ *
+ * @param src  Open source
+ * @return 1 if a read failed, 0 otherwise
+ */
+int iq_source_error(const IqSource* src);
+
+/**
+ * Map the whole capture (or selected range) as one contiguous view
+ *
+ * Lets callers use the file contents in place (e.g. a cf32 capture as an
+ * array of complex floats). The view stays valid until the next call to
+ * iq_source_next(), iq_source_rewind() or iq_source_close().
+ *
+ * @param src  Open source
+ * @return Pointer to the first sample, NULL if the file cannot be mapped
+ *         in one piece (e.g. larger than the address space)
+ */
+const void* iq_source_map_all(IqSource* src);
+
+/**
+ * Restart reading from the first sample
+ * @param src  Open source
+ */
+void iq_source_rewind(IqSource* src);
+
+/**
+ * Unmap and close the source
+ * @param src  Source to close
+ */
+void iq_source_close(IqSource* src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQ_SOURCE_H_ */
@@ -0,0 +1,203 @@
+/*
+ * sigmf.c
+ *
+ *  Minimal SigMF metadata reader.
+ */
+
+#include "sigmf.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIGMF_META_MAX_BYTES (1u << 20) /* Largest metadata file accepted */
+
+/* *****************************************************************************
+ *
+ *                         FILE NAME HELPERS
+ *
+ * *****************************************************************************/
+
+/**
+ * Check whether a string ends with the given suffix
+ */
+static int ends_with(const char* s, const char* suffix) {
+  size_t ls = strlen(s);
+  size_t lx = strlen(suffix);
+  return ls >= lx && strcmp(s + ls - lx, suffix) == 0;
+}
+
+/**
+ * Check whether a file can be opened for reading
+ */
+static int file_exists(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return 0;
+  fclose(f);
+  return 1;
+}
+
+int sigmf_resolve(const char* path, char* meta_path, char* data_path,
+                  size_t cap) {
+  size_t base_len = strlen(path);
+
+  if (ends_with(path, SIGMF_META_EXT)) {
+    base_len -= strlen(SIGMF_META_EXT);
+  } else if (ends_with(path, SIGMF_DATA_EXT)) {
+    base_len -= strlen(SIGMF_DATA_EXT);
+  } else {
+    /* Bare recording name: only if the metadata file is there */
+    if (base_len + strlen(SIGMF_META_EXT) + 1 > cap) return 0;
+    snprintf(meta_path, cap, "%s%s", path, SIGMF_META_EXT);
+    if (!file_exists(meta_path)) return 0;
+  }
+
+  if (base_len + strlen(SIGMF_META_EXT) + 1 > cap) return 0;
+  snprintf(meta_path, cap, "%.*s%s", (int)base_len, path, SIGMF_META_EXT);
+  snprintf(data_path, cap, "%.*s%s", (int)base_len, path, SIGMF_DATA_EXT);
+  return 1;
+}
+
+/* *****************************************************************************
+ *
+ *                         JSON SCANNING
+ *
+ * *****************************************************************************/
+
+/**
+ * Skip a JSON string starting at the opening quote
+ * @return Pointer just past the closing quote (or end of text)
+ */
+static const char* skip_string(const char* p, const char* end) {
+  p++;
+  while (p < end && *p != '"') {
+    if (*p == '\\' && p + 1 < end) p++;
+    p++;
+  }
+  return p < end ? p + 1 : end;
+}
+
+/**
+ * Find the body of the top-level "global" object
+ *
+ * @param text  Metadata text
+ * @param len   Text length
+ * @param body  Output: first character after '{'
+ * @param bend  Output: the matching '}'
+ * @return 0 on success, -1 if not found
+ */
+static int find_global(const char* text, size_t len, const char** body,
+                       const char** bend) {
+  const char* end = text + len;
+  const char* p = strstr(text, "\"global\"");
+  if (!p) return -1;
+  p += 8;
+  while (p < end && *p != '{') p++;
+  if (p >= end) return -1;
+
+  *body = p + 1;
+  int depth = 0;
+  while (p < end) {
+    if (*p == '"') {
+      p = skip_string(p, end);
+      continue;
+    }
+    if (*p == '{') depth++;
+    if (*p == '}' && --depth == 0) {
+      *bend = p;
+      return 0;
+    }
+    p++;
+  }
+  return -1;
+}
+
+/**
+ * Locate the value of a key inside an object body
+ *
+ * Matches keys that end with the given name, so ":symbol_rate" finds the
+ * field in any namespace.
+ *
+ * @return Pointer to the first character of the value, NULL if absent
+ */
+static const char* find_value(const char* p, const char* end,
+                              const char* key_suffix) {
+  size_t lk = strlen(key_suffix);
+  while (p < end) {
+    if (*p != '"') {
+      p++;
+      continue;
+    }
+    const char* key = p + 1;
+    const char* after = skip_string(p, end);
+    size_t klen = (size_t)(after - 1 - key);
+    p = after;
+
+    while (p < end && isspace((unsigned char)*p)) p++;
+    if (p >= end || *p != ':') continue; /* a string value, not a key */
+    p++;
+    while (p < end && isspace((unsigned char)*p)) p++;
+
+    if (klen >= lk && memcmp(key + klen - lk, key_suffix, lk) == 0) {
+      return p;
+    }
+  }
+  return NULL;
+}
+
+/* *****************************************************************************
+ *
+ *                         PUBLIC API
+ *
+ * *****************************************************************************/
+
+int sigmf_read_meta(const char* meta_path, SigmfMeta* meta) {
+  memset(meta, 0, sizeof(*meta));
+
+  FILE* f = fopen(meta_path, "rb");
+  if (!f) return -1;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (size <= 0 || (unsigned long)size > SIGMF_META_MAX_BYTES) {
+    fclose(f);
+    return -1;
+  }
+
+  char* text = (char*)malloc((size_t)size + 1);
+  if (!text) {
+    fclose(f);
+    return -1;
+  }
+  size_t got = fread(text, 1, (size_t)size, f);
+  fclose(f);
+  text[got] = '\0';
+
+  const char* body;
+  const char* bend;
+  if (find_global(text, got, &body, &bend) != 0) {
+    free(text);
+    return -1;
+  }
+
+  const char* v = find_value(body, bend, "core:datatype");
+  if (v && *v == '"') {
+    const char* s = v + 1;
+    size_t n = 0;
+    while (s + n < bend && s[n] != '"' && n + 1 < sizeof(meta->datatype)) {
+      meta->datatype[n] = s[n];
+      n++;
+    }
+    meta->datatype[n] = '\0';
+  }
+
+  v = find_value(body, bend, "core:sample_rate");
+  if (v) meta->sample_rate = strtod(v, NULL);
+
+  v = find_value(body, bend, ":symbol_rate");
+  if (v) meta->symbol_rate = strtod(v, NULL);
+
+  free(text);
+  return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * sigmf.h
+ *
+ *  Minimal SigMF metadata reader.
+ *
+ *  Reads the global fields the demodulator needs from a .sigmf-meta file:
+ *  the sample datatype, the sample rate and an optional symbol rate. Only
+ *  the "global" object is inspected; captures and annotations are ignored.
+ */
+
+#ifndef SIGMF_H_
+#define SIGMF_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* =============================================================================
+ * SIGMF METADATA
+ * =============================================================================
+ */
+#define SIGMF_META_EXT ".sigmf-meta"
+#define SIGMF_DATA_EXT ".sigmf-data"
+
+typedef struct {
+  char datatype[32];  /* core:datatype, e.g. "ci16_le" ("" if absent) */
+  double sample_rate; /* core:sample_rate in Hz (0 if absent)         */
+  double symbol_rate; /* "<ns>:symbol_rate" in baud (0 if absent)     */
+} SigmfMeta;
+
+/**
+ * Resolve the metadata and data file names of a SigMF recording
+ *
+ * Accepts the .sigmf-meta file, the .sigmf-data file or the recording base
+ * name (when "<path>.sigmf-meta" exists).
+ *
+ * @param path       Path given by the user
+ * @param meta_path  Output: metadata file path
+ * @param data_path  Output: data file path
+ * @param cap        Capacity of both output buffers
+ * @return 1 if path names a SigMF recording, 0 otherwise
+ */
+int sigmf_resolve(const char* path, char* meta_path, char* data_path,
+                  size_t cap);
+
+/**
+ * Read the global fields of a SigMF metadata file
+ *
+ * @param meta_path  Metadata file path
+ * @param meta       Output: parsed fields
+ * @return 0 on success, -1 on error
+ */
+int sigmf_read_meta(const char* meta_path, SigmfMeta* meta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIGMF_H_ */